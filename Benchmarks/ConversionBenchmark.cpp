@@ -0,0 +1,274 @@
+// standalone benchmark of the conversion kernels, built against the stub XSI headers
+// so it runs without Softimage (see SConscript). it times the input (ICE -> KL) and
+// the output (KL -> ICE) directions for 10k, 100k and 1M elements, and checks that
+// both directions give back the original values. the Lines output (KL segments ->
+// NurbsCurveList arrays) is timed for 10k, 100k and 1M curves.
+//
+// the port conversions themselves (convertInputPolygonMesh, convertOutputPolygonMesh,
+// convertInputLines, convertOutputLines, convertInputICEAttribute, _polymesh) are not
+// part of this benchmark: they go through the Softimage geometry and Fabric RTVals,
+// use the 'fabricSplice benchmarkConversion' command in Softimage to time them.
+//
+// usage: FabricSoftimageConversionBenchmark [iterations]
+
+#include "FabricSpliceConversionKernels.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#ifdef _WIN32
+  #include <windows.h>
+#else
+  #include <time.h>
+#endif
+
+using namespace XSI;
+
+static double getTimeMs()
+{
+#ifdef _WIN32
+  LARGE_INTEGER frequency, counter;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  return double(counter.QuadPart) * 1000.0 / double(frequency.QuadPart);
+#else
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return double(ts.tv_sec) * 1000.0 + double(ts.tv_nsec) * 1.0e-6;
+#endif
+}
+
+// same figures as the 'fabricSplice benchmarkConversion' command.
+static void logResult(const char * name, size_t samples, double totalMs, int iterations, size_t bytes)
+{
+  double avgMs = iterations > 0 ? totalMs / double(iterations) : 0.0;
+  double mbPerSec = avgMs > 0.0 ? (double(bytes) / (1024.0 * 1024.0)) / (avgMs * 0.001) : 0.0;
+  double samplesPerSec = avgMs > 0.0 ? double(samples) / (avgMs * 0.001) : 0.0;
+  printf("%-32s %8lu: average %9.3f ms over %d iterations, %8.1f MB/s, %12.0f samples/s\n",
+    name, (unsigned long)samples, avgMs, iterations, mbPerSec, samplesPerSec);
+}
+
+static bool benchmarkQuaternions(size_t count, int iterations)
+{
+  std::vector<MATH::CQuaternionf> ice(count), iceBack(count);
+  std::vector<float> kl(count * 4);
+  for(size_t i=0;i<count;i++)
+    ice[i].Set(float(i), float(i) + 0.25f, float(i) + 0.5f, float(i) + 0.75f);
+  size_t bytes = count * sizeof(float) * 4;
+
+  double start = getTimeMs();
+  for(int j=0;j<iterations;j++)
+    convertICEQuaternionsToKLLoop(&ice[0], &kl[0], count);
+  logResult("ICE Quat -> KL (accessor loop)", count, getTimeMs() - start, iterations, bytes);
+
+  start = getTimeMs();
+  for(int j=0;j<iterations;j++)
+    convertICEQuaternionsToKL(&ice[0], &kl[0], count);
+  logResult("ICE Quat -> KL", count, getTimeMs() - start, iterations, bytes);
+
+  start = getTimeMs();
+  for(int j=0;j<iterations;j++)
+    convertKLQuaternionsToICE(&kl[0], &iceBack[0], count);
+  logResult("KL Quat -> ICE", count, getTimeMs() - start, iterations, bytes);
+
+  for(size_t i=0;i<count;i++)
+  {
+    if(kl[i*4+0] != ice[i].GetX() || kl[i*4+3] != ice[i].GetW() ||
+       iceBack[i].GetW() != ice[i].GetW() || iceBack[i].GetX() != ice[i].GetX() ||
+       iceBack[i].GetY() != ice[i].GetY() || iceBack[i].GetZ() != ice[i].GetZ())
+    {
+      printf("error: quaternion %lu doesn't match after the conversion.\n", (unsigned long)i);
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool benchmarkMatrices(size_t count, int iterations)
+{
+  std::vector<MATH::CMatrix4f> ice(count), iceBack(count);
+  std::vector<float> kl(count * 16);
+  for(size_t i=0;i<count;i++)
+    for(short r=0;r<4;r++)
+      for(short c=0;c<4;c++)
+        ice[i].SetValue(r, c, float(i) + float(r * 4 + c) * 0.0625f);
+  size_t bytes = count * sizeof(float) * 16;
+
+  double start = getTimeMs();
+  for(int j=0;j<iterations;j++)
+    convertICEMatricesToKLLoop(&ice[0], &kl[0], count);
+  logResult("ICE Mat44 -> KL (accessor loop)", count, getTimeMs() - start, iterations, bytes);
+
+  start = getTimeMs();
+  for(int j=0;j<iterations;j++)
+    convertICEMatricesToKL(&ice[0], &kl[0], count);
+  logResult("ICE Mat44 -> KL", count, getTimeMs() - start, iterations, bytes);
+
+  start = getTimeMs();
+  for(int j=0;j<iterations;j++)
+    convertKLMatricesToICE(&kl[0], &iceBack[0], count);
+  logResult("KL Mat44 -> ICE", count, getTimeMs() - start, iterations, bytes);
+
+  for(size_t i=0;i<count;i++)
+  {
+    for(short r=0;r<4;r++)
+    {
+      for(short c=0;c<4;c++)
+      {
+        if(kl[i*16+c*4+r] != ice[i].GetValue(r, c) || iceBack[i].GetValue(r, c) != ice[i].GetValue(r, c))
+        {
+          printf("error: matrix %lu doesn't match after the conversion.\n", (unsigned long)i);
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+static bool benchmarkMatrices33(size_t count, int iterations)
+{
+  std::vector<MATH::CMatrix3f> ice(count), iceBack(count);
+  std::vector<float> kl(count * 9);
+  for(size_t i=0;i<count;i++)
+    for(short r=0;r<3;r++)
+      for(short c=0;c<3;c++)
+        ice[i].SetValue(r, c, float(i) + float(r * 3 + c) * 0.125f);
+  size_t bytes = count * sizeof(float) * 9;
+
+  double start = getTimeMs();
+  for(int j=0;j<iterations;j++)
+    convertICEMatrices33ToKL(&ice[0], &kl[0], count);
+  logResult("ICE Mat33 -> KL", count, getTimeMs() - start, iterations, bytes);
+
+  start = getTimeMs();
+  for(int j=0;j<iterations;j++)
+    convertKLMatrices33ToICE(&kl[0], &iceBack[0], count);
+  logResult("KL Mat33 -> ICE", count, getTimeMs() - start, iterations, bytes);
+
+  for(size_t i=0;i<count;i++)
+  {
+    for(short r=0;r<3;r++)
+    {
+      for(short c=0;c<3;c++)
+      {
+        if(kl[i*9+c*3+r] != ice[i].GetValue(r, c) || iceBack[i].GetValue(r, c) != ice[i].GetValue(r, c))
+        {
+          printf("error: 3x3 matrix %lu doesn't match after the conversion.\n", (unsigned long)i);
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+static bool benchmarkPoints(size_t count, int iterations)
+{
+  std::vector<double> xsiPoints(count * 3), xsiPointsBack(count * 3);
+  std::vector<float> klPoints(count * 3);
+  for(size_t i=0;i<xsiPoints.size();i++)
+    xsiPoints[i] = double(i % 4096) * 0.5;
+
+  double start = getTimeMs();
+  for(int j=0;j<iterations;j++)
+    convertDoublesToFloats(&xsiPoints[0], xsiPoints.size(), &klPoints[0]);
+  logResult("points Float64 -> Float32", count, getTimeMs() - start, iterations, xsiPoints.size() * sizeof(double));
+
+  start = getTimeMs();
+  for(int j=0;j<iterations;j++)
+    convertFloatsToDoubles(&klPoints[0], klPoints.size(), &xsiPointsBack[0]);
+  logResult("points Float32 -> Float64", count, getTimeMs() - start, iterations, klPoints.size() * sizeof(float));
+
+  start = getTimeMs();
+  unsigned long long h = 0;
+  for(int j=0;j<iterations;j++)
+    h += hashBytes(&klPoints[0], klPoints.size() * sizeof(float), count);
+  logResult("points hash", count, getTimeMs() - start, iterations, klPoints.size() * sizeof(float));
+
+  if(memcmp(&xsiPoints[0], &xsiPointsBack[0], sizeof(double) * xsiPoints.size()) != 0)
+  {
+    printf("error: the points don't match after the conversion.\n");
+    return false;
+  }
+  return h != 0 || count == 0;
+}
+
+// curves of 4 points (3 segments), every other one closed (4 segments, no repeated point).
+static bool benchmarkCurves(size_t count, int iterations)
+{
+  std::vector<double> points(count * 4 * 3);
+  std::vector<uint32_t> indices;
+  indices.reserve(count * 8);
+  for(size_t i=0;i<points.size();i++)
+    points[i] = double(i % 4096) * 0.5;
+  for(size_t i=0;i<count;i++)
+  {
+    uint32_t first = uint32_t(i * 4);
+    for(uint32_t j=0;j<3;j++)
+    {
+      indices.push_back(first + j);
+      indices.push_back(first + j + 1);
+    }
+    if(i % 2 == 1)
+    {
+      indices.push_back(first + 3);
+      indices.push_back(first);
+    }
+  }
+  size_t nbSegments = indices.size() / 2;
+
+  std::vector<uint32_t> curveVertices(nbSegments * 2);
+  std::vector<uint32_t> curveCounts(nbSegments);
+  std::vector<uint8_t> curveClosed(nbSegments);
+  std::vector<double> controlPoints(count * 4 * 4);
+  std::vector<double> knots(count * 5);
+  size_t nbCurves = 0;
+  size_t nbKnots = 0;
+
+  double start = getTimeMs();
+  for(int j=0;j<iterations;j++)
+  {
+    nbCurves = convertSegmentsToCurves(&indices[0], nbSegments, &curveVertices[0], &curveCounts[0], &curveClosed[0]);
+    nbKnots = convertCurvesToNurbs(&points[0], &curveVertices[0], &curveCounts[0], &curveClosed[0], nbCurves, &controlPoints[0], &knots[0]);
+  }
+  logResult("Lines -> NurbsCurveList", count, getTimeMs() - start, iterations, indices.size() * sizeof(uint32_t) + points.size() * sizeof(double));
+
+  if(nbCurves != count || nbKnots != count * 4 + count / 2)
+  {
+    printf("error: %lu curves and %lu knots instead of %lu curves.\n", (unsigned long)nbCurves, (unsigned long)nbKnots, (unsigned long)count);
+    return false;
+  }
+  for(size_t i=0;i<count;i++)
+  {
+    if(curveCounts[i] != 4 || (curveClosed[i] != 0) != (i % 2 == 1) ||
+       memcmp(&controlPoints[i*16+8], &points[i*12+6], sizeof(double) * 3) != 0 || controlPoints[i*16+11] != 1.0)
+    {
+      printf("error: curve %lu doesn't match after the conversion.\n", (unsigned long)i);
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char ** argv)
+{
+  int iterations = argc > 1 ? atoi(argv[1]) : 10;
+  if(iterations < 1)
+    iterations = 1;
+
+  const size_t counts[] = { 10000, 100000, 1000000 };
+  bool succeeded = true;
+  for(size_t i=0;i<sizeof(counts)/sizeof(counts[0]);i++)
+  {
+    printf("--- %lu elements\n", (unsigned long)counts[i]);
+    succeeded = benchmarkQuaternions(counts[i], iterations) && succeeded;
+    succeeded = benchmarkMatrices(counts[i], iterations) && succeeded;
+    succeeded = benchmarkMatrices33(counts[i], iterations) && succeeded;
+    succeeded = benchmarkPoints(counts[i], iterations) && succeeded;
+    succeeded = benchmarkCurves(counts[i], iterations) && succeeded;
+  }
+  return succeeded ? 0 : 1;
+}
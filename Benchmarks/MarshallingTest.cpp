@@ -0,0 +1,290 @@
+// standalone test of the Canvas argument marshalling (FabricDFGMarshalling.h), run against
+// the in-memory backend of MockCoreBackend.h so it needs neither Softimage nor Fabric (see
+// SConscript). for each type it checks that the values come back unchanged, that a get or a
+// set does the expected amount of Core calls and value constructions and that it doesn't
+// allocate memory (beyond the output vector's first use), then times the get and the set.
+// returns 0 if all the checks passed.
+//
+// usage: FabricSoftimageMarshallingTest [iterations]
+
+#include "FabricDFGMarshalling.h"
+#include "MockCoreBackend.h"
+
+#include <math.h>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+  #include <windows.h>
+#else
+  #include <time.h>
+#endif
+
+// heap allocations counter.
+static size_t s_numAllocations = 0;
+
+void *operator new(size_t size)
+{
+  s_numAllocations++;
+  void *p = malloc(size ? size : 1);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+void *operator new[](size_t size)
+{
+  s_numAllocations++;
+  void *p = malloc(size ? size : 1);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+void operator delete  (void *p) throw()  {  free(p);  }
+void operator delete[](void *p) throw()  {  free(p);  }
+#if __cplusplus >= 201402L
+void operator delete  (void *p, size_t) throw()  {  free(p);  }
+void operator delete[](void *p, size_t) throw()  {  free(p);  }
+#endif
+
+static double getTimeMs()
+{
+#ifdef _WIN32
+  LARGE_INTEGER frequency, counter;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  return double(counter.QuadPart) * 1000.0 / double(frequency.QuadPart);
+#else
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return double(ts.tv_sec) * 1000.0 + double(ts.tv_nsec) * 1.0e-6;
+#endif
+}
+
+static int s_numErrors = 0;
+
+static void check(bool condition, const char *type, const char *what)
+{
+  if (!condition)
+  {
+    printf("error: %s: %s\n", type, what);
+    s_numErrors++;
+  }
+}
+
+static void checkCounters(MockCoreBackend &backend, const char *type, size_t haveArg, size_t getArgType, size_t getArg, size_t setArg, size_t constructed)
+{
+  const MockCoreBackend::Counters &c = backend.getCounters();
+  check(c.haveArg     == haveArg,     type, "unexpected amount of haveArg() calls");
+  check(c.getArgType  == getArgType,  type, "unexpected amount of getArgType() calls");
+  check(c.getArg      == getArg,      type, "unexpected amount of getArg() calls");
+  check(c.setArg      == setArg,      type, "unexpected amount of setArg() calls");
+  check(c.constructed == constructed, type, "unexpected amount of constructed values");
+}
+
+static bool nearlyEqual(const std::vector <double> &a, const std::vector <double> &b, double tolerance)
+{
+  if (a.size() != b.size())
+    return false;
+  for (size_t i=0;i<a.size();i++)
+    if (fabs(a[i] - b[i]) > tolerance)
+      return false;
+  return true;
+}
+
+// sets and gets a vector type through SETFUNC and GETFUNC.
+// constructed is the amount of values constructed by a set.
+typedef int (*SetVectorFunc)(MockCoreBackend &, char const *, const std::vector <double> &);
+typedef int (*GetVectorFunc)(MockCoreBackend &, char const *, std::vector <double> &, bool);
+
+static void testVector(MockCoreBackend &backend, const char *type, SetVectorFunc setFunc, GetVectorFunc getFunc, const std::vector <double> &val, size_t constructed, double tolerance, int iterations)
+{
+  std::vector <double> out;
+
+  // set.
+  backend.releaseValues();
+  backend.resetCounters();
+  size_t allocs = s_numAllocations;
+  check(setFunc(backend, type, val) == 0, type, "set failed");
+  check(s_numAllocations == allocs, type, "set allocated memory");
+  checkCounters(backend, type, 1, 0, 0, 1, constructed);
+
+  // get into a new vector (one allocation) and into the same one again (none).
+  backend.resetCounters();
+  allocs = s_numAllocations;
+  check(getFunc(backend, type, out, true) == 0, type, "get failed");
+  check(s_numAllocations - allocs <= 1, type, "get into a new vector allocated more than once");
+  allocs = s_numAllocations;
+  check(getFunc(backend, type, out, true) == 0, type, "get failed");
+  check(s_numAllocations == allocs, type, "get into a used vector allocated memory");
+  checkCounters(backend, type, 2, 2, 2, 0, 0);
+  check(nearlyEqual(out, val, tolerance), type, "value doesn't match after the round trip");
+
+  // timings.
+  double start = getTimeMs();
+  for (int j=0;j<iterations;j++)
+  {
+    backend.releaseValues();
+    setFunc(backend, type, val);
+  }
+  double setMs = getTimeMs() - start;
+  start = getTimeMs();
+  for (int j=0;j<iterations;j++)
+    getFunc(backend, type, out, true);
+  double getMs = getTimeMs() - start;
+  printf("%-8s set %8.1f ns, get %8.1f ns\n", type, setMs * 1.0e6 / iterations, getMs * 1.0e6 / iterations);
+}
+
+// instantiations of the marshalling functions for the mock backend.
+static int setVec2 (MockCoreBackend &b, char const *n, const std::vector <double> &v)  {  return dfgMarshalling::SetValueOfArgVec2 (b, n, v);  }
+static int setVec3 (MockCoreBackend &b, char const *n, const std::vector <double> &v)  {  return dfgMarshalling::SetValueOfArgVec3 (b, n, v);  }
+static int setVec4 (MockCoreBackend &b, char const *n, const std::vector <double> &v)  {  return dfgMarshalling::SetValueOfArgVec4 (b, n, v);  }
+static int setColor(MockCoreBackend &b, char const *n, const std::vector <double> &v)  {  return dfgMarshalling::SetValueOfArgColor(b, n, v);  }
+static int setRGB  (MockCoreBackend &b, char const *n, const std::vector <double> &v)  {  return dfgMarshalling::SetValueOfArgRGB  (b, n, v);  }
+static int setRGBA (MockCoreBackend &b, char const *n, const std::vector <double> &v)  {  return dfgMarshalling::SetValueOfArgRGBA (b, n, v);  }
+static int setQuat (MockCoreBackend &b, char const *n, const std::vector <double> &v)  {  return dfgMarshalling::SetValueOfArgQuat (b, n, v);  }
+static int setMat44(MockCoreBackend &b, char const *n, const std::vector <double> &v)  {  return dfgMarshalling::SetValueOfArgMat44(b, n, v);  }
+static int setXfo  (MockCoreBackend &b, char const *n, const std::vector <double> &v)  {  return dfgMarshalling::SetValueOfArgXfo  (b, n, v);  }
+static int getVec2 (MockCoreBackend &b, char const *n, std::vector <double> &v, bool s)  {  return dfgMarshalling::GetArgValueVec2 (b, n, v, s);  }
+static int getVec3 (MockCoreBackend &b, char const *n, std::vector <double> &v, bool s)  {  return dfgMarshalling::GetArgValueVec3 (b, n, v, s);  }
+static int getVec4 (MockCoreBackend &b, char const *n, std::vector <double> &v, bool s)  {  return dfgMarshalling::GetArgValueVec4 (b, n, v, s);  }
+static int getColor(MockCoreBackend &b, char const *n, std::vector <double> &v, bool s)  {  return dfgMarshalling::GetArgValueColor(b, n, v, s);  }
+static int getRGB  (MockCoreBackend &b, char const *n, std::vector <double> &v, bool s)  {  return dfgMarshalling::GetArgValueRGB  (b, n, v, s);  }
+static int getRGBA (MockCoreBackend &b, char const *n, std::vector <double> &v, bool s)  {  return dfgMarshalling::GetArgValueRGBA (b, n, v, s);  }
+static int getQuat (MockCoreBackend &b, char const *n, std::vector <double> &v, bool s)  {  return dfgMarshalling::GetArgValueQuat (b, n, v, s);  }
+static int getMat44(MockCoreBackend &b, char const *n, std::vector <double> &v, bool s)  {  return dfgMarshalling::GetArgValueMat44(b, n, v, s);  }
+
+static std::vector <double> makeVector(int size, double first, double step)
+{
+  std::vector <double> v(size);
+  for (int i=0;i<size;i++)
+    v[i] = first + i * step;
+  return v;
+}
+
+static void testScalars(MockCoreBackend &backend, int iterations)
+{
+  // the arguments are named like their type.
+  const char *types[] = { "Boolean", "Integer", "SInt8", "SInt16", "SInt64", "Byte", "UInt16", "Count", "DataSize", "Scalar", "Float64", "String" };
+  for (size_t t=0;t<sizeof(types)/sizeof(types[0]);t++)
+  {
+    const char *type = types[t];
+    const bool isBoolean  = !strcmp(type, "Boolean");
+    const bool isSigned   = !strcmp(type, "Integer") || !strncmp(type, "SInt", 4);
+    const bool isUnsigned = !strcmp(type, "Byte") || !strcmp(type, "Count") || !strncmp(type, "UInt", 4) || !strcmp(type, "DataSize");
+    const bool isFloat    = !strcmp(type, "Scalar") || !strcmp(type, "Float64");
+
+    // set.
+    backend.releaseValues();
+    backend.resetCounters();
+    size_t allocs = s_numAllocations;
+    int err = 0;
+    if      (isBoolean)   err = dfgMarshalling::SetValueOfArgBoolean(backend, type, true);
+    else if (isSigned)    err = dfgMarshalling::SetValueOfArgSInt   (backend, type, -7);
+    else if (isUnsigned)  err = dfgMarshalling::SetValueOfArgUInt   (backend, type, 7);
+    else if (isFloat)     err = dfgMarshalling::SetValueOfArgFloat  (backend, type, 0.5);
+    else                  err = dfgMarshalling::SetValueOfArgString (backend, type, std::string("short"));
+    check(err == 0, type, "set failed");
+    check(s_numAllocations == allocs, type, "set allocated memory");
+    checkCounters(backend, type, 1, (isBoolean || !(isSigned || isUnsigned || isFloat)) ? 0 : 1, 0, 1, 1);
+
+    // get (strict), then as a string (not strict).
+    backend.resetCounters();
+    allocs = s_numAllocations;
+    bool b;  int i;  double f;  std::string s;
+    if      (isBoolean)   check(dfgMarshalling::GetArgValueBoolean(backend, type, b, true) == 0 && b,        type, "value doesn't match after the round trip");
+    else if (isSigned)    check(dfgMarshalling::GetArgValueInteger(backend, type, i, true) == 0 && i == -7,  type, "value doesn't match after the round trip");
+    else if (isUnsigned)  check(dfgMarshalling::GetArgValueInteger(backend, type, i, true) == 0 && i ==  7,  type, "value doesn't match after the round trip");
+    else if (isFloat)     check(dfgMarshalling::GetArgValueFloat  (backend, type, f, true) == 0 && f == 0.5, type, "value doesn't match after the round trip");
+    else                  check(dfgMarshalling::GetArgValueString (backend, type, s, true) == 0 && s == "short", type, "value doesn't match after the round trip");
+    check(s_numAllocations == allocs, type, "get allocated memory");
+    checkCounters(backend, type, 1, 1, 1, 0, 0);
+    check(dfgMarshalling::GetArgValueString(backend, type, s, false) == 0 && s.length() > 0, type, "get as string failed");
+
+    // the other getters convert if not strict.
+    if (isSigned || isUnsigned || isFloat)
+    {
+      check(dfgMarshalling::GetArgValueFloat  (backend, type, f, false) == 0 && f != 0, type, "get as Float failed");
+      check(dfgMarshalling::GetArgValueBoolean(backend, type, b, false) == 0 && b,      type, "get as Boolean failed");
+    }
+
+    // timings.
+    double start = getTimeMs();
+    for (int j=0;j<iterations;j++)
+    {
+      backend.releaseValues();
+      if      (isBoolean)   dfgMarshalling::SetValueOfArgBoolean(backend, type, true);
+      else if (isSigned)    dfgMarshalling::SetValueOfArgSInt   (backend, type, -7);
+      else if (isUnsigned)  dfgMarshalling::SetValueOfArgUInt   (backend, type, 7);
+      else if (isFloat)     dfgMarshalling::SetValueOfArgFloat  (backend, type, 0.5);
+    }
+    double setMs = getTimeMs() - start;
+    start = getTimeMs();
+    for (int j=0;j<iterations;j++)
+    {
+      if      (isBoolean)   dfgMarshalling::GetArgValueBoolean(backend, type, b, true);
+      else if (isSigned)    dfgMarshalling::GetArgValueInteger(backend, type, i, true);
+      else if (isUnsigned)  dfgMarshalling::GetArgValueInteger(backend, type, i, true);
+      else if (isFloat)     dfgMarshalling::GetArgValueFloat  (backend, type, f, true);
+    }
+    double getMs = getTimeMs() - start;
+    if (isBoolean || isSigned || isUnsigned || isFloat)
+      printf("%-8s set %8.1f ns, get %8.1f ns\n", type, setMs * 1.0e6 / iterations, getMs * 1.0e6 / iterations);
+  }
+}
+
+static void testErrors(MockCoreBackend &backend)
+{
+  // invalid port, unresolved port, type mismatch in strict mode.
+  double f;
+  std::vector <double> v;
+  check(dfgMarshalling::GetArgValueFloat(backend, "missing",    f, false) == -2, "missing",    "get didn't fail with -2");
+  check(dfgMarshalling::SetValueOfArgVec3(backend, "missing",   v)        == -2, "missing",    "set didn't fail with -2");
+  check(dfgMarshalling::GetArgValueFloat(backend, "unresolved", f, false) == -1, "unresolved", "get didn't fail with -1");
+  check(dfgMarshalling::GetArgValueVec2 (backend, "Mat44",      v, false) == -1, "Mat44",      "get as Vec2 didn't fail with -1");
+
+  // not strict: a Color read as a Vec3.
+  check(dfgMarshalling::GetArgValueVec3(backend, "Color", v, false) == 0 && v.size() == 3, "Color", "get as Vec3 failed");
+}
+
+int main(int argc, char ** argv)
+{
+  int iterations = argc > 1 ? atoi(argv[1]) : 1000000;
+  if (iterations < 1)
+    iterations = 1;
+
+  MockCoreBackend backend;
+  const char *types[] = { "Boolean", "Integer", "SInt8", "SInt16", "SInt64", "Byte", "UInt16", "Count", "DataSize", "Scalar", "Float64", "String",
+                          "Vec2", "Vec3", "Vec4", "Color", "RGB", "RGBA", "Quat", "Mat44", "Xfo" };
+  for (size_t i=0;i<sizeof(types)/sizeof(types[0]);i++)
+    backend.addArg(types[i], types[i]);
+  backend.addArg("unresolved", "");
+
+  try
+  {
+    testScalars(backend, iterations);
+    testVector(backend, "Vec2",  setVec2,  getVec2,  makeVector( 2, 1.0,   0.25),  3, 0,      iterations);
+    testVector(backend, "Vec3",  setVec3,  getVec3,  makeVector( 3, 1.0,   0.25),  4, 0,      iterations);
+    testVector(backend, "Vec4",  setVec4,  getVec4,  makeVector( 4, 1.0,   0.25),  5, 0,      iterations);
+    testVector(backend, "Color", setColor, getColor, makeVector( 4, 0.125, 0.25),  5, 0,      iterations);
+    testVector(backend, "RGB",   setRGB,   getRGB,   makeVector( 3, 0.0,   0.5),   4, 1.0 / 255.0, iterations);
+    testVector(backend, "RGBA",  setRGBA,  getRGBA,  makeVector( 4, 0.0,   0.25),  5, 1.0 / 255.0, iterations);
+    testVector(backend, "Quat",  setQuat,  getQuat,  makeVector( 4, 0.0,   0.5),   6, 0,      iterations);
+    testVector(backend, "Mat44", setMat44, getMat44, makeVector(16, 0.0,   0.5),  21, 0,      iterations);
+    testVector(backend, "Xfo",   setXfo,   getMat44, makeVector(10, 1.0,   0.5),  15, 0,      iterations);
+    testErrors(backend);
+  }
+  catch (MockException e)
+  {
+    printf("error: exception \"%s\"\n", e.desc.c_str());
+    s_numErrors++;
+  }
+
+  if (s_numErrors)
+  {
+    printf("%d error(s).\n", s_numErrors);
+    return 1;
+  }
+  printf("all checks passed.\n");
+  return 0;
+}
@@ -0,0 +1,258 @@
+#ifndef _MockCoreBackend_H_
+#define _MockCoreBackend_H_
+
+// in-memory stand-in for the Fabric Core, used as the backend of the dfgMarshalling
+// functions (see FabricDFGMarshalling.h) by the marshalling test.
+// values are nodes of a fixed size pool, so that constructing and reading values never
+// allocates memory: the heap allocations counted by the test are the marshalling's own.
+// the backend counts the calls that would be Core calls with the actual backend.
+
+#include <deque>
+#include <string>
+#include <vector>
+#include <string.h>
+#include <stdint.h>
+
+// thrown like a FabricCore::Exception (e.g. when reading a value with the getter of another type).
+struct MockException
+{
+  std::string desc;
+  MockException(const std::string &in_desc) : desc(in_desc) {}
+};
+
+// the members of the KL structs used by the marshalling.
+static const char * const *mockMemberNames(const char *type, int &numMembers)
+{
+  static const char * const xy  [] = { "x", "y" };
+  static const char * const xyz [] = { "x", "y", "z" };
+  static const char * const xyzt[] = { "x", "y", "z", "t" };
+  static const char * const rgb [] = { "r", "g", "b" };
+  static const char * const rgba[] = { "r", "g", "b", "a" };
+  static const char * const quat[] = { "v", "w" };
+  static const char * const mat [] = { "row0", "row1", "row2", "row3" };
+  static const char * const xfo [] = { "ori", "tr", "sc" };
+  if (!strcmp(type, "Vec2"))   { numMembers = 2; return xy;   }
+  if (!strcmp(type, "Vec3"))   { numMembers = 3; return xyz;  }
+  if (!strcmp(type, "Vec4"))   { numMembers = 4; return xyzt; }
+  if (!strcmp(type, "Color"))  { numMembers = 4; return rgba; }
+  if (!strcmp(type, "RGB"))    { numMembers = 3; return rgb;  }
+  if (!strcmp(type, "RGBA"))   { numMembers = 4; return rgba; }
+  if (!strcmp(type, "Quat"))   { numMembers = 2; return quat; }
+  if (!strcmp(type, "Mat44"))  { numMembers = 4; return mat;  }
+  if (!strcmp(type, "Xfo"))    { numMembers = 3; return xfo;  }
+  numMembers = 0;
+  return NULL;
+}
+
+struct MockNode
+{
+  const char  *type;        // KL type (a string literal).
+  int64_t      i;           // value of the integer types.
+  double       f;           // value of the floating point types.
+  std::string  s;           // value of a String.
+  int          numMembers;  // amount of members of a struct.
+  MockNode    *members[4];  // members of a struct.
+};
+
+class MockValue
+{
+ public:
+
+  MockValue()                 : m_node(NULL) {}
+  MockValue(MockNode *node)   : m_node(node) {}
+
+  bool        isValid()     const  {  return m_node != NULL;  }
+  MockNode   *getNode()     const  {  return m_node;  }
+
+  bool        getBoolean()  const  {  return 0 != get("Boolean").i;   }
+  int8_t      getSInt8()    const  {  return (int8_t)  get("SInt8")  .i;  }
+  int16_t     getSInt16()   const  {  return (int16_t) get("SInt16") .i;  }
+  int32_t     getSInt32()   const  {  return (int32_t) get("SInt32") .i;  }
+  int64_t     getSInt64()   const  {  return (int64_t) get("SInt64") .i;  }
+  uint8_t     getUInt8()    const  {  return (uint8_t) get("UInt8")  .i;  }
+  uint16_t    getUInt16()   const  {  return (uint16_t)get("UInt16") .i;  }
+  uint32_t    getUInt32()   const  {  return (uint32_t)get("UInt32") .i;  }
+  uint64_t    getUInt64()   const  {  return (uint64_t)get("UInt64") .i;  }
+  float       getFloat32()  const  {  return (float)   get("Float32").f;  }
+  double      getFloat64()  const  {  return           get("Float64").f;  }
+  const char *getStringCString() const  {  return get("String").s.c_str();  }
+
+  MockValue maybeGetMember(const char *name) const
+  {
+    if (!m_node)
+      throw MockException("maybeGetMember() called on an invalid value");
+    int numMembers;
+    const char * const *names = mockMemberNames(m_node->type, numMembers);
+    for (int i=0;i<numMembers && i<m_node->numMembers;i++)
+      if (!strcmp(names[i], name))
+        return MockValue(m_node->members[i]);
+    return MockValue();
+  }
+
+ private:
+
+  // the node, checking that the getter matches the type like the Core does.
+  const MockNode &get(const char *type) const
+  {
+    if (!m_node)
+      throw MockException(std::string("get") + type + "() called on an invalid value");
+    if (strcmp(m_node->type, type))
+      throw MockException(std::string("get") + type + "() called on a " + m_node->type);
+    return *m_node;
+  }
+
+  MockNode *m_node;
+};
+
+class MockCoreBackend
+{
+ public:
+
+  typedef MockValue Value;
+
+  // the amount of calls that would go to the Core.
+  struct Counters
+  {
+    size_t haveArg;
+    size_t getArgType;
+    size_t getArg;
+    size_t setArg;
+    size_t constructed;
+  };
+
+  MockCoreBackend(size_t poolSize = 1024)
+  : m_pool(poolSize), m_used(0), m_lastArg(NULL)
+  {
+    resetCounters();
+  }
+
+  // adds an argument of a given type, its value is invalid until set.
+  void addArg(const char *name, const char *type)
+  {
+    m_args.push_back(Arg());
+    m_args.back().name = name;
+    m_args.back().type = type;
+    m_args.back().numNodes = 0;
+  }
+
+  // drops the values constructed since the last call (the arguments keep their own copy).
+  void releaseValues()  {  m_used = 0;  }
+
+  const Counters &getCounters() const  {  return m_counters;  }
+  void resetCounters()  {  memset(&m_counters, 0, sizeof(m_counters));  }
+
+  // backend functions.
+  bool haveArg(const char *argName)
+  {
+    m_counters.haveArg++;
+    return findArg(argName) != NULL;
+  }
+  std::string getArgType(const char *argName)
+  {
+    m_counters.getArgType++;
+    return findArg(argName, true)->type;
+  }
+  Value getArg(const char *argName)
+  {
+    m_counters.getArg++;
+    Arg *arg = findArg(argName, true);
+    return Value(arg->numNodes ? &arg->nodes[0] : NULL);
+  }
+  void setArg(const char *argName, const Value &val)
+  {
+    m_counters.setArg++;
+    Arg *arg = findArg(argName, true);
+    arg->numNodes = 0;
+    if (val.isValid())
+      copyNode(*arg, val.getNode());
+  }
+
+  Value constructBoolean(bool         val)  {  MockNode *n = newNode("Boolean");  n->i = val ? 1 : 0;  return Value(n);  }
+  Value constructSInt8  (int8_t       val)  {  MockNode *n = newNode("SInt8");    n->i = val;         return Value(n);  }
+  Value constructSInt16 (int16_t      val)  {  MockNode *n = newNode("SInt16");   n->i = val;         return Value(n);  }
+  Value constructSInt32 (int32_t      val)  {  MockNode *n = newNode("SInt32");   n->i = val;         return Value(n);  }
+  Value constructSInt64 (int64_t      val)  {  MockNode *n = newNode("SInt64");   n->i = val;         return Value(n);  }
+  Value constructUInt8  (uint8_t      val)  {  MockNode *n = newNode("UInt8");    n->i = val;         return Value(n);  }
+  Value constructUInt16 (uint16_t     val)  {  MockNode *n = newNode("UInt16");   n->i = val;         return Value(n);  }
+  Value constructUInt32 (uint32_t     val)  {  MockNode *n = newNode("UInt32");   n->i = val;         return Value(n);  }
+  Value constructUInt64 (uint64_t     val)  {  MockNode *n = newNode("UInt64");   n->i = (int64_t)val; return Value(n);  }
+  Value constructFloat32(float        val)  {  MockNode *n = newNode("Float32");  n->f = val;         return Value(n);  }
+  Value constructFloat64(double       val)  {  MockNode *n = newNode("Float64");  n->f = val;         return Value(n);  }
+  Value constructString (const char  *val)  {  MockNode *n = newNode("String");   n->s = val;         return Value(n);  }
+  Value construct(const char *type, int numMembers, Value *members)
+  {
+    int expected;
+    mockMemberNames(type, expected);
+    if (expected == 0 || numMembers != expected)
+      throw MockException(std::string("cannot construct a ") + type);
+    MockNode *n = newNode(type);
+    n->numMembers = numMembers;
+    for (int i=0;i<numMembers;i++)
+    {
+      if (!members[i].isValid())
+        throw MockException(std::string("invalid member in the construction of a ") + type);
+      n->members[i] = members[i].getNode();
+    }
+    return Value(n);
+  }
+
+ private:
+
+  struct Arg
+  {
+    std::string name;
+    std::string type;
+    MockNode    nodes[32];  // the value (nodes[0]) and its members.
+    int         numNodes;
+  };
+
+  // (the last argument found is checked first, a get or a set looks up the same argument several times).
+  Arg *findArg(const char *argName, bool mustExist = false)
+  {
+    if (m_lastArg && m_lastArg->name == argName)
+      return m_lastArg;
+    for (size_t i=0;i<m_args.size();i++)
+      if (m_args[i].name == argName)
+        return (m_lastArg = &m_args[i]);
+    if (mustExist)
+      throw MockException(std::string("no argument \"") + argName + "\"");
+    return NULL;
+  }
+
+  MockNode *newNode(const char *type)
+  {
+    if (m_used >= m_pool.size())
+      throw MockException("value pool exhausted (missing releaseValues()?)");
+    m_counters.constructed++;
+    MockNode *n = &m_pool[m_used++];
+    n->type       = type;
+    n->i          = 0;
+    n->f          = 0;
+    n->numMembers = 0;
+    return n;
+  }
+
+  // deep copies a value into the argument's nodes, returns the copy.
+  MockNode *copyNode(Arg &arg, const MockNode *src)
+  {
+    if (arg.numNodes >= 32)
+      throw MockException("value too large for an argument");
+    MockNode *dst = &arg.nodes[arg.numNodes++];
+    dst->type       = src->type;
+    dst->i          = src->i;
+    dst->f          = src->f;
+    dst->s          = src->s;
+    dst->numMembers = src->numMembers;
+    for (int i=0;i<src->numMembers;i++)
+      dst->members[i] = copyNode(arg, src->members[i]);
+    return dst;
+  }
+
+  std::vector<MockNode> m_pool;
+  size_t                m_used;
+  std::deque<Arg>       m_args;     // (a deque, so that adding arguments doesn't move the others' nodes).
+  Arg                  *m_lastArg;
+  Counters              m_counters;
+};
+
+#endif
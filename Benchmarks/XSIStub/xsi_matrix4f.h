@@ -0,0 +1,27 @@
+#ifndef __XSIStub_xsi_matrix4f_H_
+#define __XSIStub_xsi_matrix4f_H_
+
+// stand-in for the Softimage SDK header, used by the standalone conversion benchmark.
+// only the members used by FabricSpliceConversionKernels.cpp, with the SDK's row major storage.
+namespace XSI { namespace MATH {
+
+class CMatrix4f
+{
+public:
+  CMatrix4f()
+  {
+    for(int r=0;r<4;r++)
+      for(int c=0;c<4;c++)
+        m_mat[r][c] = r == c ? 1.0f : 0.0f;
+  }
+
+  void SetValue(short row, short col, float value) { m_mat[row][col] = value; }
+  float GetValue(short row, short col) const { return m_mat[row][col]; }
+
+private:
+  float m_mat[4][4];
+};
+
+} }
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef __XSIStub_xsi_quaternionf_H_
+#define __XSIStub_xsi_quaternionf_H_
+
+// stand-in for the Softimage SDK header, used by the standalone conversion benchmark.
+// only the members used by FabricSpliceConversionKernels.cpp, with the SDK's (w, x, y, z) storage.
+namespace XSI { namespace MATH {
+
+class CQuaternionf
+{
+public:
+  CQuaternionf() : m_w(1.0f), m_x(0.0f), m_y(0.0f), m_z(0.0f) {}
+  CQuaternionf(float w, float x, float y, float z) : m_w(w), m_x(x), m_y(y), m_z(z) {}
+
+  void Set(float w, float x, float y, float z) { m_w = w; m_x = x; m_y = y; m_z = z; }
+  float GetW() const { return m_w; }
+  float GetX() const { return m_x; }
+  float GetY() const { return m_y; }
+  float GetZ() const { return m_z; }
+
+private:
+  float m_w, m_x, m_y, m_z;
+};
+
+} }
+
+#endif
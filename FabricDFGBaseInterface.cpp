@@ -2,6 +2,7 @@
 #include "FabricDFGBaseInterface.h"
 #include "FabricDFGPlugin.h"
 #include "FabricDFGOperators.h"
+#include "FabricDFGMarshalling.h"
 
 #include "FabricSplicePlugin.h"
 
@@ -12,10 +13,92 @@
 #include <algorithm>
 #include <sstream>
 
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QThread>
+
+
+// thread populating the KL AST manager in the background.
+class KLASTManagerLoader : public QThread
+{
+ public:
+
+  KLASTManagerLoader(FabricServices::ASTWrapper::KLASTManager *manager)
+  : m_manager(manager), m_ms(0)
+  {
+  }
+
+  double             getMs()    const  {  return m_ms;     }
+  const std::string &getError() const  {  return m_error;  }
+
+ protected:
+
+  virtual void run()
+  {
+    QElapsedTimer timer;
+    timer.start();
+    try
+    {
+      m_manager->loadAllExtensionsFromExtsPath();
+    }
+    catch (FabricCore::Exception e)
+    {
+      // note: we cannot log from this thread, so the error is logged by BaseInterface::getManager().
+      m_error = e.getDesc_cstr() ? e.getDesc_cstr() : "\"\"";
+    }
+    m_ms = (double)timer.nsecsElapsed() * 1.0e-6;
+  }
+
+ private:
+
+  FabricServices::ASTWrapper::KLASTManager *m_manager;
+  double                                    m_ms;
+  std::string                               m_error;
+};
+
+// backend of the dfgMarshalling functions going through the Fabric Core.
+// (note: the binding's executable is fetched once, not once per Core call).
+class DFGCoreBackend
+{
+ public:
+
+  typedef FabricCore::RTVal Value;
+
+  DFGCoreBackend(FabricCore::Client &client, FabricCore::DFGBinding &binding)
+  : m_client(client), m_binding(binding), m_exec(binding.getExec())
+  {
+  }
+
+  bool        haveArg   (char const *argName)                    {  return m_exec.haveExecPort(argName);               }
+  std::string getArgType(char const *argName)                    {  return m_exec.getExecPortResolvedType(argName);    }
+  Value       getArg    (char const *argName)                    {  return m_binding.getArgValue(argName);             }
+  void        setArg    (char const *argName, const Value &val)  {  m_binding.setArgValue(argName, val, false);        }
+
+  Value constructBoolean(bool         val)  {  return FabricCore::RTVal::ConstructBoolean(m_client, val);  }
+  Value constructSInt8  (int8_t       val)  {  return FabricCore::RTVal::ConstructSInt8  (m_client, val);  }
+  Value constructSInt16 (int16_t      val)  {  return FabricCore::RTVal::ConstructSInt16 (m_client, val);  }
+  Value constructSInt32 (int32_t      val)  {  return FabricCore::RTVal::ConstructSInt32 (m_client, val);  }
+  Value constructSInt64 (int64_t      val)  {  return FabricCore::RTVal::ConstructSInt64 (m_client, val);  }
+  Value constructUInt8  (uint8_t      val)  {  return FabricCore::RTVal::ConstructUInt8  (m_client, val);  }
+  Value constructUInt16 (uint16_t     val)  {  return FabricCore::RTVal::ConstructUInt16 (m_client, val);  }
+  Value constructUInt32 (uint32_t     val)  {  return FabricCore::RTVal::ConstructUInt32 (m_client, val);  }
+  Value constructUInt64 (uint64_t     val)  {  return FabricCore::RTVal::ConstructUInt64 (m_client, val);  }
+  Value constructFloat32(float        val)  {  return FabricCore::RTVal::ConstructFloat32(m_client, val);  }
+  Value constructFloat64(double       val)  {  return FabricCore::RTVal::ConstructFloat64(m_client, val);  }
+  Value constructString (char const  *val)  {  return FabricCore::RTVal::ConstructString (m_client, val);  }
+  Value construct       (char const *type, int numMembers, Value *members)  {  return FabricCore::RTVal::Construct(m_client, type, numMembers, members);  }
+
+ private:
+
+  FabricCore::Client     &m_client;
+  FabricCore::DFGBinding &m_binding;
+  FabricCore::DFGExec     m_exec;
+};
+
 
 FabricCore::Client                        BaseInterface::s_client;
 FabricCore::DFGHost                       BaseInterface::s_host;
 FabricServices::ASTWrapper::KLASTManager *BaseInterface::s_manager = NULL;
+KLASTManagerLoader                       *BaseInterface::s_managerLoader = NULL;
 unsigned int                              BaseInterface::s_maxId = 0;
 void (*BaseInterface::s_logFunc)(void *, const char *, unsigned int) = NULL;
 void (*BaseInterface::s_logErrorFunc)(void *, const char *, unsigned int) = NULL;
@@ -45,6 +128,9 @@ BaseInterface::BaseInterface(void (*in_logFunc)     (void *, const char *, unsig
   {
     try
     {
+      QElapsedTimer timer;
+      timer.start();
+
       // create a client
       #ifdef USE_FABRICSPLICE__CLIENT
       {
@@ -69,9 +155,12 @@ BaseInterface::BaseInterface(void (*in_logFunc)     (void *, const char *, unsig
       // create a host for Canvas
       s_host = s_client.getDFGHost();
 
-      // create KL AST manager
-      s_manager = new FabricServices::ASTWrapper::KLASTManager(&s_client);
-      s_manager->loadAllExtensionsFromExtsPath();
+      // note: the KL AST manager is not created here, see preloadManager().
+
+      std::stringstream ssMs;
+      ssMs << (double)timer.nsecsElapsed() * 1.0e-6;
+      m = "Canvas client created in " + ssMs.str() + " ms";
+      logFunc(NULL, m.c_str(), m.length());
     }
     catch (FabricCore::Exception e)
     {
@@ -124,7 +213,14 @@ BaseInterface::~BaseInterface()
       try
       {
         printf("Destructing client...\n");
+        if (s_managerLoader)
+        {
+          s_managerLoader->wait();
+          delete s_managerLoader;
+          s_managerLoader = NULL;
+        }
         delete(s_manager);
+        s_manager = NULL;
         s_host = FabricCore::DFGHost();
         #ifdef USE_FABRICSPLICE__CLIENT
         {
@@ -175,9 +271,51 @@ FabricCore::DFGBinding BaseInterface::getBinding()
 
 FabricServices::ASTWrapper::KLASTManager *BaseInterface::getManager()
 {
+  // make sure the manager exists.
+  preloadManager();
+
+  // wait for the background thread to be done.
+  if (s_managerLoader)
+  {
+    s_managerLoader->wait();
+
+    std::string m;
+    if (s_managerLoader->getError().length())
+    {
+      m = "failed to load the KL extensions for code completion: " + s_managerLoader->getError();
+      logErrorFunc(NULL, m.c_str(), m.length());
+    }
+    std::stringstream ssMs;
+    ssMs << s_managerLoader->getMs();
+    m = "KL AST manager populated in " + ssMs.str() + " ms";
+    logFunc(NULL, m.c_str(), m.length());
+
+    delete s_managerLoader;
+    s_managerLoader = NULL;
+  }
+
   return s_manager;
 }
 
+void BaseInterface::preloadManager()
+{
+  // already created or no client?
+  if (s_manager || !s_client.isValid())
+    return;
+
+  // create the manager and populate it in the background.
+  try
+  {
+    s_manager       = new FabricServices::ASTWrapper::KLASTManager(&s_client);
+    s_managerLoader = new KLASTManagerLoader(s_manager);
+    s_managerLoader->start(QThread::LowPriority);
+  }
+  catch (FabricCore::Exception e)
+  {
+    logErrorFunc(NULL, e.getDesc_cstr(), e.getDescLength());
+  }
+}
+
 DFGUICmdHandlerDCC *BaseInterface::getCmdHandler()
 {
   return m_cmdHandler;
@@ -308,630 +446,170 @@ bool BaseInterface::HasOutputPort(const std::string &portName)
 
 int BaseInterface::GetArgValueBoolean(FabricCore::DFGBinding &binding, char const * argName, bool &out, bool strict)
 {
-  // init output.
-  out = false;
-
-  // set out from port value.
   try
   {
-    // invalid port?
-    if (!binding.getExec().haveExecPort(argName))
-      return -2;
-
-    std::string resolvedType = binding.getExec().getExecPortResolvedType(argName);
-    FabricCore::RTVal rtval  = binding.getArgValue(argName);
-
-    if      (resolvedType.length() == 0)    return -1;
-
-    else if (resolvedType == "Boolean")     out = rtval.getBoolean();
-
-    else if (!strict)
-    {
-      if      (resolvedType == "Scalar")    out = (0 != rtval.getFloat32());
-      else if (resolvedType == "Float32")   out = (0 != rtval.getFloat32());
-      else if (resolvedType == "Float64")   out = (0 != rtval.getFloat64());
-
-      else if (resolvedType == "Integer")   out = (0 != rtval.getSInt32());
-      else if (resolvedType == "SInt8")     out = (0 != rtval.getSInt8());
-      else if (resolvedType == "SInt16")    out = (0 != rtval.getSInt16());
-      else if (resolvedType == "SInt32")    out = (0 != rtval.getSInt32());
-      else if (resolvedType == "SInt64")    out = (0 != rtval.getSInt64());
-
-      else if (resolvedType == "Byte")      out = (0 != rtval.getUInt8());
-      else if (resolvedType == "UInt8")     out = (0 != rtval.getUInt8());
-      else if (resolvedType == "UInt16")    out = (0 != rtval.getUInt16());
-      else if (resolvedType == "Count")     out = (0 != rtval.getUInt32());
-      else if (resolvedType == "Index")     out = (0 != rtval.getUInt32());
-      else if (resolvedType == "Size")      out = (0 != rtval.getUInt32());
-      else if (resolvedType == "UInt32")    out = (0 != rtval.getUInt32());
-      else if (resolvedType == "DataSize")  out = (0 != rtval.getUInt64());
-      else if (resolvedType == "UInt64")    out = (0 != rtval.getUInt64());
-
-      else return -1;
-    }
-    else return -1;
+    DFGCoreBackend backend(*getClient(), binding);
+    return dfgMarshalling::GetArgValueBoolean(backend, argName, out, strict);
   }
   catch (FabricCore::Exception e)
   {
     logErrorFunc(NULL, e.getDesc_cstr(), e.getDescLength());
     return -4;
   }
-
-  // done.
-  return 0;
 }
 
 int BaseInterface::GetArgValueInteger(FabricCore::DFGBinding &binding, char const * argName, int &out, bool strict)
 {
-  // init output.
-  out = 0;
-
-  // set out from port value.
   try
   {
-    // invalid port?
-    if (!binding.getExec().haveExecPort(argName))
-      return -2;
-
-    std::string resolvedType = binding.getExec().getExecPortResolvedType(argName);
-    FabricCore::RTVal rtval  = binding.getArgValue(argName);
-
-    if      (resolvedType.length() == 0)    return -1;
-
-    else if (resolvedType == "Integer")     out = (int)rtval.getSInt32();
-    else if (resolvedType == "SInt8")       out = (int)rtval.getSInt8();
-    else if (resolvedType == "SInt16")      out = (int)rtval.getSInt16();
-    else if (resolvedType == "SInt32")      out = (int)rtval.getSInt32();
-    else if (resolvedType == "SInt64")      out = (int)rtval.getSInt64();
-
-    else if (resolvedType == "Byte")        out = (int)rtval.getUInt8();
-    else if (resolvedType == "UInt8")       out = (int)rtval.getUInt8();
-    else if (resolvedType == "UInt16")      out = (int)rtval.getUInt16();
-    else if (resolvedType == "Count")       out = (int)rtval.getUInt32();
-    else if (resolvedType == "Index")       out = (int)rtval.getUInt32();
-    else if (resolvedType == "Size")        out = (int)rtval.getUInt32();
-    else if (resolvedType == "UInt32")      out = (int)rtval.getUInt32();
-    else if (resolvedType == "DataSize")    out = (int)rtval.getUInt64();
-    else if (resolvedType == "UInt64")      out = (int)rtval.getUInt64();
-
-    else if (!strict)
-    {
-      if      (resolvedType == "Boolean")   out = (int)rtval.getBoolean();
-
-      else if (resolvedType == "Scalar")    out = (int)rtval.getFloat32();
-      else if (resolvedType == "Float32")   out = (int)rtval.getFloat32();
-      else if (resolvedType == "Float64")   out = (int)rtval.getFloat64();
-
-      else return -1;
-    }
-    else return -1;
+    DFGCoreBackend backend(*getClient(), binding);
+    return dfgMarshalling::GetArgValueInteger(backend, argName, out, strict);
   }
   catch (FabricCore::Exception e)
   {
     logErrorFunc(NULL, e.getDesc_cstr(), e.getDescLength());
     return -4;
   }
-
-  // done.
-  return 0;
 }
 
 int BaseInterface::GetArgValueFloat(FabricCore::DFGBinding &binding, char const * argName, double &out, bool strict)
 {
-  // init output.
-  out = 0;
-
-  // set out from port value.
   try
   {
-    // invalid port?
-    if (!binding.getExec().haveExecPort(argName))
-      return -2;
-
-    std::string resolvedType = binding.getExec().getExecPortResolvedType(argName);
-    FabricCore::RTVal rtval  = binding.getArgValue(argName);
-
-    if      (resolvedType.length() == 0)    return -1;
-
-    else if (resolvedType == "Scalar")      out = (double)rtval.getFloat32();
-    else if (resolvedType == "Float32")     out = (double)rtval.getFloat32();
-    else if (resolvedType == "Float64")     out = (double)rtval.getFloat64();
-
-    else if (!strict)
-    {
-      if      (resolvedType == "Boolean")   out = (double)rtval.getBoolean();
-
-      else if (resolvedType == "Integer")   out = (double)rtval.getSInt32();
-      else if (resolvedType == "SInt8")     out = (double)rtval.getSInt8();
-      else if (resolvedType == "SInt16")    out = (double)rtval.getSInt16();
-      else if (resolvedType == "SInt32")    out = (double)rtval.getSInt32();
-      else if (resolvedType == "SInt64")    out = (double)rtval.getSInt64();
-
-      else if (resolvedType == "Byte")      out = (double)rtval.getUInt8();
-      else if (resolvedType == "UInt8")     out = (double)rtval.getUInt8();
-      else if (resolvedType == "UInt16")    out = (double)rtval.getUInt16();
-      else if (resolvedType == "Count")     out = (double)rtval.getUInt32();
-      else if (resolvedType == "Index")     out = (double)rtval.getUInt32();
-      else if (resolvedType == "Size")      out = (double)rtval.getUInt32();
-      else if (resolvedType == "UInt32")    out = (double)rtval.getUInt32();
-      else if (resolvedType == "DataSize")  out = (double)rtval.getUInt64();
-      else if (resolvedType == "UInt64")    out = (double)rtval.getUInt64();
-
-      else return -1;
-    }
-    else return -1;
+    DFGCoreBackend backend(*getClient(), binding);
+    return dfgMarshalling::GetArgValueFloat(backend, argName, out, strict);
   }
   catch (FabricCore::Exception e)
   {
     logErrorFunc(NULL, e.getDesc_cstr(), e.getDescLength());
     return -4;
   }
-
-  // done.
-  return 0;
 }
 
 int BaseInterface::GetArgValueString(FabricCore::DFGBinding &binding, char const * argName, std::string &out, bool strict)
 {
-  // init output.
-  out = "";
-
-  // set out from port value.
   try
   {
-    // invalid port?
-    if (!binding.getExec().haveExecPort(argName))
-      return -2;
-
-    std::string resolvedType = binding.getExec().getExecPortResolvedType(argName);
-    FabricCore::RTVal rtval  = binding.getArgValue(argName);
-
-    if      (resolvedType.length() == 0)    return -1;
-
-    else if (resolvedType == "String")      out = rtval.getStringCString();
-
-    else if (!strict)
-    {
-      char    s[64];
-      bool    b;
-      int     i;
-      double  f;
-
-      if (GetArgValueBoolean(binding, argName, b, true) == 0)
-      {
-        out = (b ? "true" : "false");
-        return 0;
-      }
-
-      if (GetArgValueInteger(binding, argName, i, true) == 0)
-      {
-        #ifdef _WIN32
-          sprintf_s(s, sizeof(s), "%ld", i);
-        #else
-          snprintf(s, sizeof(s), "%ld", i);
-        #endif
-        out = s;
-        return 0;
-      }
-
-      if (GetArgValueFloat(binding, argName, f, true) == 0)
-      {
-        #ifdef _WIN32
-          sprintf_s(s, sizeof(s), "%f", f);
-        #else
-          snprintf(s, sizeof(s), "%f", f);
-        #endif
-        out = s;
-        return 0;
-      }
-
-      return -1;
-    }
-    else
-      return -1;
+    DFGCoreBackend backend(*getClient(), binding);
+    return dfgMarshalling::GetArgValueString(backend, argName, out, strict);
   }
   catch (FabricCore::Exception e)
   {
     logErrorFunc(NULL, e.getDesc_cstr(), e.getDescLength());
     return -4;
   }
-
-  // done.
-  return 0;
 }
 
 int BaseInterface::GetArgValueVec2(FabricCore::DFGBinding &binding, char const * argName, std::vector <double> &out, bool strict)
 {
-  // init output.
-  out.clear();
-
-  // set out from port value.
   try
   {
-    // invalid port?
-    if (!binding.getExec().haveExecPort(argName))
-      return -2;
-
-    std::string resolvedType = binding.getExec().getExecPortResolvedType(argName);
-    FabricCore::RTVal rtval  = binding.getArgValue(argName);
-
-    if      (resolvedType.length() == 0)      return -1;
-
-    else if (resolvedType == "Vec2")        {
-                                              out.push_back(rtval.maybeGetMember("x").getFloat32());
-                                              out.push_back(rtval.maybeGetMember("y").getFloat32());
-                                            }
-    else
-      return -1;
+    DFGCoreBackend backend(*getClient(), binding);
+    return dfgMarshalling::GetArgValueVec2(backend, argName, out, strict);
   }
   catch (FabricCore::Exception e)
   {
     logErrorFunc(NULL, e.getDesc_cstr(), e.getDescLength());
     return -4;
   }
-
-  // done.
-  return 0;
 }
 
 int BaseInterface::GetArgValueVec3(FabricCore::DFGBinding &binding, char const * argName, std::vector <double> &out, bool strict)
 {
-  // init output.
-  out.clear();
-
-  // set out from port value.
   try
   {
-    // invalid port?
-    if (!binding.getExec().haveExecPort(argName))
-      return -2;
-
-    std::string resolvedType = binding.getExec().getExecPortResolvedType(argName);
-    FabricCore::RTVal rtval  = binding.getArgValue(argName);
-
-    if      (resolvedType.length() == 0)      return -1;
-
-    else if (resolvedType == "Vec3")        {
-                                              out.push_back(rtval.maybeGetMember("x").getFloat32());
-                                              out.push_back(rtval.maybeGetMember("y").getFloat32());
-                                              out.push_back(rtval.maybeGetMember("z").getFloat32());
-                                            }
-    else if (!strict)
-    {
-        if      (resolvedType == "Color")   {
-                                              out.push_back(rtval.maybeGetMember("r").getFloat32());
-                                              out.push_back(rtval.maybeGetMember("g").getFloat32());
-                                              out.push_back(rtval.maybeGetMember("b").getFloat32());
-                                            }
-        else if (resolvedType == "Vec4")    {
-                                              out.push_back(rtval.maybeGetMember("x").getFloat32());
-                                              out.push_back(rtval.maybeGetMember("y").getFloat32());
-                                              out.push_back(rtval.maybeGetMember("z").getFloat32());
-                                            }
-        else
-          return -1;
-    }
+    DFGCoreBackend backend(*getClient(), binding);
+    return dfgMarshalling::GetArgValueVec3(backend, argName, out, strict);
   }
   catch (FabricCore::Exception e)
   {
     logErrorFunc(NULL, e.getDesc_cstr(), e.getDescLength());
     return -4;
   }
-
-  // done.
-  return 0;
 }
 
 int BaseInterface::GetArgValueVec4(FabricCore::DFGBinding &binding, char const * argName, std::vector <double> &out, bool strict)
 {
-  // init output.
-  out.clear();
-
-  // set out from port value.
   try
   {
-    // invalid port?
-    if (!binding.getExec().haveExecPort(argName))
-      return -2;
-
-    std::string resolvedType = binding.getExec().getExecPortResolvedType(argName);
-    FabricCore::RTVal rtval  = binding.getArgValue(argName);
-
-    if      (resolvedType.length() == 0)      return -1;
-
-    else if (resolvedType == "Vec4")        {
-                                              out.push_back(rtval.maybeGetMember("x").getFloat32());
-                                              out.push_back(rtval.maybeGetMember("y").getFloat32());
-                                              out.push_back(rtval.maybeGetMember("z").getFloat32());
-                                              out.push_back(rtval.maybeGetMember("t").getFloat32());
-                                            }
-    else if (!strict)
-    {
-        if      (resolvedType == "Color")   {
-                                              out.push_back(rtval.maybeGetMember("r").getFloat32());
-                                              out.push_back(rtval.maybeGetMember("g").getFloat32());
-                                              out.push_back(rtval.maybeGetMember("b").getFloat32());
-                                              out.push_back(rtval.maybeGetMember("a").getFloat32());
-                                            }
-        else
-          return -1;
-    }
+    DFGCoreBackend backend(*getClient(), binding);
+    return dfgMarshalling::GetArgValueVec4(backend, argName, out, strict);
   }
   catch (FabricCore::Exception e)
   {
     logErrorFunc(NULL, e.getDesc_cstr(), e.getDescLength());
     return -4;
   }
-
-  // done.
-  return 0;
 }
 
 int BaseInterface::GetArgValueColor(FabricCore::DFGBinding &binding, char const * argName, std::vector <double> &out, bool strict)
 {
-  // init output.
-  out.clear();
-
-  // set out from port value.
   try
   {
-    // invalid port?
-    if (!binding.getExec().haveExecPort(argName))
-      return -2;
-
-    std::string resolvedType = binding.getExec().getExecPortResolvedType(argName);
-    FabricCore::RTVal rtval  = binding.getArgValue(argName);
-
-    if      (resolvedType.length() == 0)      return -1;
-
-    else if (resolvedType == "Color")      {
-                                              out.push_back(rtval.maybeGetMember("r").getFloat32());
-                                              out.push_back(rtval.maybeGetMember("g").getFloat32());
-                                              out.push_back(rtval.maybeGetMember("b").getFloat32());
-                                              out.push_back(rtval.maybeGetMember("a").getFloat32());
-                                           }
-    else if (!strict)
-    {
-        if      (resolvedType == "Vec4")   {
-                                              out.push_back(rtval.maybeGetMember("x").getFloat32());
-                                              out.push_back(rtval.maybeGetMember("y").getFloat32());
-                                              out.push_back(rtval.maybeGetMember("z").getFloat32());
-                                              out.push_back(rtval.maybeGetMember("t").getFloat32());
-                                            }
-        else if (resolvedType == "RGB")     {
-                                              out.push_back(rtval.maybeGetMember("r").getUInt8() / 255.0);
-                                              out.push_back(rtval.maybeGetMember("g").getUInt8() / 255.0);
-                                              out.push_back(rtval.maybeGetMember("b").getUInt8() / 255.0);
-                                              out.push_back(1);
-                                            }
-        else if (resolvedType == "RGBA")    {
-                                              out.push_back(rtval.maybeGetMember("r").getUInt8() / 255.0);
-                                              out.push_back(rtval.maybeGetMember("g").getUInt8() / 255.0);
-                                              out.push_back(rtval.maybeGetMember("b").getUInt8() / 255.0);
-                                              out.push_back(rtval.maybeGetMember("a").getUInt8() / 255.0);
-                                            }
-        else
-          return -1;
-    }
+    DFGCoreBackend backend(*getClient(), binding);
+    return dfgMarshalling::GetArgValueColor(backend, argName, out, strict);
   }
   catch (FabricCore::Exception e)
   {
     logErrorFunc(NULL, e.getDesc_cstr(), e.getDescLength());
     return -4;
   }
-
-  // done.
-  return 0;
 }
 
 int BaseInterface::GetArgValueRGB(FabricCore::DFGBinding &binding, char const * argName, std::vector <double> &out, bool strict)
 {
-  // init output.
-  out.clear();
-
-  // set out from port value.
   try
   {
-    // invalid port?
-    if (!binding.getExec().haveExecPort(argName))
-      return -2;
-
-    std::string resolvedType = binding.getExec().getExecPortResolvedType(argName);
-    FabricCore::RTVal rtval  = binding.getArgValue(argName);
-
-    if      (resolvedType.length() == 0)    return -1;
-
-    else if (resolvedType == "RGB")       {
-                                            out.push_back(rtval.maybeGetMember("r").getUInt8() / 255.0);
-                                            out.push_back(rtval.maybeGetMember("g").getUInt8() / 255.0);
-                                            out.push_back(rtval.maybeGetMember("b").getUInt8() / 255.0);
-                                          }
-    else if (!strict)
-    {
-      if      (resolvedType == "RGBA")    {
-                                            out.push_back(rtval.maybeGetMember("r").getUInt8() / 255.0);
-                                            out.push_back(rtval.maybeGetMember("g").getUInt8() / 255.0);
-                                            out.push_back(rtval.maybeGetMember("b").getUInt8() / 255.0);
-                                          }
-      else if (resolvedType == "Color")   {
-                                            out.push_back(rtval.maybeGetMember("r").getFloat32());
-                                            out.push_back(rtval.maybeGetMember("g").getFloat32());
-                                            out.push_back(rtval.maybeGetMember("b").getFloat32());
-                                          }
-      else
-        return -1;
-    }
+    DFGCoreBackend backend(*getClient(), binding);
+    return dfgMarshalling::GetArgValueRGB(backend, argName, out, strict);
   }
   catch (FabricCore::Exception e)
   {
     logErrorFunc(NULL, e.getDesc_cstr(), e.getDescLength());
     return -4;
   }
-
-  // done.
-  return 0;
 }
 
 int BaseInterface::GetArgValueRGBA(FabricCore::DFGBinding &binding, char const * argName, std::vector <double> &out, bool strict)
 {
-  // init output.
-  out.clear();
-
-  // set out from port value.
   try
   {
-    // invalid port?
-    if (!binding.getExec().haveExecPort(argName))
-      return -2;
-
-      std::string resolvedType = binding.getExec().getExecPortResolvedType(argName);
-      FabricCore::RTVal rtval  = binding.getArgValue(argName);
-
-      if      (resolvedType.length() == 0)      return -1;
-
-      else if (resolvedType == "RGBA")        {
-                                                out.push_back(rtval.maybeGetMember("r").getUInt8() / 255.0);
-                                                out.push_back(rtval.maybeGetMember("g").getUInt8() / 255.0);
-                                                out.push_back(rtval.maybeGetMember("b").getUInt8() / 255.0);
-                                                out.push_back(rtval.maybeGetMember("a").getUInt8() / 255.0);
-                                              }
-      else if (!strict)
-      {
-          if      (resolvedType == "RGB")     {
-                                                out.push_back(rtval.maybeGetMember("r").getUInt8() / 255.0);
-                                                out.push_back(rtval.maybeGetMember("g").getUInt8() / 255.0);
-                                                out.push_back(rtval.maybeGetMember("b").getUInt8() / 255.0);
-                                                out.push_back(1);
-                                              }
-          else if (resolvedType == "Color")   {
-                                                out.push_back(rtval.maybeGetMember("r").getFloat32());
-                                                out.push_back(rtval.maybeGetMember("g").getFloat32());
-                                                out.push_back(rtval.maybeGetMember("b").getFloat32());
-                                                out.push_back(rtval.maybeGetMember("a").getFloat32());
-                                              }
-          else
-            return -1;
-      }
+    DFGCoreBackend backend(*getClient(), binding);
+    return dfgMarshalling::GetArgValueRGBA(backend, argName, out, strict);
   }
   catch (FabricCore::Exception e)
   {
     logErrorFunc(NULL, e.getDesc_cstr(), e.getDescLength());
     return -4;
   }
-
-  // done.
-  return 0;
 }
 
 int BaseInterface::GetArgValueQuat(FabricCore::DFGBinding &binding, char const * argName, std::vector <double> &out, bool strict)
 {
-  // init output.
-  out.clear();
-
-  // set out from port value.
   try
   {
-    // invalid port?
-    if (!binding.getExec().haveExecPort(argName))
-      return -2;
-
-    std::string resolvedType = binding.getExec().getExecPortResolvedType(argName);
-    FabricCore::RTVal rtval  = binding.getArgValue(argName);
-
-    if      (resolvedType.length() == 0)      return -1;
-
-    else if (resolvedType == "Quat")        {
-                                              FabricCore::RTVal v;
-                                              v = rtval.maybeGetMember("v");
-                                              out.push_back(v.    maybeGetMember("x").getFloat32());
-                                              out.push_back(v.    maybeGetMember("y").getFloat32());
-                                              out.push_back(v.    maybeGetMember("z").getFloat32());
-                                              out.push_back(rtval.maybeGetMember("w").getFloat32());
-                                            }
-    else
-      return -1;
+    DFGCoreBackend backend(*getClient(), binding);
+    return dfgMarshalling::GetArgValueQuat(backend, argName, out, strict);
   }
   catch (FabricCore::Exception e)
   {
     logErrorFunc(NULL, e.getDesc_cstr(), e.getDescLength());
     return -4;
   }
-
-  // done.
-  return 0;
 }
 
 int BaseInterface::GetArgValueMat44(FabricCore::DFGBinding &binding, char const * argName, std::vector <double> &out, bool strict)
 {
-  // init output.
-  out.clear();
-
-  // set out from port value.
   try
   {
-    // invalid port?
-    if (!binding.getExec().haveExecPort(argName))
-      return -2;
-
-    std::string resolvedType = binding.getExec().getExecPortResolvedType(argName);
-    FabricCore::RTVal rtval  = binding.getArgValue(argName);
-
-    if      (resolvedType.length() == 0)      return -1;
-
-    else if (resolvedType == "Mat44")       {
-                                              char member[32];
-                                              FabricCore::RTVal rtRow;
-                                              for (int i = 0; i < 4; i++)
-                                              {
-                                                #ifdef _WIN32
-                                                  sprintf_s(member, sizeof(member), "row%ld", i);
-                                                #else
-                                                  snprintf(member, sizeof(member), "row%ld", i);
-                                                #endif
-                                                rtRow = rtval.maybeGetMember(member);
-                                                out.push_back(rtRow.maybeGetMember("x").getFloat32());
-                                                out.push_back(rtRow.maybeGetMember("y").getFloat32());
-                                                out.push_back(rtRow.maybeGetMember("z").getFloat32());
-                                                out.push_back(rtRow.maybeGetMember("t").getFloat32());
-                                              }
-                                            }
-    else if (resolvedType == "Xfo")       {
-                                              //char member[32];
-                                              /*FabricCore::RTVal tr = rtval.maybeGetMember("tr");
-                                              FabricCore::RTVal ori = rtval.maybeGetMember("ori");
-                                              FabricCore::RTVal oriAxis = rtval.maybeGetMember("v");
-                                              FabricCore::RTVal sc = rtval.maybeGetMember("sc");*/
-
-                                              /*#ifdef _WIN32
-                                                sprintf_s(member, sizeof(member), "row%ld", i);
-                                              #else
-                                                snprintf(member, sizeof(member), "row%ld", i);
-                                              #endif*/
-                                              FabricCore::RTVal ori;
-                                              ori = rtval.maybeGetMember("ori");
-
-                                              out.push_back(rtval.maybeGetMember("sc").maybeGetMember("x").getFloat32());
-                                              out.push_back(rtval.maybeGetMember("sc").maybeGetMember("y").getFloat32());
-                                              out.push_back(rtval.maybeGetMember("sc").maybeGetMember("z").getFloat32());
-                                              out.push_back(ori.maybeGetMember("w").getFloat32());
-                                              out.push_back(ori.maybeGetMember("v").maybeGetMember("x").getFloat32());
-                                              out.push_back(ori.maybeGetMember("v").maybeGetMember("y").getFloat32());
-                                              out.push_back(ori.maybeGetMember("v").maybeGetMember("z").getFloat32());
-                                              out.push_back(rtval.maybeGetMember("tr").maybeGetMember("x").getFloat32());
-                                              out.push_back(rtval.maybeGetMember("tr").maybeGetMember("y").getFloat32());
-                                              out.push_back(rtval.maybeGetMember("tr").maybeGetMember("z").getFloat32());
-                                            }
-    else
-      return -1;
+    DFGCoreBackend backend(*getClient(), binding);
+    return dfgMarshalling::GetArgValueMat44(backend, argName, out, strict);
   }
   catch (FabricCore::Exception e)
   {
     logErrorFunc(NULL, e.getDesc_cstr(), e.getDescLength());
     return -4;
   }
-
-  // done.
-  return 0;
 }
 
 int BaseInterface::GetArgValuePolygonMesh(FabricCore::DFGBinding &binding,
@@ -1139,18 +817,14 @@ int BaseInterface::GetArgValueProperties(FabricCore::DFGBinding &binding, char c
 
 void BaseInterface::SetValueOfArgBoolean(FabricCore::Client &client, FabricCore::DFGBinding &binding, char const * argName, const bool val)
 {
-  if (!binding.getExec().haveExecPort(argName))
-  {
-    std::string s = "BaseInterface::SetValueOfArgBoolean(): port not found.";
-    logErrorFunc(NULL, s.c_str(), s.length());
-    return;
-  }
-
   try
   {
-    FabricCore::RTVal rtval;
-    rtval = FabricCore::RTVal::ConstructBoolean(client, val);
-    binding.setArgValue(argName, rtval, false);
+    DFGCoreBackend backend(client, binding);
+    if (dfgMarshalling::SetValueOfArgBoolean(backend, argName, val) == -2)
+    {
+      std::string s = "BaseInterface::SetValueOfArgBoolean(): port not found.";
+      logErrorFunc(NULL, s.c_str(), s.length());
+    }
   }
   catch (FabricCore::Exception e)
   {
@@ -1160,23 +834,14 @@ void BaseInterface::SetValueOfArgBoolean(FabricCore::Client &client, FabricCore:
 
 void BaseInterface::SetValueOfArgSInt(FabricCore::Client &client, FabricCore::DFGBinding &binding, char const * argName, const int32_t val)
 {
-  if (!binding.getExec().haveExecPort(argName))
-  {
-    std::string s = "BaseInterface::SetValueOfArgSInt(): port not found.";
-    logErrorFunc(NULL, s.c_str(), s.length());
-    return;
-  }
-
   try
   {
-    FabricCore::RTVal rtval;
-    std::string resolvedType = binding.getExec().getExecPortResolvedType(argName);
-    if      (resolvedType == "Integer") rtval = FabricCore::RTVal::ConstructSInt32(client, val);
-    else if (resolvedType == "SInt8")   rtval = FabricCore::RTVal::ConstructSInt8 (client, val);
-    else if (resolvedType == "SInt16")  rtval = FabricCore::RTVal::ConstructSInt16(client, val);
-    else if (resolvedType == "SInt32")  rtval = FabricCore::RTVal::ConstructSInt32(client, val);
-    else if (resolvedType == "SInt64")  rtval = FabricCore::RTVal::ConstructSInt64(client, val);
-    binding.setArgValue(argName, rtval, false);
+    DFGCoreBackend backend(client, binding);
+    if (dfgMarshalling::SetValueOfArgSInt(backend, argName, val) == -2)
+    {
+      std::string s = "BaseInterface::SetValueOfArgSInt(): port not found.";
+      logErrorFunc(NULL, s.c_str(), s.length());
+    }
   }
   catch (FabricCore::Exception e)
   {
@@ -1186,27 +851,14 @@ void BaseInterface::SetValueOfArgSInt(FabricCore::Client &client, FabricCore::DF
 
 void BaseInterface::SetValueOfArgUInt(FabricCore::Client &client, FabricCore::DFGBinding &binding, char const * argName, const uint32_t val)
 {
-  if (!binding.getExec().haveExecPort(argName))
-  {
-    std::string s = "BaseInterface::SetValueOfArgUInt(): port not found.";
-    logErrorFunc(NULL, s.c_str(), s.length());
-    return;
-  }
-
   try
   {
-    FabricCore::RTVal rtval;
-    std::string resolvedType = binding.getExec().getExecPortResolvedType(argName);
-    if      (resolvedType == "Byte")      rtval = FabricCore::RTVal::ConstructUInt8 (client, val);
-    else if (resolvedType == "UInt8")     rtval = FabricCore::RTVal::ConstructUInt16(client, val);
-    else if (resolvedType == "UInt16")    rtval = FabricCore::RTVal::ConstructUInt16(client, val);
-    else if (resolvedType == "Count")     rtval = FabricCore::RTVal::ConstructUInt32(client, val);
-    else if (resolvedType == "Index")     rtval = FabricCore::RTVal::ConstructUInt32(client, val);
-    else if (resolvedType == "Size")      rtval = FabricCore::RTVal::ConstructUInt32(client, val);
-    else if (resolvedType == "UInt32")    rtval = FabricCore::RTVal::ConstructUInt32(client, val);
-    else if (resolvedType == "DataSize")  rtval = FabricCore::RTVal::ConstructUInt64(client, val);
-    else if (resolvedType == "UInt64")    rtval = FabricCore::RTVal::ConstructUInt64(client, val);
-    binding.setArgValue(argName, rtval, false);
+    DFGCoreBackend backend(client, binding);
+    if (dfgMarshalling::SetValueOfArgUInt(backend, argName, val) == -2)
+    {
+      std::string s = "BaseInterface::SetValueOfArgUInt(): port not found.";
+      logErrorFunc(NULL, s.c_str(), s.length());
+    }
   }
   catch (FabricCore::Exception e)
   {
@@ -1216,21 +868,14 @@ void BaseInterface::SetValueOfArgUInt(FabricCore::Client &client, FabricCore::DF
 
 void BaseInterface::SetValueOfArgFloat(FabricCore::Client &client, FabricCore::DFGBinding &binding, char const * argName, const double val)
 {
-  if (!binding.getExec().haveExecPort(argName))
-  {
-    std::string s = "BaseInterface::SetValueOfArgFloat(): port not found.";
-    logErrorFunc(NULL, s.c_str(), s.length());
-    return;
-  }
-
   try
   {
-    FabricCore::RTVal rtval;
-    std::string resolvedType = binding.getExec().getExecPortResolvedType(argName);
-    if      (resolvedType == "Scalar")  rtval = FabricCore::RTVal::ConstructFloat32(client, val);
-    else if (resolvedType == "Float32") rtval = FabricCore::RTVal::ConstructFloat32(client, val);
-    else if (resolvedType == "Float64") rtval = FabricCore::RTVal::ConstructFloat64(client, val);
-    binding.setArgValue(argName, rtval, false);
+    DFGCoreBackend backend(client, binding);
+    if (dfgMarshalling::SetValueOfArgFloat(backend, argName, val) == -2)
+    {
+      std::string s = "BaseInterface::SetValueOfArgFloat(): port not found.";
+      logErrorFunc(NULL, s.c_str(), s.length());
+    }
   }
   catch (FabricCore::Exception e)
   {
@@ -1240,18 +885,14 @@ void BaseInterface::SetValueOfArgFloat(FabricCore::Client &client, FabricCore::D
 
 void BaseInterface::SetValueOfArgString(FabricCore::Client &client, FabricCore::DFGBinding &binding, char const * argName, const std::string &val)
 {
-  if (!binding.getExec().haveExecPort(argName))
-  {
-    std::string s = "BaseInterface::SetValueOfArgString(): port not found.";
-    logErrorFunc(NULL, s.c_str(), s.length());
-    return;
-  }
-
   try
   {
-    FabricCore::RTVal rtval;
-    rtval = FabricCore::RTVal::ConstructString(client, val.c_str());
-    binding.setArgValue(argName, rtval, false);
+    DFGCoreBackend backend(client, binding);
+    if (dfgMarshalling::SetValueOfArgString(backend, argName, val) == -2)
+    {
+      std::string s = "BaseInterface::SetValueOfArgString(): port not found.";
+      logErrorFunc(NULL, s.c_str(), s.length());
+    }
   }
   catch (FabricCore::Exception e)
   {
@@ -1261,24 +902,14 @@ void BaseInterface::SetValueOfArgString(FabricCore::Client &client, FabricCore::
 
 void BaseInterface::SetValueOfArgVec2(FabricCore::Client &client, FabricCore::DFGBinding &binding, char const * argName, const std::vector <double> &val)
 {
-  if (!binding.getExec().haveExecPort(argName))
-  {
-    std::string s = "BaseInterface::SetValueOfArgVec2(): port not found.";
-    logErrorFunc(NULL, s.c_str(), s.length());
-    return;
-  }
-
   try
   {
-    const int  N        =     2;
-    const char name[16] = "Vec2";
-    FabricCore::RTVal rtval;
-    FabricCore::RTVal v[N];
-    const bool valIsValid  = (val.size() >= N);
-    for (int i = 0; i < N; i++)
-      v[i] = FabricCore::RTVal::ConstructFloat32(client, valIsValid ? val[i] : 0);
-    rtval  = FabricCore::RTVal::Construct(client, name, N, v);
-    binding.setArgValue(argName, rtval, false);
+    DFGCoreBackend backend(client, binding);
+    if (dfgMarshalling::SetValueOfArgVec2(backend, argName, val) == -2)
+    {
+      std::string s = "BaseInterface::SetValueOfArgVec2(): port not found.";
+      logErrorFunc(NULL, s.c_str(), s.length());
+    }
   }
   catch (FabricCore::Exception e)
   {
@@ -1288,24 +919,14 @@ void BaseInterface::SetValueOfArgVec2(FabricCore::Client &client, FabricCore::DF
 
 void BaseInterface::SetValueOfArgVec3(FabricCore::Client &client, FabricCore::DFGBinding &binding, char const * argName, const std::vector <double> &val)
 {
-  if (!binding.getExec().haveExecPort(argName))
-  {
-    std::string s = "BaseInterface::SetValueOfArgVec3(): port not found.";
-    logErrorFunc(NULL, s.c_str(), s.length());
-    return;
-  }
-
   try
   {
-    const int  N        =     3;
-    const char name[16] = "Vec3";
-    FabricCore::RTVal rtval;
-    FabricCore::RTVal v[N];
-    const bool valIsValid  = (val.size() >= N);
-    for (int i = 0; i < N; i++)
-      v[i] = FabricCore::RTVal::ConstructFloat32(client, valIsValid ? val[i] : 0);
-    rtval  = FabricCore::RTVal::Construct(client, name, N, v);
-    binding.setArgValue(argName, rtval, false);
+    DFGCoreBackend backend(client, binding);
+    if (dfgMarshalling::SetValueOfArgVec3(backend, argName, val) == -2)
+    {
+      std::string s = "BaseInterface::SetValueOfArgVec3(): port not found.";
+      logErrorFunc(NULL, s.c_str(), s.length());
+    }
   }
   catch (FabricCore::Exception e)
   {
@@ -1315,24 +936,14 @@ void BaseInterface::SetValueOfArgVec3(FabricCore::Client &client, FabricCore::DF
 
 void BaseInterface::SetValueOfArgVec4(FabricCore::Client &client, FabricCore::DFGBinding &binding, char const * argName, const std::vector <double> &val)
 {
-  if (!binding.getExec().haveExecPort(argName))
-  {
-    std::string s = "BaseInterface::SetValueOfArgVec4(): port not found.";
-    logErrorFunc(NULL, s.c_str(), s.length());
-    return;
-  }
-
   try
   {
-    const int  N        =     4;
-    const char name[16] = "Vec4";
-    FabricCore::RTVal rtval;
-    FabricCore::RTVal v[N];
-    const bool valIsValid  = (val.size() >= N);
-    for (int i = 0; i < N; i++)
-      v[i] = FabricCore::RTVal::ConstructFloat32(client, valIsValid ? val[i] : 0);
-    rtval  = FabricCore::RTVal::Construct(client, name, N, v);
-    binding.setArgValue(argName, rtval, false);
+    DFGCoreBackend backend(client, binding);
+    if (dfgMarshalling::SetValueOfArgVec4(backend, argName, val) == -2)
+    {
+      std::string s = "BaseInterface::SetValueOfArgVec4(): port not found.";
+      logErrorFunc(NULL, s.c_str(), s.length());
+    }
   }
   catch (FabricCore::Exception e)
   {
@@ -1342,24 +953,14 @@ void BaseInterface::SetValueOfArgVec4(FabricCore::Client &client, FabricCore::DF
 
 void BaseInterface::SetValueOfArgColor(FabricCore::Client &client, FabricCore::DFGBinding &binding, char const * argName, const std::vector <double> &val)
 {
-  if (!binding.getExec().haveExecPort(argName))
-  {
-    std::string s = "BaseInterface::SetValueOfArgColor(): port not found.";
-    logErrorFunc(NULL, s.c_str(), s.length());
-    return;
-  }
-
   try
   {
-    const int  N        =      4;
-    const char name[16] = "Color";
-    FabricCore::RTVal rtval;
-    FabricCore::RTVal v[N];
-    const bool valIsValid  = (val.size() >= N);
-    for (int i = 0; i < N; i++)
-      v[i] = FabricCore::RTVal::ConstructFloat32(client, valIsValid ? val[i] : 0);
-    rtval  = FabricCore::RTVal::Construct(client, name, N, v);
-    binding.setArgValue(argName, rtval, false);
+    DFGCoreBackend backend(client, binding);
+    if (dfgMarshalling::SetValueOfArgColor(backend, argName, val) == -2)
+    {
+      std::string s = "BaseInterface::SetValueOfArgColor(): port not found.";
+      logErrorFunc(NULL, s.c_str(), s.length());
+    }
   }
   catch (FabricCore::Exception e)
   {
@@ -1369,24 +970,14 @@ void BaseInterface::SetValueOfArgColor(FabricCore::Client &client, FabricCore::D
 
 void BaseInterface::SetValueOfArgRGB(FabricCore::Client &client, FabricCore::DFGBinding &binding, char const * argName, const std::vector <double> &val)
 {
-  if (!binding.getExec().haveExecPort(argName))
-  {
-    std::string s = "BaseInterface::SetValueOfArgRGB(): port not found.";
-    logErrorFunc(NULL, s.c_str(), s.length());
-    return;
-  }
-
   try
   {
-    const int  N        =    3;
-    const char name[16] = "RGB";
-    FabricCore::RTVal rtval;
-    FabricCore::RTVal v[N];
-    const bool valIsValid  = (val.size() >= N);
-    for (int i = 0; i < N; i++)
-      v[i] = FabricCore::RTVal::ConstructUInt8(client, valIsValid ? (uint8_t)std::max(0.0, std::min(255.0, 255.0 * val[i])) : 0);
-    rtval  = FabricCore::RTVal::Construct(client, name, N, v);
-    binding.setArgValue(argName, rtval, false);
+    DFGCoreBackend backend(client, binding);
+    if (dfgMarshalling::SetValueOfArgRGB(backend, argName, val) == -2)
+    {
+      std::string s = "BaseInterface::SetValueOfArgRGB(): port not found.";
+      logErrorFunc(NULL, s.c_str(), s.length());
+    }
   }
   catch (FabricCore::Exception e)
   {
@@ -1396,24 +987,14 @@ void BaseInterface::SetValueOfArgRGB(FabricCore::Client &client, FabricCore::DFG
 
 void BaseInterface::SetValueOfArgRGBA(FabricCore::Client &client, FabricCore::DFGBinding &binding, char const * argName, const std::vector <double> &val)
 {
-  if (!binding.getExec().haveExecPort(argName))
-  {
-    std::string s = "BaseInterface::SetValueOfArgRGBA(): port not found.";
-    logErrorFunc(NULL, s.c_str(), s.length());
-    return;
-  }
-
   try
   {
-    const int  N        =     4;
-    const char name[16] = "RGBA";
-    FabricCore::RTVal rtval;
-    FabricCore::RTVal v[N];
-    const bool valIsValid  = (val.size() >= N);
-    for (int i = 0; i < N; i++)
-      v[i] = FabricCore::RTVal::ConstructUInt8(client, valIsValid ? (uint8_t)std::max(0.0, std::min(255.0, 255.0 * val[i])) : 0);
-    rtval  = FabricCore::RTVal::Construct(client, name, N, v);
-    binding.setArgValue(argName, rtval, false);
+    DFGCoreBackend backend(client, binding);
+    if (dfgMarshalling::SetValueOfArgRGBA(backend, argName, val) == -2)
+    {
+      std::string s = "BaseInterface::SetValueOfArgRGBA(): port not found.";
+      logErrorFunc(NULL, s.c_str(), s.length());
+    }
   }
   catch (FabricCore::Exception e)
   {
@@ -1423,25 +1004,14 @@ void BaseInterface::SetValueOfArgRGBA(FabricCore::Client &client, FabricCore::DF
 
 void BaseInterface::SetValueOfArgQuat(FabricCore::Client &client, FabricCore::DFGBinding &binding, char const * argName, const std::vector <double> &val)
 {
-  if (!binding.getExec().haveExecPort(argName))
-  {
-    std::string s = "BaseInterface::SetValueOfArgQuat(): port not found.";
-    logErrorFunc(NULL, s.c_str(), s.length());
-    return;
-  }
-
   try
   {
-    FabricCore::RTVal rtval;
-    FabricCore::RTVal xyz[3], v[2];
-    const bool valIsValid = (val.size() >= 4);
-    xyz[0] = FabricCore::RTVal::ConstructFloat32(client, valIsValid ? val[0] : 0);
-    xyz[1] = FabricCore::RTVal::ConstructFloat32(client, valIsValid ? val[1] : 0);
-    xyz[2] = FabricCore::RTVal::ConstructFloat32(client, valIsValid ? val[2] : 0);
-    v[0]   = FabricCore::RTVal::Construct(client, "Vec3", 3, xyz);
-    v[1]   = FabricCore::RTVal::ConstructFloat32(client, valIsValid ? val[3] : 0);
-    rtval  = FabricCore::RTVal::Construct(client, "Quat", 2, v);
-    binding.setArgValue(argName, rtval, false);
+    DFGCoreBackend backend(client, binding);
+    if (dfgMarshalling::SetValueOfArgQuat(backend, argName, val) == -2)
+    {
+      std::string s = "BaseInterface::SetValueOfArgQuat(): port not found.";
+      logErrorFunc(NULL, s.c_str(), s.length());
+    }
   }
   catch (FabricCore::Exception e)
   {
@@ -1451,29 +1021,14 @@ void BaseInterface::SetValueOfArgQuat(FabricCore::Client &client, FabricCore::DF
 
 void BaseInterface::SetValueOfArgMat44(FabricCore::Client &client, FabricCore::DFGBinding &binding, char const * argName, const std::vector <double> &val)
 {
-  if (!binding.getExec().haveExecPort(argName))
-  {
-    std::string s = "BaseInterface::SetValueOfArgMat44(): port not found.";
-    logErrorFunc(NULL, s.c_str(), s.length());
-    return;
-  }
-
   try
   {
-    FabricCore::RTVal rtval;
-    FabricCore::RTVal xyzt[4], v[4];
-    const bool valIsValid = (val.size() >= 16);
-    for (int i = 0; i < 4; i++)
+    DFGCoreBackend backend(client, binding);
+    if (dfgMarshalling::SetValueOfArgMat44(backend, argName, val) == -2)
     {
-      int offset = i * 4;
-      xyzt[0] = FabricCore::RTVal::ConstructFloat32(client, valIsValid ? val[offset + 0] : 0);
-      xyzt[1] = FabricCore::RTVal::ConstructFloat32(client, valIsValid ? val[offset + 1] : 0);
-      xyzt[2] = FabricCore::RTVal::ConstructFloat32(client, valIsValid ? val[offset + 2] : 0);
-      xyzt[3] = FabricCore::RTVal::ConstructFloat32(client, valIsValid ? val[offset + 3] : 0);
-      v[i]    = FabricCore::RTVal::Construct(client, "Vec4", 4, xyzt);
+      std::string s = "BaseInterface::SetValueOfArgMat44(): port not found.";
+      logErrorFunc(NULL, s.c_str(), s.length());
     }
-    rtval = FabricCore::RTVal::Construct(client, "Mat44", 4, v);
-    binding.setArgValue(argName, rtval, false);
   }
   catch (FabricCore::Exception e)
   {
@@ -1483,38 +1038,14 @@ void BaseInterface::SetValueOfArgMat44(FabricCore::Client &client, FabricCore::D
 
 void BaseInterface::SetValueOfArgXfo(FabricCore::Client &client, FabricCore::DFGBinding &binding, char const * argName, const std::vector <double> &val)
 {
-  if (!binding.getExec().haveExecPort(argName))
-  {
-    std::string s = "BaseInterface::SetValueOfArgXfo(): port not found.";
-    logErrorFunc(NULL, s.c_str(), s.length());
-    return;
-  }
-
   try
   {
-    FabricCore::RTVal rtval;
-    FabricCore::RTVal sc[3], xyz[3], ori[2], tr[3], xfo[3];
-
-    xyz[0] = FabricCore::RTVal::ConstructFloat32(client, val[4]);
-    xyz[1] = FabricCore::RTVal::ConstructFloat32(client, val[5]);
-    xyz[2] = FabricCore::RTVal::ConstructFloat32(client, val[6]);
-    ori[0]   = FabricCore::RTVal::Construct(client, "Vec3", 3, xyz);
-    ori[1]   = FabricCore::RTVal::ConstructFloat32(client, val[3]);
-
-    tr[0] = FabricCore::RTVal::ConstructFloat32(client, val[7]);
-    tr[1] = FabricCore::RTVal::ConstructFloat32(client, val[8]);
-    tr[2] = FabricCore::RTVal::ConstructFloat32(client, val[9]);
-
-    sc[0] = FabricCore::RTVal::ConstructFloat32(client, val[0]);
-    sc[1] = FabricCore::RTVal::ConstructFloat32(client, val[1]);
-    sc[2] = FabricCore::RTVal::ConstructFloat32(client, val[2]);
-
-    xfo[1]   = FabricCore::RTVal::Construct(client, "Vec3", 3, tr);
-    xfo[0]   = FabricCore::RTVal::Construct(client, "Quat", 2, ori);
-    xfo[2]   = FabricCore::RTVal::Construct(client, "Vec3", 3, sc);
-
-    rtval = FabricCore::RTVal::Construct(client, "Xfo", 3, xfo);
-    binding.setArgValue(argName, rtval, false);
+    DFGCoreBackend backend(client, binding);
+    if (dfgMarshalling::SetValueOfArgXfo(backend, argName, val) == -2)
+    {
+      std::string s = "BaseInterface::SetValueOfArgXfo(): port not found.";
+      logErrorFunc(NULL, s.c_str(), s.length());
+    }
   }
   catch (FabricCore::Exception e)
   {
@@ -1522,6 +1053,19 @@ void BaseInterface::SetValueOfArgXfo(FabricCore::Client &client, FabricCore::DFG
   }
 }
 
+// sets the polygon node values of a named Vec3 (UVWs) or Color attribute of a KL PolygonMesh.
+static void setPolygonMeshNamedAttribute(FabricCore::Client &client, FabricCore::RTVal &rtMesh, const std::string &name, const std::vector <float> &values, bool isUVWs)
+{
+  const int components = (isUVWs ? 3 : 4);
+  FabricCore::RTVal attributes = rtMesh.callMethod("GeometryAttributes", "getAttributes", 0, NULL);
+  std::vector <FabricCore::RTVal> args(2);
+  args[0] = FabricCore::RTVal::ConstructString(client, name.c_str());
+  if (isUVWs) attributes.callMethod("Vec3Attribute",  "getOrCreateVec3Attribute",  1, &args[0]);
+  else        attributes.callMethod("ColorAttribute", "getOrCreateColorAttribute", 1, &args[0]);
+  args[1] = FabricCore::RTVal::ConstructExternalArray(client, (isUVWs ? "Vec3" : "Color"), values.size() / components, (void *)values.data());
+  rtMesh.callMethod("", "setAttributeFromPolygonPackedData", 2, &args[0]);
+}
+
 void BaseInterface::SetValueOfArgPolygonMesh(FabricCore::Client &client, FabricCore::DFGBinding &binding, char const * argName, const _polymesh &val)
 {
   if (!binding.getExec().haveExecPort(argName))
@@ -1569,6 +1113,14 @@ void BaseInterface::SetValueOfArgPolygonMesh(FabricCore::Client &client, FabricC
         args[1] = FabricCore::RTVal::ConstructUInt32(client, 4);
         rtval.callMethod("", "setVertexColorsFromExternalArray", 2, &args[0]);
       }
+
+      // additional UVW and color sets.
+      for (size_t i=0;i<val.extraUVWNames.size();i++)
+        if (val.extraPolyNodeUVWs[i].size() == 3 * val.numSamples)
+          setPolygonMeshNamedAttribute(client, rtval, val.extraUVWNames[i], val.extraPolyNodeUVWs[i], true);
+      for (size_t i=0;i<val.extraColorNames.size();i++)
+        if (val.extraPolyNodeColors[i].size() == 4 * val.numSamples)
+          setPolygonMeshNamedAttribute(client, rtval, val.extraColorNames[i], val.extraPolyNodeColors[i], false);
     }
     binding.setArgValue(argName, rtval, false);
   }
@@ -1620,6 +1172,26 @@ void BaseInterface::SetValueOfArgVec3Array(FabricCore::Client &client, FabricCor
   }
 }
 
+void BaseInterface::SetValueOfArgExternalArray(FabricCore::Client &client, FabricCore::DFGBinding &binding, char const * argName, char const * dataType, int size, const void * val)
+{
+  if (!binding.getExec().haveExecPort(argName))
+  {
+    std::string s = "BaseInterface::SetValueOfArgExternalArray(): port not found.";
+    logErrorFunc(NULL, s.c_str(), s.length());
+    return;
+  }
+
+  try
+  {
+    FabricCore::RTVal rtval = FabricCore::RTVal::ConstructExternalArray(client, dataType, size, (void *)val);
+    binding.setArgValue(argName, rtval, false);
+  }
+  catch (FabricCore::Exception e)
+  {
+    logErrorFunc(NULL, e.getDesc_cstr(), e.getDescLength());
+  }
+}
+
 
 
 
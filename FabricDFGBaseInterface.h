@@ -14,6 +14,7 @@
 
 struct _polymesh;
 class DFGUICmdHandlerDCC;
+class KLASTManagerLoader;
 
 
 // a management class for client and host
@@ -39,6 +40,13 @@ class BaseInterface
   static FabricServices::ASTWrapper::KLASTManager *getManager();
   DFGUICmdHandlerDCC                              *getCmdHandler();
 
+  // KL AST manager.
+  // the manager parses all the extensions of the exts path (for code completion),
+  // which is slow, so it is populated lazily on a background thread.
+  // preloadManager() starts populating the manager (if not already done),
+  // getManager() starts it if necessary and waits until it is done.
+  static void preloadManager();
+
   // persistence
   std::string getJSON();
   void setFromJSON(const std::string &json);
@@ -64,6 +72,7 @@ class BaseInterface
   static FabricCore::Client                        s_client;
   static FabricCore::DFGHost                       s_host;
   static FabricServices::ASTWrapper::KLASTManager *s_manager;
+  static KLASTManagerLoader                       *s_managerLoader;
   FabricCore::DFGBinding                           m_binding;
   DFGUICmdHandlerDCC                              *m_cmdHandler;
   static std::map<unsigned int, BaseInterface*>    s_instances;
@@ -143,6 +152,7 @@ class BaseInterface
   static void SetValueOfArgPolygonMesh  (FabricCore::Client &client, FabricCore::DFGBinding &binding, char const *argName, const _polymesh            &val);
   static void SetValueOfArgFloat64Array (FabricCore::Client &client, FabricCore::DFGBinding &binding, char const *argName, int size, const double *val);
   static void SetValueOfArgVec3Array    (FabricCore::Client &client, FabricCore::DFGBinding &binding, char const *argName, int size, const float *val);
+  static void SetValueOfArgExternalArray(FabricCore::Client &client, FabricCore::DFGBinding &binding, char const *argName, char const *dataType, int size, const void *val);
 };
 
 #endif
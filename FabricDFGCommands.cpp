@@ -135,6 +135,28 @@ SICALLBACK FabricCanvasOpApply_Execute(CRef &in_ctxt)
       }
     }
 
+    // store the map type of all ports in the DFG ports' meta data, so that dfgTools::GetOperatorPortMapping()
+    // can tell ICE ports apart from XSI ports (this also overwrites the map types stored in the JSON).
+    if (portmap.size())
+    {
+      _opUserData *pud = _opUserData::GetUserData(newOp.GetObjectID());
+      if (  pud
+          && pud->GetBaseInterface())
+      {
+        try
+        {
+          FabricCore::DFGExec exec = pud->GetBaseInterface()->getBinding().getExec();
+          for (int i=0;i<portmap.size();i++)
+            if (exec.haveExecPort(portmap[i].dfgPortName.GetAsciiString()))
+              exec.setExecPortMetadata(portmap[i].dfgPortName.GetAsciiString(), "XSI_mapType", CString((LONG)portmap[i].mapType).GetAsciiString(), false);
+        }
+        catch (FabricCore::Exception e)
+        {
+          feLogError(e.getDesc_cstr() ? e.getDesc_cstr() : "\"\"");
+        }
+      }
+    }
+
     // the reserved ports.
     {
       CStatus returnStatus;
@@ -171,7 +193,7 @@ SICALLBACK FabricCanvasOpApply_Execute(CRef &in_ctxt)
       Application().LogMessage(L"create port group and port for output port \"" + pmap.dfgPortName + L"\"", siInfoMsg);
 
       // get classID for the port.
-      siClassID classID = dfgTools::GetSiClassIdFromResolvedDataType(pmap.dfgPortDataType);
+      siClassID classID = dfgTools::GetSiClassIdFromPortMapping(pmap);
       if (classID == siUnknownClassID)
       { Application().LogMessage(L"The DFG port \"" + pmap.dfgPortName + "\" cannot be exposed as a XSI Port (data type \"" + pmap.dfgPortDataType + "\" not yet supported)" , siWarningMsg);
         continue; }
@@ -194,12 +216,13 @@ SICALLBACK FabricCanvasOpApply_Execute(CRef &in_ctxt)
     {
       _portMapping &pmap = portmap[i];
       if (   pmap.dfgPortType != DFG_PORT_TYPE_IN
-          || pmap.mapType     != DFG_PORT_MAPTYPE_XSI_PORT)
+          || (   pmap.mapType != DFG_PORT_MAPTYPE_XSI_PORT
+              && pmap.mapType != DFG_PORT_MAPTYPE_XSI_ICE_PORT))
         continue;
       Application().LogMessage(L"create port group and port for input port \"" + pmap.dfgPortName + L"\"", siInfoMsg);
 
       // get classID for the port.
-      siClassID classID = dfgTools::GetSiClassIdFromResolvedDataType(pmap.dfgPortDataType);
+      siClassID classID = dfgTools::GetSiClassIdFromPortMapping(pmap);
       if (classID == siUnknownClassID)
       { Application().LogMessage(L"The DFG port \"" + pmap.dfgPortName + "\" cannot be exposed as a XSI Port (data type \"" + pmap.dfgPortDataType + "\" not yet supported)" , siWarningMsg);
         continue; }
@@ -282,7 +305,7 @@ SICALLBACK FabricCanvasOpApply_Execute(CRef &in_ctxt)
               // transfer whatever we can from o to n.
               {
                 // do we have a connected XSI port?
-                if (o.mapType == DFG_PORT_MAPTYPE_XSI_PORT && !o.mapTarget.IsEmpty() && o.dfgPortDataType == n.dfgPortDataType)
+                if ((o.mapType == DFG_PORT_MAPTYPE_XSI_PORT || o.mapType == DFG_PORT_MAPTYPE_XSI_ICE_PORT) && !o.mapTarget.IsEmpty() && o.dfgPortDataType == n.dfgPortDataType)
                 {
                   // find the port group.
                   PortGroup portgroup;
@@ -479,8 +502,9 @@ SICALLBACK FabricCanvasOpConnectPort_Execute(CRef &in_ctxt)
       && pmap.dfgPortType != DFG_PORT_TYPE_OUT)
   { Application().LogMessage(L"port has unsupported type (neither \"In\" nor \"Out\").", siErrorMsg);
     return CStatus::OK; }
-  if (pmap.mapType != DFG_PORT_MAPTYPE_XSI_PORT)
-  { Application().LogMessage(L"selected port Type/Target is not \"XSI Port\".", siErrorMsg);
+  if (   pmap.mapType != DFG_PORT_MAPTYPE_XSI_PORT
+      && pmap.mapType != DFG_PORT_MAPTYPE_XSI_ICE_PORT)
+  { Application().LogMessage(L"selected port Type/Target is neither \"XSI Port\" nor \"XSI ICE Port\".", siErrorMsg);
     return CStatus::OK; }
 
   // find the port group.
@@ -512,7 +536,7 @@ SICALLBACK FabricCanvasOpConnectPort_Execute(CRef &in_ctxt)
   // check/correct target's siClassID and CRef.
   if (targetName != L"")
   {
-    siClassID portClassID = dfgTools::GetSiClassIdFromResolvedDataType(pmap.dfgPortDataType);
+    siClassID portClassID = dfgTools::GetSiClassIdFromPortMapping(pmap);
     if (targetRef.GetClassID() != portClassID)
     {
       bool err = true;
@@ -541,6 +565,20 @@ SICALLBACK FabricCanvasOpConnectPort_Execute(CRef &in_ctxt)
         }
       }
 
+      // point cloud?
+      if (portClassID == siPrimitiveID)
+      {
+        CRef tmp;
+        tmp.Set(targetRef.GetAsText() + L".pointcloud");
+        if (!tmp.IsValid() && pmap.mapType == DFG_PORT_MAPTYPE_XSI_ICE_PORT)
+          tmp.Set(targetRef.GetAsText() + L".polymsh");   // ICE attributes can live on any primitive.
+        if (tmp.IsValid())
+        {
+          targetRef = tmp;
+          err = false;
+        }
+      }
+
       //
       if (err)
       {
@@ -0,0 +1,95 @@
+#include <xsi_application.h>
+#include <xsi_context.h>
+#include <xsi_status.h>
+#include <xsi_pluginregistrar.h>
+#include <xsi_factory.h>
+
+#include <xsi_icenodecontext.h>
+#include <xsi_icenodedef.h>
+#include <xsi_icenode.h>
+#include <xsi_indexset.h>
+#include <xsi_dataarray.h>
+#include <xsi_dataarray2D.h>
+#include <xsi_vector3f.h>
+#include <xsi_color4f.h>
+
+#include "FabricDFGICENodes.h"
+
+#include <limits.h>
+
+using namespace XSI;
+
+enum FabricCanvasGetPerNodeDataIDs
+{
+  FabricCanvasGetPerNodeData_ID_IN_array    = 0,
+  FabricCanvasGetPerNodeData_ID_G_100       = 100,
+  FabricCanvasGetPerNodeData_ID_OUT_value   = 200,
+  FabricCanvasGetPerNodeData_ID_TYPE_CNS    = 400,
+  FabricCanvasGetPerNodeData_ID_UNDEF       = ULONG_MAX
+};
+
+CStatus Register_FabricCanvasGetPerNodeData( PluginRegistrar &in_reg )
+{
+  CStatus st;
+
+  ICENodeDef nodeDef;
+  PluginItem nodeItem;
+
+  int supportedDataTypes = siICENodeDataVector3 | siICENodeDataColor4;
+
+  nodeDef = Application().GetFactory().CreateICENodeDef(L"FabricCanvasGetPerNodeData", L"Fabric Canvas Get Per Node Data");
+
+  st = nodeDef.PutColor(39,168,223);
+  st.AssertSucceeded( ) ;
+
+  st = nodeDef.PutThreadingModel(siICENodeMultiThreading);
+  st.AssertSucceeded( ) ;
+
+  // Add input ports and groups.
+  st = nodeDef.AddPortGroup(FabricCanvasGetPerNodeData_ID_G_100);
+  st.AssertSucceeded( ) ;
+  st = nodeDef.AddInputPort(FabricCanvasGetPerNodeData_ID_IN_array, FabricCanvasGetPerNodeData_ID_G_100, supportedDataTypes, siICENodeStructureArray, siICENodeContextSingleton, L"array", L"array", L"", CValue(), CValue(), FabricCanvasGetPerNodeData_ID_TYPE_CNS, FabricCanvasGetPerNodeData_ID_UNDEF, FabricCanvasGetPerNodeData_ID_UNDEF);
+  st.AssertSucceeded( ) ;
+
+  // Add output ports.
+  st = nodeDef.AddOutputPort(FabricCanvasGetPerNodeData_ID_OUT_value, supportedDataTypes, siICENodeStructureSingle, siICENodeContextComponent0D2D, L"value", L"value", FabricCanvasGetPerNodeData_ID_TYPE_CNS, FabricCanvasGetPerNodeData_ID_UNDEF, FabricCanvasGetPerNodeData_ID_UNDEF);
+  st.AssertSucceeded( ) ;
+
+  nodeItem = in_reg.RegisterICENode(nodeDef);
+  nodeItem.PutCategories(L"Fabric Engine");
+
+  return CStatus::OK;
+}
+
+// copies the values of the batch's polygon nodes from the input array (one value per polygon
+// node), polygon nodes without a value get in_default.
+template <class ARRAY, class ARRAY2D, class T>
+static void FabricCanvasGetPerNodeData_CopyBatch(ICENodeContext &in_ctxt, const T &in_default)
+{
+  ARRAY2D inData2D(in_ctxt, FabricCanvasGetPerNodeData_ID_IN_array);
+  typename ARRAY2D::Accessor inData = inData2D[0];
+  const ULONG numValues = inData.GetCount();
+
+  ARRAY outData(in_ctxt);
+  CIndexSet indexSet(in_ctxt);
+  for (CIndexSet::Iterator it=indexSet.Begin();it.HasNext();it.Next())
+  {
+    const ULONG i = it.GetAbsoluteIndex();
+    if (i < numValues)  outData[it] = inData[i];
+    else                outData[it] = in_default;
+  }
+}
+
+SICALLBACK FabricCanvasGetPerNodeData_Evaluate( ICENodeContext &in_ctxt )
+{
+  XSI::siICENodeDataType dataType;
+  XSI::siICENodeStructureType dataStruct;
+  XSI::siICENodeContextType dataContext;
+  in_ctxt.GetPortInfo(FabricCanvasGetPerNodeData_ID_OUT_value, dataType, dataStruct, dataContext);
+
+  // (the defaults are the ones of the "Fabric Canvas Set ..." compounds).
+  if      (dataType == siICENodeDataVector3)  FabricCanvasGetPerNodeData_CopyBatch<CDataArrayVector3f, CDataArray2DVector3f>(in_ctxt, MATH::CVector3f(0, 0, 0));
+  else if (dataType == siICENodeDataColor4)   FabricCanvasGetPerNodeData_CopyBatch<CDataArrayColor4f,  CDataArray2DColor4f> (in_ctxt, MATH::CColor4f(1, 0, 1, 1));
+
+  return CStatus::OK;
+}
@@ -0,0 +1,12 @@
+#ifndef __FabricDFGICENodes_H_
+#define __FabricDFGICENodes_H_
+
+#include <xsi_pluginregistrar.h>
+#include <xsi_status.h>
+
+// ICE node "FabricCanvasGetPerNodeData": outputs the values of an "array per object" (Vector3 or
+// Color4, one value per polygon node) per polygon node, e.g. the arrays FabricCanvasDataArray*PerNode
+// written by a CanvasOp's PolygonMesh output port (see the "Fabric Canvas Set ... Per Node" compounds).
+extern XSI::CStatus Register_FabricCanvasGetPerNodeData( XSI::PluginRegistrar &in_reg );
+
+#endif
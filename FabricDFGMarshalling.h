@@ -0,0 +1,773 @@
+#ifndef __FabricDFGMarshalling_H_
+#define __FabricDFGMarshalling_H_
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <stdint.h>
+
+// the marshalling of the plain values between a CanvasOp and the arguments of its binding.
+// the functions are written against a backend rather than against FabricCore, so that they
+// can be timed and checked with an in-memory backend without a Fabric Core (see
+// Benchmarks/MarshallingTest.cpp). BaseInterface::GetArgValue*() and SetValueOfArg*() call
+// them with a backend wrapping the binding (see FabricDFGBaseInterface.cpp) and catch the
+// exceptions thrown by it.
+//
+// a backend provides:
+//   typedef ...  Value;                                      a KL value with the getters of FabricCore::RTVal used
+//                                                            below (getBoolean(), ..., getStringCString(), maybeGetMember()).
+//   bool         haveArg         (char const *argName);      true if the binding's executable has the port argName.
+//   std::string  getArgType      (char const *argName);      resolved data type of the port ("" if unresolved).
+//   Value        getArg          (char const *argName);      value of the argument.
+//   void         setArg          (char const *argName, const Value &val);
+//   Value        constructBoolean(bool val);                 and the same for SInt8/16/32/64, UInt8/16/32/64, Float32/64.
+//   Value        constructString (char const *val);
+//   Value        construct       (char const *type, int numMembers, Value *members);
+class dfgMarshalling
+{
+ public:
+
+  // gets the value of an argument (see BaseInterface::GetArgValue*()).
+  // returns: 0 on success, -1 wrong port type, -2 invalid port.
+  template <class BACKEND> static int GetArgValueBoolean(BACKEND &backend, char const *argName, bool                 &out, bool strict = false);
+  template <class BACKEND> static int GetArgValueInteger(BACKEND &backend, char const *argName, int                  &out, bool strict = false);
+  template <class BACKEND> static int GetArgValueFloat  (BACKEND &backend, char const *argName, double               &out, bool strict = false);
+  template <class BACKEND> static int GetArgValueString (BACKEND &backend, char const *argName, std::string          &out, bool strict = false);
+  template <class BACKEND> static int GetArgValueVec2   (BACKEND &backend, char const *argName, std::vector <double> &out, bool strict = false);
+  template <class BACKEND> static int GetArgValueVec3   (BACKEND &backend, char const *argName, std::vector <double> &out, bool strict = false);
+  template <class BACKEND> static int GetArgValueVec4   (BACKEND &backend, char const *argName, std::vector <double> &out, bool strict = false);
+  template <class BACKEND> static int GetArgValueColor  (BACKEND &backend, char const *argName, std::vector <double> &out, bool strict = false);
+  template <class BACKEND> static int GetArgValueRGB    (BACKEND &backend, char const *argName, std::vector <double> &out, bool strict = false);
+  template <class BACKEND> static int GetArgValueRGBA   (BACKEND &backend, char const *argName, std::vector <double> &out, bool strict = false);
+  template <class BACKEND> static int GetArgValueQuat   (BACKEND &backend, char const *argName, std::vector <double> &out, bool strict = false);
+  template <class BACKEND> static int GetArgValueMat44  (BACKEND &backend, char const *argName, std::vector <double> &out, bool strict = false);
+
+  // sets the value of an argument (see BaseInterface::SetValueOfArg*()).
+  // returns: 0 on success, -2 invalid port.
+  template <class BACKEND> static int SetValueOfArgBoolean(BACKEND &backend, char const *argName, const bool                  val);
+  template <class BACKEND> static int SetValueOfArgSInt   (BACKEND &backend, char const *argName, const int32_t               val);
+  template <class BACKEND> static int SetValueOfArgUInt   (BACKEND &backend, char const *argName, const uint32_t              val);
+  template <class BACKEND> static int SetValueOfArgFloat  (BACKEND &backend, char const *argName, const double                val);
+  template <class BACKEND> static int SetValueOfArgString (BACKEND &backend, char const *argName, const std::string          &val);
+  template <class BACKEND> static int SetValueOfArgVec2   (BACKEND &backend, char const *argName, const std::vector <double> &val);
+  template <class BACKEND> static int SetValueOfArgVec3   (BACKEND &backend, char const *argName, const std::vector <double> &val);
+  template <class BACKEND> static int SetValueOfArgVec4   (BACKEND &backend, char const *argName, const std::vector <double> &val);
+  template <class BACKEND> static int SetValueOfArgColor  (BACKEND &backend, char const *argName, const std::vector <double> &val);
+  template <class BACKEND> static int SetValueOfArgRGB    (BACKEND &backend, char const *argName, const std::vector <double> &val);
+  template <class BACKEND> static int SetValueOfArgRGBA   (BACKEND &backend, char const *argName, const std::vector <double> &val);
+  template <class BACKEND> static int SetValueOfArgQuat   (BACKEND &backend, char const *argName, const std::vector <double> &val);
+  template <class BACKEND> static int SetValueOfArgMat44  (BACKEND &backend, char const *argName, const std::vector <double> &val);
+  template <class BACKEND> static int SetValueOfArgXfo    (BACKEND &backend, char const *argName, const std::vector <double> &val);
+
+ private:
+
+  // sets an argument to a struct of N Float32 (Vec2, Vec3, Vec4, Color) or
+  // N UInt8 (RGB, RGBA, the values are then mapped from [0, 1] to [0, 255]).
+  template <class BACKEND, int N> static int SetValueOfArgStruct(BACKEND &backend, char const *argName, char const *type, bool isUInt8, const std::vector <double> &val);
+};
+
+template <class BACKEND> int dfgMarshalling::GetArgValueBoolean(BACKEND &backend, char const *argName, bool &out, bool strict)
+{
+  // init output.
+  out = false;
+
+  // invalid port?
+  if (!backend.haveArg(argName))
+    return -2;
+
+  std::string resolvedType = backend.getArgType(argName);
+  typename BACKEND::Value rtval = backend.getArg(argName);
+
+  if      (resolvedType.length() == 0)    return -1;
+
+  else if (resolvedType == "Boolean")     out = rtval.getBoolean();
+
+  else if (!strict)
+  {
+    if      (resolvedType == "Scalar")    out = (0 != rtval.getFloat32());
+    else if (resolvedType == "Float32")   out = (0 != rtval.getFloat32());
+    else if (resolvedType == "Float64")   out = (0 != rtval.getFloat64());
+
+    else if (resolvedType == "Integer")   out = (0 != rtval.getSInt32());
+    else if (resolvedType == "SInt8")     out = (0 != rtval.getSInt8());
+    else if (resolvedType == "SInt16")    out = (0 != rtval.getSInt16());
+    else if (resolvedType == "SInt32")    out = (0 != rtval.getSInt32());
+    else if (resolvedType == "SInt64")    out = (0 != rtval.getSInt64());
+
+    else if (resolvedType == "Byte")      out = (0 != rtval.getUInt8());
+    else if (resolvedType == "UInt8")     out = (0 != rtval.getUInt8());
+    else if (resolvedType == "UInt16")    out = (0 != rtval.getUInt16());
+    else if (resolvedType == "Count")     out = (0 != rtval.getUInt32());
+    else if (resolvedType == "Index")     out = (0 != rtval.getUInt32());
+    else if (resolvedType == "Size")      out = (0 != rtval.getUInt32());
+    else if (resolvedType == "UInt32")    out = (0 != rtval.getUInt32());
+    else if (resolvedType == "DataSize")  out = (0 != rtval.getUInt64());
+    else if (resolvedType == "UInt64")    out = (0 != rtval.getUInt64());
+
+    else return -1;
+  }
+  else return -1;
+
+  // done.
+  return 0;
+}
+
+template <class BACKEND> int dfgMarshalling::GetArgValueInteger(BACKEND &backend, char const *argName, int &out, bool strict)
+{
+  // init output.
+  out = 0;
+
+  // invalid port?
+  if (!backend.haveArg(argName))
+    return -2;
+
+  std::string resolvedType = backend.getArgType(argName);
+  typename BACKEND::Value rtval = backend.getArg(argName);
+
+  if      (resolvedType.length() == 0)    return -1;
+
+  else if (resolvedType == "Integer")     out = (int)rtval.getSInt32();
+  else if (resolvedType == "SInt8")       out = (int)rtval.getSInt8();
+  else if (resolvedType == "SInt16")      out = (int)rtval.getSInt16();
+  else if (resolvedType == "SInt32")      out = (int)rtval.getSInt32();
+  else if (resolvedType == "SInt64")      out = (int)rtval.getSInt64();
+
+  else if (resolvedType == "Byte")        out = (int)rtval.getUInt8();
+  else if (resolvedType == "UInt8")       out = (int)rtval.getUInt8();
+  else if (resolvedType == "UInt16")      out = (int)rtval.getUInt16();
+  else if (resolvedType == "Count")       out = (int)rtval.getUInt32();
+  else if (resolvedType == "Index")       out = (int)rtval.getUInt32();
+  else if (resolvedType == "Size")        out = (int)rtval.getUInt32();
+  else if (resolvedType == "UInt32")      out = (int)rtval.getUInt32();
+  else if (resolvedType == "DataSize")    out = (int)rtval.getUInt64();
+  else if (resolvedType == "UInt64")      out = (int)rtval.getUInt64();
+
+  else if (!strict)
+  {
+    if      (resolvedType == "Boolean")   out = (int)rtval.getBoolean();
+
+    else if (resolvedType == "Scalar")    out = (int)rtval.getFloat32();
+    else if (resolvedType == "Float32")   out = (int)rtval.getFloat32();
+    else if (resolvedType == "Float64")   out = (int)rtval.getFloat64();
+
+    else return -1;
+  }
+  else return -1;
+
+  // done.
+  return 0;
+}
+
+template <class BACKEND> int dfgMarshalling::GetArgValueFloat(BACKEND &backend, char const *argName, double &out, bool strict)
+{
+  // init output.
+  out = 0;
+
+  // invalid port?
+  if (!backend.haveArg(argName))
+    return -2;
+
+  std::string resolvedType = backend.getArgType(argName);
+  typename BACKEND::Value rtval = backend.getArg(argName);
+
+  if      (resolvedType.length() == 0)    return -1;
+
+  else if (resolvedType == "Scalar")      out = (double)rtval.getFloat32();
+  else if (resolvedType == "Float32")     out = (double)rtval.getFloat32();
+  else if (resolvedType == "Float64")     out = (double)rtval.getFloat64();
+
+  else if (!strict)
+  {
+    if      (resolvedType == "Boolean")   out = (double)rtval.getBoolean();
+
+    else if (resolvedType == "Integer")   out = (double)rtval.getSInt32();
+    else if (resolvedType == "SInt8")     out = (double)rtval.getSInt8();
+    else if (resolvedType == "SInt16")    out = (double)rtval.getSInt16();
+    else if (resolvedType == "SInt32")    out = (double)rtval.getSInt32();
+    else if (resolvedType == "SInt64")    out = (double)rtval.getSInt64();
+
+    else if (resolvedType == "Byte")      out = (double)rtval.getUInt8();
+    else if (resolvedType == "UInt8")     out = (double)rtval.getUInt8();
+    else if (resolvedType == "UInt16")    out = (double)rtval.getUInt16();
+    else if (resolvedType == "Count")     out = (double)rtval.getUInt32();
+    else if (resolvedType == "Index")     out = (double)rtval.getUInt32();
+    else if (resolvedType == "Size")      out = (double)rtval.getUInt32();
+    else if (resolvedType == "UInt32")    out = (double)rtval.getUInt32();
+    else if (resolvedType == "DataSize")  out = (double)rtval.getUInt64();
+    else if (resolvedType == "UInt64")    out = (double)rtval.getUInt64();
+
+    else return -1;
+  }
+  else return -1;
+
+  // done.
+  return 0;
+}
+
+template <class BACKEND> int dfgMarshalling::GetArgValueString(BACKEND &backend, char const *argName, std::string &out, bool strict)
+{
+  // init output.
+  out = "";
+
+  // invalid port?
+  if (!backend.haveArg(argName))
+    return -2;
+
+  std::string resolvedType = backend.getArgType(argName);
+
+  if      (resolvedType.length() == 0)    return -1;
+
+  else if (resolvedType == "String")      out = backend.getArg(argName).getStringCString();
+
+  else if (!strict)
+  {
+    char    s[64];
+    bool    b;
+    int     i;
+    double  f;
+
+    if (GetArgValueBoolean(backend, argName, b, true) == 0)
+    {
+      out = (b ? "true" : "false");
+      return 0;
+    }
+
+    if (GetArgValueInteger(backend, argName, i, true) == 0)
+    {
+      #ifdef _WIN32
+        sprintf_s(s, sizeof(s), "%d", i);
+      #else
+        snprintf(s, sizeof(s), "%d", i);
+      #endif
+      out = s;
+      return 0;
+    }
+
+    if (GetArgValueFloat(backend, argName, f, true) == 0)
+    {
+      #ifdef _WIN32
+        sprintf_s(s, sizeof(s), "%f", f);
+      #else
+        snprintf(s, sizeof(s), "%f", f);
+      #endif
+      out = s;
+      return 0;
+    }
+
+    return -1;
+  }
+  else
+    return -1;
+
+  // done.
+  return 0;
+}
+
+template <class BACKEND> int dfgMarshalling::GetArgValueVec2(BACKEND &backend, char const *argName, std::vector <double> &out, bool /*strict*/)
+{
+  // init output.
+  out.clear();
+
+  // invalid port?
+  if (!backend.haveArg(argName))
+    return -2;
+
+  std::string resolvedType = backend.getArgType(argName);
+  typename BACKEND::Value rtval = backend.getArg(argName);
+
+  if      (resolvedType.length() == 0)      return -1;
+
+  else if (resolvedType == "Vec2")        {
+                                            out.reserve(2);
+                                            out.push_back(rtval.maybeGetMember("x").getFloat32());
+                                            out.push_back(rtval.maybeGetMember("y").getFloat32());
+                                          }
+  else
+    return -1;
+
+  // done.
+  return 0;
+}
+
+template <class BACKEND> int dfgMarshalling::GetArgValueVec3(BACKEND &backend, char const *argName, std::vector <double> &out, bool strict)
+{
+  // init output.
+  out.clear();
+
+  // invalid port?
+  if (!backend.haveArg(argName))
+    return -2;
+
+  std::string resolvedType = backend.getArgType(argName);
+  typename BACKEND::Value rtval = backend.getArg(argName);
+
+  if      (resolvedType.length() == 0)      return -1;
+
+  else if (resolvedType == "Vec3")        {
+                                            out.reserve(3);
+                                            out.push_back(rtval.maybeGetMember("x").getFloat32());
+                                            out.push_back(rtval.maybeGetMember("y").getFloat32());
+                                            out.push_back(rtval.maybeGetMember("z").getFloat32());
+                                          }
+  else if (!strict)
+  {
+      if      (resolvedType == "Color")   {
+                                            out.reserve(3);
+                                            out.push_back(rtval.maybeGetMember("r").getFloat32());
+                                            out.push_back(rtval.maybeGetMember("g").getFloat32());
+                                            out.push_back(rtval.maybeGetMember("b").getFloat32());
+                                          }
+      else if (resolvedType == "Vec4")    {
+                                            out.reserve(3);
+                                            out.push_back(rtval.maybeGetMember("x").getFloat32());
+                                            out.push_back(rtval.maybeGetMember("y").getFloat32());
+                                            out.push_back(rtval.maybeGetMember("z").getFloat32());
+                                          }
+      else
+        return -1;
+  }
+
+  // done.
+  return 0;
+}
+
+template <class BACKEND> int dfgMarshalling::GetArgValueVec4(BACKEND &backend, char const *argName, std::vector <double> &out, bool strict)
+{
+  // init output.
+  out.clear();
+
+  // invalid port?
+  if (!backend.haveArg(argName))
+    return -2;
+
+  std::string resolvedType = backend.getArgType(argName);
+  typename BACKEND::Value rtval = backend.getArg(argName);
+
+  if      (resolvedType.length() == 0)      return -1;
+
+  else if (resolvedType == "Vec4")        {
+                                            out.reserve(4);
+                                            out.push_back(rtval.maybeGetMember("x").getFloat32());
+                                            out.push_back(rtval.maybeGetMember("y").getFloat32());
+                                            out.push_back(rtval.maybeGetMember("z").getFloat32());
+                                            out.push_back(rtval.maybeGetMember("t").getFloat32());
+                                          }
+  else if (!strict)
+  {
+      if      (resolvedType == "Color")   {
+                                            out.reserve(4);
+                                            out.push_back(rtval.maybeGetMember("r").getFloat32());
+                                            out.push_back(rtval.maybeGetMember("g").getFloat32());
+                                            out.push_back(rtval.maybeGetMember("b").getFloat32());
+                                            out.push_back(rtval.maybeGetMember("a").getFloat32());
+                                          }
+      else
+        return -1;
+  }
+
+  // done.
+  return 0;
+}
+
+template <class BACKEND> int dfgMarshalling::GetArgValueColor(BACKEND &backend, char const *argName, std::vector <double> &out, bool strict)
+{
+  // init output.
+  out.clear();
+
+  // invalid port?
+  if (!backend.haveArg(argName))
+    return -2;
+
+  std::string resolvedType = backend.getArgType(argName);
+  typename BACKEND::Value rtval = backend.getArg(argName);
+
+  if      (resolvedType.length() == 0)      return -1;
+
+  else if (resolvedType == "Color")      {
+                                            out.reserve(4);
+                                            out.push_back(rtval.maybeGetMember("r").getFloat32());
+                                            out.push_back(rtval.maybeGetMember("g").getFloat32());
+                                            out.push_back(rtval.maybeGetMember("b").getFloat32());
+                                            out.push_back(rtval.maybeGetMember("a").getFloat32());
+                                         }
+  else if (!strict)
+  {
+      if      (resolvedType == "Vec4")   {
+                                            out.reserve(4);
+                                            out.push_back(rtval.maybeGetMember("x").getFloat32());
+                                            out.push_back(rtval.maybeGetMember("y").getFloat32());
+                                            out.push_back(rtval.maybeGetMember("z").getFloat32());
+                                            out.push_back(rtval.maybeGetMember("t").getFloat32());
+                                          }
+      else if (resolvedType == "RGB")     {
+                                            out.reserve(4);
+                                            out.push_back(rtval.maybeGetMember("r").getUInt8() / 255.0);
+                                            out.push_back(rtval.maybeGetMember("g").getUInt8() / 255.0);
+                                            out.push_back(rtval.maybeGetMember("b").getUInt8() / 255.0);
+                                            out.push_back(1);
+                                          }
+      else if (resolvedType == "RGBA")    {
+                                            out.reserve(4);
+                                            out.push_back(rtval.maybeGetMember("r").getUInt8() / 255.0);
+                                            out.push_back(rtval.maybeGetMember("g").getUInt8() / 255.0);
+                                            out.push_back(rtval.maybeGetMember("b").getUInt8() / 255.0);
+                                            out.push_back(rtval.maybeGetMember("a").getUInt8() / 255.0);
+                                          }
+      else
+        return -1;
+  }
+
+  // done.
+  return 0;
+}
+
+template <class BACKEND> int dfgMarshalling::GetArgValueRGB(BACKEND &backend, char const *argName, std::vector <double> &out, bool strict)
+{
+  // init output.
+  out.clear();
+
+  // invalid port?
+  if (!backend.haveArg(argName))
+    return -2;
+
+  std::string resolvedType = backend.getArgType(argName);
+  typename BACKEND::Value rtval = backend.getArg(argName);
+
+  if      (resolvedType.length() == 0)    return -1;
+
+  else if (resolvedType == "RGB")       {
+                                          out.reserve(3);
+                                          out.push_back(rtval.maybeGetMember("r").getUInt8() / 255.0);
+                                          out.push_back(rtval.maybeGetMember("g").getUInt8() / 255.0);
+                                          out.push_back(rtval.maybeGetMember("b").getUInt8() / 255.0);
+                                        }
+  else if (!strict)
+  {
+    if      (resolvedType == "RGBA")    {
+                                          out.reserve(3);
+                                          out.push_back(rtval.maybeGetMember("r").getUInt8() / 255.0);
+                                          out.push_back(rtval.maybeGetMember("g").getUInt8() / 255.0);
+                                          out.push_back(rtval.maybeGetMember("b").getUInt8() / 255.0);
+                                        }
+    else if (resolvedType == "Color")   {
+                                          out.reserve(3);
+                                          out.push_back(rtval.maybeGetMember("r").getFloat32());
+                                          out.push_back(rtval.maybeGetMember("g").getFloat32());
+                                          out.push_back(rtval.maybeGetMember("b").getFloat32());
+                                        }
+    else
+      return -1;
+  }
+
+  // done.
+  return 0;
+}
+
+template <class BACKEND> int dfgMarshalling::GetArgValueRGBA(BACKEND &backend, char const *argName, std::vector <double> &out, bool strict)
+{
+  // init output.
+  out.clear();
+
+  // invalid port?
+  if (!backend.haveArg(argName))
+    return -2;
+
+  std::string resolvedType = backend.getArgType(argName);
+  typename BACKEND::Value rtval = backend.getArg(argName);
+
+  if      (resolvedType.length() == 0)      return -1;
+
+  else if (resolvedType == "RGBA")        {
+                                            out.reserve(4);
+                                            out.push_back(rtval.maybeGetMember("r").getUInt8() / 255.0);
+                                            out.push_back(rtval.maybeGetMember("g").getUInt8() / 255.0);
+                                            out.push_back(rtval.maybeGetMember("b").getUInt8() / 255.0);
+                                            out.push_back(rtval.maybeGetMember("a").getUInt8() / 255.0);
+                                          }
+  else if (!strict)
+  {
+      if      (resolvedType == "RGB")     {
+                                            out.reserve(4);
+                                            out.push_back(rtval.maybeGetMember("r").getUInt8() / 255.0);
+                                            out.push_back(rtval.maybeGetMember("g").getUInt8() / 255.0);
+                                            out.push_back(rtval.maybeGetMember("b").getUInt8() / 255.0);
+                                            out.push_back(1);
+                                          }
+      else if (resolvedType == "Color")   {
+                                            out.reserve(4);
+                                            out.push_back(rtval.maybeGetMember("r").getFloat32());
+                                            out.push_back(rtval.maybeGetMember("g").getFloat32());
+                                            out.push_back(rtval.maybeGetMember("b").getFloat32());
+                                            out.push_back(rtval.maybeGetMember("a").getFloat32());
+                                          }
+      else
+        return -1;
+  }
+
+  // done.
+  return 0;
+}
+
+template <class BACKEND> int dfgMarshalling::GetArgValueQuat(BACKEND &backend, char const *argName, std::vector <double> &out, bool /*strict*/)
+{
+  // init output.
+  out.clear();
+
+  // invalid port?
+  if (!backend.haveArg(argName))
+    return -2;
+
+  std::string resolvedType = backend.getArgType(argName);
+  typename BACKEND::Value rtval = backend.getArg(argName);
+
+  if      (resolvedType.length() == 0)      return -1;
+
+  else if (resolvedType == "Quat")        {
+                                            typename BACKEND::Value v = rtval.maybeGetMember("v");
+                                            out.reserve(4);
+                                            out.push_back(v.    maybeGetMember("x").getFloat32());
+                                            out.push_back(v.    maybeGetMember("y").getFloat32());
+                                            out.push_back(v.    maybeGetMember("z").getFloat32());
+                                            out.push_back(rtval.maybeGetMember("w").getFloat32());
+                                          }
+  else
+    return -1;
+
+  // done.
+  return 0;
+}
+
+template <class BACKEND> int dfgMarshalling::GetArgValueMat44(BACKEND &backend, char const *argName, std::vector <double> &out, bool /*strict*/)
+{
+  // init output.
+  out.clear();
+
+  // invalid port?
+  if (!backend.haveArg(argName))
+    return -2;
+
+  std::string resolvedType = backend.getArgType(argName);
+  typename BACKEND::Value rtval = backend.getArg(argName);
+
+  if      (resolvedType.length() == 0)      return -1;
+
+  else if (resolvedType == "Mat44")       {
+                                            static const char *rows[4] = { "row0", "row1", "row2", "row3" };
+                                            out.reserve(16);
+                                            for (int i = 0; i < 4; i++)
+                                            {
+                                              typename BACKEND::Value rtRow = rtval.maybeGetMember(rows[i]);
+                                              out.push_back(rtRow.maybeGetMember("x").getFloat32());
+                                              out.push_back(rtRow.maybeGetMember("y").getFloat32());
+                                              out.push_back(rtRow.maybeGetMember("z").getFloat32());
+                                              out.push_back(rtRow.maybeGetMember("t").getFloat32());
+                                            }
+                                          }
+  else if (resolvedType == "Xfo")         {
+                                            // scaling, orientation (w, x, y, z), translation.
+                                            typename BACKEND::Value sc  = rtval.maybeGetMember("sc");
+                                            typename BACKEND::Value ori = rtval.maybeGetMember("ori");
+                                            typename BACKEND::Value v   = ori.  maybeGetMember("v");
+                                            typename BACKEND::Value tr  = rtval.maybeGetMember("tr");
+                                            out.reserve(10);
+                                            out.push_back(sc. maybeGetMember("x").getFloat32());
+                                            out.push_back(sc. maybeGetMember("y").getFloat32());
+                                            out.push_back(sc. maybeGetMember("z").getFloat32());
+                                            out.push_back(ori.maybeGetMember("w").getFloat32());
+                                            out.push_back(v.  maybeGetMember("x").getFloat32());
+                                            out.push_back(v.  maybeGetMember("y").getFloat32());
+                                            out.push_back(v.  maybeGetMember("z").getFloat32());
+                                            out.push_back(tr. maybeGetMember("x").getFloat32());
+                                            out.push_back(tr. maybeGetMember("y").getFloat32());
+                                            out.push_back(tr. maybeGetMember("z").getFloat32());
+                                          }
+  else
+    return -1;
+
+  // done.
+  return 0;
+}
+
+template <class BACKEND> int dfgMarshalling::SetValueOfArgBoolean(BACKEND &backend, char const *argName, const bool val)
+{
+  if (!backend.haveArg(argName))
+    return -2;
+
+  backend.setArg(argName, backend.constructBoolean(val));
+  return 0;
+}
+
+template <class BACKEND> int dfgMarshalling::SetValueOfArgSInt(BACKEND &backend, char const *argName, const int32_t val)
+{
+  if (!backend.haveArg(argName))
+    return -2;
+
+  typename BACKEND::Value rtval;
+  std::string resolvedType = backend.getArgType(argName);
+  if      (resolvedType == "Integer") rtval = backend.constructSInt32(val);
+  else if (resolvedType == "SInt8")   rtval = backend.constructSInt8 (val);
+  else if (resolvedType == "SInt16")  rtval = backend.constructSInt16(val);
+  else if (resolvedType == "SInt32")  rtval = backend.constructSInt32(val);
+  else if (resolvedType == "SInt64")  rtval = backend.constructSInt64(val);
+  backend.setArg(argName, rtval);
+  return 0;
+}
+
+template <class BACKEND> int dfgMarshalling::SetValueOfArgUInt(BACKEND &backend, char const *argName, const uint32_t val)
+{
+  if (!backend.haveArg(argName))
+    return -2;
+
+  typename BACKEND::Value rtval;
+  std::string resolvedType = backend.getArgType(argName);
+  if      (resolvedType == "Byte")      rtval = backend.constructUInt8 (val);
+  else if (resolvedType == "UInt8")     rtval = backend.constructUInt8 (val);
+  else if (resolvedType == "UInt16")    rtval = backend.constructUInt16(val);
+  else if (resolvedType == "Count")     rtval = backend.constructUInt32(val);
+  else if (resolvedType == "Index")     rtval = backend.constructUInt32(val);
+  else if (resolvedType == "Size")      rtval = backend.constructUInt32(val);
+  else if (resolvedType == "UInt32")    rtval = backend.constructUInt32(val);
+  else if (resolvedType == "DataSize")  rtval = backend.constructUInt64(val);
+  else if (resolvedType == "UInt64")    rtval = backend.constructUInt64(val);
+  backend.setArg(argName, rtval);
+  return 0;
+}
+
+template <class BACKEND> int dfgMarshalling::SetValueOfArgFloat(BACKEND &backend, char const *argName, const double val)
+{
+  if (!backend.haveArg(argName))
+    return -2;
+
+  typename BACKEND::Value rtval;
+  std::string resolvedType = backend.getArgType(argName);
+  if      (resolvedType == "Scalar")  rtval = backend.constructFloat32((float)val);
+  else if (resolvedType == "Float32") rtval = backend.constructFloat32((float)val);
+  else if (resolvedType == "Float64") rtval = backend.constructFloat64(val);
+  backend.setArg(argName, rtval);
+  return 0;
+}
+
+template <class BACKEND> int dfgMarshalling::SetValueOfArgString(BACKEND &backend, char const *argName, const std::string &val)
+{
+  if (!backend.haveArg(argName))
+    return -2;
+
+  backend.setArg(argName, backend.constructString(val.c_str()));
+  return 0;
+}
+
+template <class BACKEND, int N> int dfgMarshalling::SetValueOfArgStruct(BACKEND &backend, char const *argName, char const *type, bool isUInt8, const std::vector <double> &val)
+{
+  if (!backend.haveArg(argName))
+    return -2;
+
+  typename BACKEND::Value v[N];
+  const bool valIsValid = (val.size() >= N);
+  for (int i = 0; i < N; i++)
+  {
+    if (isUInt8)  v[i] = backend.constructUInt8  (valIsValid ? (uint8_t)std::max(0.0, std::min(255.0, 255.0 * val[i])) : 0);
+    else          v[i] = backend.constructFloat32(valIsValid ? (float)val[i] : 0);
+  }
+  backend.setArg(argName, backend.construct(type, N, v));
+  return 0;
+}
+
+template <class BACKEND> int dfgMarshalling::SetValueOfArgVec2(BACKEND &backend, char const *argName, const std::vector <double> &val)
+{
+  return SetValueOfArgStruct<BACKEND, 2>(backend, argName, "Vec2", false, val);
+}
+
+template <class BACKEND> int dfgMarshalling::SetValueOfArgVec3(BACKEND &backend, char const *argName, const std::vector <double> &val)
+{
+  return SetValueOfArgStruct<BACKEND, 3>(backend, argName, "Vec3", false, val);
+}
+
+template <class BACKEND> int dfgMarshalling::SetValueOfArgVec4(BACKEND &backend, char const *argName, const std::vector <double> &val)
+{
+  return SetValueOfArgStruct<BACKEND, 4>(backend, argName, "Vec4", false, val);
+}
+
+template <class BACKEND> int dfgMarshalling::SetValueOfArgColor(BACKEND &backend, char const *argName, const std::vector <double> &val)
+{
+  return SetValueOfArgStruct<BACKEND, 4>(backend, argName, "Color", false, val);
+}
+
+template <class BACKEND> int dfgMarshalling::SetValueOfArgRGB(BACKEND &backend, char const *argName, const std::vector <double> &val)
+{
+  return SetValueOfArgStruct<BACKEND, 3>(backend, argName, "RGB", true, val);
+}
+
+template <class BACKEND> int dfgMarshalling::SetValueOfArgRGBA(BACKEND &backend, char const *argName, const std::vector <double> &val)
+{
+  return SetValueOfArgStruct<BACKEND, 4>(backend, argName, "RGBA", true, val);
+}
+
+template <class BACKEND> int dfgMarshalling::SetValueOfArgQuat(BACKEND &backend, char const *argName, const std::vector <double> &val)
+{
+  if (!backend.haveArg(argName))
+    return -2;
+
+  typename BACKEND::Value xyz[3], v[2];
+  const bool valIsValid = (val.size() >= 4);
+  xyz[0] = backend.constructFloat32(valIsValid ? (float)val[0] : 0);
+  xyz[1] = backend.constructFloat32(valIsValid ? (float)val[1] : 0);
+  xyz[2] = backend.constructFloat32(valIsValid ? (float)val[2] : 0);
+  v[0]   = backend.construct("Vec3", 3, xyz);
+  v[1]   = backend.constructFloat32(valIsValid ? (float)val[3] : 0);
+  backend.setArg(argName, backend.construct("Quat", 2, v));
+  return 0;
+}
+
+template <class BACKEND> int dfgMarshalling::SetValueOfArgMat44(BACKEND &backend, char const *argName, const std::vector <double> &val)
+{
+  if (!backend.haveArg(argName))
+    return -2;
+
+  typename BACKEND::Value xyzt[4], v[4];
+  const bool valIsValid = (val.size() >= 16);
+  for (int i = 0; i < 4; i++)
+  {
+    int offset = i * 4;
+    xyzt[0] = backend.constructFloat32(valIsValid ? (float)val[offset + 0] : 0);
+    xyzt[1] = backend.constructFloat32(valIsValid ? (float)val[offset + 1] : 0);
+    xyzt[2] = backend.constructFloat32(valIsValid ? (float)val[offset + 2] : 0);
+    xyzt[3] = backend.constructFloat32(valIsValid ? (float)val[offset + 3] : 0);
+    v[i]    = backend.construct("Vec4", 4, xyzt);
+  }
+  backend.setArg(argName, backend.construct("Mat44", 4, v));
+  return 0;
+}
+
+template <class BACKEND> int dfgMarshalling::SetValueOfArgXfo(BACKEND &backend, char const *argName, const std::vector <double> &val)
+{
+  if (!backend.haveArg(argName))
+    return -2;
+
+  // val: scaling, orientation (w, x, y, z), translation.
+  typename BACKEND::Value sc[3], xyz[3], ori[2], tr[3], xfo[3];
+  const bool valIsValid = (val.size() >= 10);
+
+  xyz[0] = backend.constructFloat32(valIsValid ? (float)val[4] : 0);
+  xyz[1] = backend.constructFloat32(valIsValid ? (float)val[5] : 0);
+  xyz[2] = backend.constructFloat32(valIsValid ? (float)val[6] : 0);
+  ori[0] = backend.construct("Vec3", 3, xyz);
+  ori[1] = backend.constructFloat32(valIsValid ? (float)val[3] : 1);
+
+  tr[0]  = backend.constructFloat32(valIsValid ? (float)val[7] : 0);
+  tr[1]  = backend.constructFloat32(valIsValid ? (float)val[8] : 0);
+  tr[2]  = backend.constructFloat32(valIsValid ? (float)val[9] : 0);
+
+  sc[0]  = backend.constructFloat32(valIsValid ? (float)val[0] : 1);
+  sc[1]  = backend.constructFloat32(valIsValid ? (float)val[1] : 1);
+  sc[2]  = backend.constructFloat32(valIsValid ? (float)val[2] : 1);
+
+  xfo[0] = backend.construct("Quat", 2, ori);
+  xfo[1] = backend.construct("Vec3", 3, tr);
+  xfo[2] = backend.construct("Vec3", 3, sc);
+
+  backend.setArg(argName, backend.construct("Xfo", 3, xfo));
+  return 0;
+}
+
+#endif
@@ -35,11 +35,13 @@
 #include <xsi_value.h>
 #include <xsi_matrix4f.h>
 #include <xsi_primitive.h>
+#include <xsi_projectitem.h>
 #include <xsi_expression.h>
 #include <xsi_iceattribute.h>
 #include <xsi_iceattributedataarray.h>
 #include <xsi_iceattributedataarray2D.h>
 #include <xsi_color4f.h>
+#include <xsi_time.h>
 
 #include "plugin.h"
 #include "FabricDFGPlugin.h"
@@ -47,6 +49,8 @@
 #include "FabricDFGBaseInterface.h"
 #include "FabricDFGTools.h"
 #include "FabricDFGWidget.h"
+#include "FabricProfiler.h"
+#include "FabricSpliceConversion.h"
 #include <Persistence/RTValToJSONEncoder.hpp>
 
 std::map <unsigned int, _opUserData *>  _opUserData::s_instances;
@@ -318,7 +322,10 @@ int CanvasOp_UpdateGridData_dfgPorts(CustomOperator &op)
                                              if (pmap[i].mapTarget.IsEmpty())  target += "  ( - )";
                                              else                              target += L" ( -> " + pmap[i].mapTarget + L" )";
                                            }                             break;
-      case DFG_PORT_MAPTYPE_XSI_ICE_PORT:    target = L"XSI ICE Port";   break;
+      case DFG_PORT_MAPTYPE_XSI_ICE_PORT:  { target = L"XSI ICE Port";
+                                             if (pmap[i].mapTarget.IsEmpty())  target += "  ( - )";
+                                             else                              target += L" ( -> " + pmap[i].mapTarget + L" )";
+                                           }                             break;
       default:                               target = L"unknown";        break;
     }
     
@@ -691,6 +698,10 @@ XSIPLUGINCALLBACK CStatus CanvasOp_PPGEvent(const CRef &in_ctxt)
   // process event.
   if (eventID == PPGEventContext::siOnInit)
   {
+    // the Canvas editor is likely to be opened next, so we start populating
+    // the KL AST manager (used for code completion) in the background.
+    BaseInterface::preloadManager();
+
     PPGLayout oLayout = op.GetPPGLayout();
     CanvasOp_DefineLayout(oLayout, op);
     ctxt.PutAttribute(L"Refresh", true);
@@ -862,8 +873,9 @@ XSIPLUGINCALLBACK CStatus CanvasOp_PPGEvent(const CRef &in_ctxt)
           && pmap.dfgPortType != DFG_PORT_TYPE_OUT)
       { toolkit.MsgBox(L"Selected port has unsupported type (neither \"In\" nor \"Out\").", siMsgOkOnly | siMsgExclamation, "CanvasOp", ret);
         return CStatus::OK; }
-      if (pmap.mapType != DFG_PORT_MAPTYPE_XSI_PORT)
-      { toolkit.MsgBox(L"Selected port Type/Target is not \"XSI Port\".", siMsgOkOnly, "CanvasOp", ret);
+      if (   pmap.mapType != DFG_PORT_MAPTYPE_XSI_PORT
+          && pmap.mapType != DFG_PORT_MAPTYPE_XSI_ICE_PORT)
+      { toolkit.MsgBox(L"Selected port Type/Target is neither \"XSI Port\" nor \"XSI ICE Port\".", siMsgOkOnly, "CanvasOp", ret);
         return CStatus::OK; }
 
       // find the port group.
@@ -910,7 +922,7 @@ XSIPLUGINCALLBACK CStatus CanvasOp_PPGEvent(const CRef &in_ctxt)
       if (   btnName == L"BtnPortConnectPick"
           || btnName == L"BtnPortConnectSelf")
       {
-        siClassID portClassID = dfgTools::GetSiClassIdFromResolvedDataType(pmap.dfgPortDataType);
+        siClassID portClassID = dfgTools::GetSiClassIdFromPortMapping(pmap);
         if (targetRef.GetClassID() != portClassID)
         {
           bool err = true;
@@ -939,6 +951,20 @@ XSIPLUGINCALLBACK CStatus CanvasOp_PPGEvent(const CRef &in_ctxt)
             }
           }
 
+          // point cloud?
+          if (portClassID == siPrimitiveID)
+          {
+            CRef tmp;
+            tmp.Set(targetRef.GetAsText() + L".pointcloud");
+            if (!tmp.IsValid() && pmap.mapType == DFG_PORT_MAPTYPE_XSI_ICE_PORT)
+              tmp.Set(targetRef.GetAsText() + L".polymsh");   // ICE attributes can live on any primitive.
+            if (tmp.IsValid())
+            {
+              targetRef = tmp;
+              err = false;
+            }
+          }
+
           //
           if (err)
           {
@@ -1256,6 +1282,12 @@ XSIPLUGINCALLBACK CStatus CanvasOp_Update(CRef &in_ctxt)
   FabricCore::DFGBinding                           binding        = pud->GetBaseInterface()->getBinding();
   FabricCore::DFGExec                              exec           = binding.getExec();
 
+  // profiling.
+  const double profilerFrame = (FabricProfiler::isEnabled() ? ctxt.GetTime().GetTime(CTime::Frames) : 0);
+  FabricTraceScope traceScope("CanvasOp_Update", op.GetObjectID(), profilerFrame);
+  if (!pud->execFabricStep12 && FabricProfiler::isEnabled())
+    FabricProfiler::recordSkipped(op.GetObjectID(), profilerFrame);
+
   // Fabric Engine (step 1): loop through all the DFG's input ports and set
   //                         their values from the matching XSI ports or parameters.
   if (pud->execFabricStep12)
@@ -1274,6 +1306,16 @@ XSIPLUGINCALLBACK CStatus CanvasOp_Update(CRef &in_ctxt)
         CString portName = exec.getExecPortName(i);
         CString portResolvedType = exec.getExecPortResolvedType(i);
         bool storable = true;
+        FabricProfilerScope profilerScope(op.GetObjectID(), profilerFrame, FabricProfiler::EventKind_InputTransfer, portName.GetAsciiString());
+        if (FabricProfiler::isEnabled())
+        {
+          // (array ports transferred below set the amount of bytes they actually transferred).
+          std::string profilerType = portResolvedType.GetAsciiString();
+          size_t arraySize = 0;
+          if (FabricProfiler::isArrayDataType(profilerType))
+            arraySize = binding.getArgValue(portName.GetAsciiString()).getArraySize();
+          profilerScope.setBytes(FabricProfiler::getDataTypeBytes(profilerType, arraySize));
+        }
 
         // find a matching XSI port.
         if (!done)
@@ -1289,6 +1331,55 @@ XSIPLUGINCALLBACK CStatus CanvasOp_Update(CRef &in_ctxt)
             {
               // do nothing.
             }
+            else if (   xsiPortValue.m_t == CValue::siRef
+                     && CRef(xsiPortValue).GetClassID() == siPrimitiveID
+                     && _portMapping::isICEPortDataType(portResolvedType))
+            {
+              // ICE port: the DFG port references the values of the ICE attribute named like
+              // the port (or as set in the port's "XSI_iceAttribute" metadata) as an external array.
+              Primitive prim(xsiPortValue);
+              CString iceAttrName = exec.getExecPortMetadata(portName.GetAsciiString(), "XSI_iceAttribute");
+              if (iceAttrName.IsEmpty())
+                iceAttrName = portName;
+              ICEAttribute iceAttr = prim.GetGeometry().GetICEAttributeFromName(iceAttrName);
+              if (!iceAttr.IsValid())
+              {
+                Application().LogMessage(L"ERROR: failed to get the ICE attribute \"" + iceAttrName + L"\" from \"" + CRef(xsiPortValue).GetAsText() + L"\"", siWarningMsg);
+              }
+              else
+              {
+                std::string elementType = portResolvedType.GetSubString(0, portResolvedType.Length() - 2).GetAsciiString();
+                _opUserData::_iceAttributePort &iceAttrPort = pud->iceAttributePorts[portName.GetAsciiString()];
+
+                // the primitive's evaluation ID changes with anything on the geometry,
+                // so we compare the content of the attribute itself.
+                unsigned long long hash = getICEAttributeHash(iceAttr);
+                bool changed = (hash == 0 || hash != iceAttrPort.hash);
+
+                const void   *data  = NULL;
+                unsigned int  count = 0;
+                if (!getICEAttributeExternalArray(iceAttr, elementType, data, count, iceAttrPort.buffer, changed))
+                {
+                  Application().LogMessage(L"ERROR: the ICE attribute \"" + iceAttrName + L"\" does not match the data type \"" + portResolvedType + L"\" of the port \"" + portName + L"\"", siWarningMsg);
+                }
+                else if (   changed
+                         || data  != iceAttrPort.data
+                         || count != iceAttrPort.count
+                         || binding.getArgValue(portName.GetAsciiString()).getArraySize() != count)  // the graph was reset since.
+                {
+                  BaseInterface::SetValueOfArgExternalArray(*client, binding, portName.GetAsciiString(), elementType.c_str(), count, data);
+                  iceAttrPort.hash  = hash;
+                  iceAttrPort.data  = data;
+                  iceAttrPort.count = count;
+                  profilerScope.setBytes(count * FabricProfiler::getDataTypeBytes(elementType));
+                }
+                else
+                {
+                  profilerScope.setBytes(0);
+                }
+              }
+              storable = false;
+            }
             else if (portResolvedType == L"Mat44")
             {
               if (xsiPortValue.m_t == CValue::siRef)
@@ -1376,6 +1467,12 @@ XSIPLUGINCALLBACK CStatus CanvasOp_Update(CRef &in_ctxt)
 
                     // set the DFG port from val.
                     BaseInterface::SetValueOfArgPolygonMesh(*client, binding, portName.GetAsciiString(), val);
+                    profilerScope.setBytes(  val.vertPositions  .size() * sizeof(float)
+                                           + val.polyNumVertices.size() * sizeof(uint32_t)
+                                           + val.polyVertices   .size() * sizeof(uint32_t)
+                                           + val.polyNodeNormals.size() * sizeof(float)
+                                           + val.polyNodeUVWs   .size() * sizeof(float)
+                                           + val.polyNodeColors .size() * sizeof(float));
                   }
                   else
                   {
@@ -1386,6 +1483,32 @@ XSIPLUGINCALLBACK CStatus CanvasOp_Update(CRef &in_ctxt)
               }
               storable = false;
             }
+            else if (portResolvedType == L"Points")
+            {
+              if (xsiPortValue.m_t == CValue::siRef)
+              {
+                Primitive prim(xsiPortValue);
+                if (prim.IsValid() && pud->pointCloudEvalIDs[portName.GetAsciiString()] == ProjectItem(prim).GetEvaluationID())
+                {
+                  // the point cloud didn't change since the port was last set.
+                  profilerScope.setBytes(0);
+                }
+                else if (prim.IsValid())
+                {
+                  // a single evaluation ID check covers all the attributes of the point cloud.
+                  pud->pointCloudEvalIDs[portName.GetAsciiString()] = ProjectItem(prim).GetEvaluationID();
+
+                  // the custom ICE attributes to transfer are listed in the port's "XSI_iceAttributes" metadata.
+                  CString iceAttrNames = exec.getExecPortMetadata(portName.GetAsciiString(), "XSI_iceAttributes");
+                  FabricCore::RTVal rtval = binding.getArgValue(portName.GetAsciiString());
+                  convertInputPointCloud(prim.GetGeometry(), rtval, iceAttrNames);
+                  binding.setArgValue(portName.GetAsciiString(), rtval, false);
+                  profilerScope.stop();
+                  profilerScope.setBytes(FabricProfiler::getGeometryBytes(rtval));
+                }
+              }
+              storable = false;
+            }
             else if (portResolvedType == L"Float64<>")
             {
               if (xsiPortValue.m_t == CValue::siRef)
@@ -1395,6 +1518,7 @@ XSIPLUGINCALLBACK CStatus CanvasOp_Update(CRef &in_ctxt)
                 {
                   CClusterPropertyElementArray clsPropElem(clsProp.GetElements());
                   BaseInterface::SetValueOfArgFloat64Array(*client, binding, portName.GetAsciiString(), clsPropElem.GetCount(), &clsPropElem.GetArray()[0]);
+                  profilerScope.setBytes(clsPropElem.GetCount() * sizeof(double));
                 }
               }
               else
@@ -1413,6 +1537,7 @@ XSIPLUGINCALLBACK CStatus CanvasOp_Update(CRef &in_ctxt)
                   CFloatArray values;
                   clsProp.GetValues(values);
                   BaseInterface::SetValueOfArgVec3Array(*client, binding, portName.GetAsciiString(), clsPropElem.GetCount(), &values[0]);
+                  profilerScope.setBytes(clsPropElem.GetCount() * 3 * sizeof(float));
                 }
               }
               else
@@ -1504,6 +1629,7 @@ XSIPLUGINCALLBACK CStatus CanvasOp_Update(CRef &in_ctxt)
     pud->execFabricStep12 = false;
     try
     {
+      FabricProfilerScope profilerScope(op.GetObjectID(), profilerFrame, FabricProfiler::EventKind_Execute);
       binding.execute();
     }
     catch (FabricCore::Exception e)
@@ -1517,6 +1643,7 @@ XSIPLUGINCALLBACK CStatus CanvasOp_Update(CRef &in_ctxt)
   {
     CString portName = outputPort.GetName();
     FabricCore::DFGExec exec = binding.getExec();
+    FabricProfilerScope profilerScope(op.GetObjectID(), profilerFrame, FabricProfiler::EventKind_OutputTransfer, portName.GetAsciiString());
 
     try
     {
@@ -1570,6 +1697,23 @@ XSIPLUGINCALLBACK CStatus CanvasOp_Update(CRef &in_ctxt)
                 t.SetTranslationFromValues(val[7],val[8],val[9]);
               }
               kineOut.PutTransform(t);
+              profilerScope.setBytes(val.size() * sizeof(double));
+            }
+          }
+          else if (   outputPort.GetTarget().GetClassID() == siPrimitiveID
+                   && CString(exec.getExecPortResolvedType(portName.GetAsciiString())) == L"Points")
+          {
+            CString iceAttrNames = exec.getExecPortMetadata(portName.GetAsciiString(), "XSI_iceAttributes");
+            CString errmsg;
+            FabricCore::RTVal rtval = binding.getArgValue(portName.GetAsciiString());
+            if (!rtval.isValid() || rtval.isNullObject())
+              Application().LogMessage(functionName + L": the DFG port \"" + portName + L"\" holds no Points.", siWarningMsg);
+            else if (!convertOutputPointCloud(Primitive(outputPort.GetTarget()).GetGeometry(), rtval, iceAttrNames, errmsg))
+              Application().LogMessage(functionName + L": failed to set the point cloud from DFG port \"" + portName + L"\": " + errmsg, siWarningMsg);
+            else
+            {
+              profilerScope.stop();
+              profilerScope.setBytes(FabricProfiler::getGeometryBytes(rtval));
             }
           }
           else if (outputPort.GetTarget().GetClassID() == siPrimitiveID)
@@ -1608,19 +1752,27 @@ XSIPLUGINCALLBACK CStatus CanvasOp_Update(CRef &in_ctxt)
                   for (LONG j=0;j<num;j++,src++, dst++)
                     *dst = *src;
                 }
+                profilerScope.setBytes(  polymesh.vertPositions  .size() * sizeof(float)
+                                       + polymesh.polyNumVertices.size() * sizeof(uint32_t)
+                                       + polymesh.polyVertices   .size() * sizeof(uint32_t)
+                                       + polymesh.polyNodeNormals.size() * sizeof(float)
+                                       + polymesh.polyNodeUVWs   .size() * sizeof(float)
+                                       + polymesh.polyNodeColors .size() * sizeof(float));
                 if (xsiPolymesh.Set(vertices, polygons) != CStatus::OK)
                 {
                   Application().LogMessage(L"xsiPolymesh.Set(vertices, polygons) failed", siErrorMsg);
                 }
                 else
                 {
-                  // store normals, UVWs and vertex colors as ICE data.
+                  // store normals, UVWs and vertex colors.
                   //
                   // note: attempting to directly set "per point" or "per node" ICE data fails, because attributes added
                   //       via XSI::Geometry::AddICEAttribute() be constant (ICEAttribute::IsConstant() == true) and there
                   //       seems no way to get around this.
-                  //       Therefore the data (normals, colors, UVs, ..) is stored as an "array per object" which must then be
-                  //       converted to "per point" or "per node" in ICE by the user.
+                  //       Therefore the data (normals, colors, UVs, ..) is stored as an "array per object" which must then
+                  //       be converted to "per node" in ICE by the user, either with the "Fabric Canvas Set Normals/UVWs/Colors"
+                  //       compounds or with the faster "Fabric Canvas Set Normals/UVWs/Colors Per Node" compounds (these
+                  //       read the arrays with the ICE node "FabricCanvasGetPerNodeData", see FabricDFGICENodes.h).
 
                   // array of normals per polygon node.
                   {
@@ -1942,6 +2094,8 @@ int Dialog_DefinePortMapping(std::vector<_portMapping> &io_pmap)
 
                   || pmap.dfgPortDataType == L"PolygonMesh"
 
+                  || pmap.dfgPortDataType == L"Points"
+
                   || pmap.dfgPortDataType == L"Float64<>"
 
                   || pmap.dfgPortDataType == L"Vec3<>")
@@ -1949,6 +2103,11 @@ int Dialog_DefinePortMapping(std::vector<_portMapping> &io_pmap)
                 cvaMapType.Add( L"XSI Port" );
                 cvaMapType.Add( DFG_PORT_MAPTYPE_XSI_PORT );
               }
+              if (_portMapping::isICEPortDataType(pmap.dfgPortDataType))
+              {
+                cvaMapType.Add( L"XSI ICE Port" );
+                cvaMapType.Add( DFG_PORT_MAPTYPE_XSI_ICE_PORT );
+              }
             }
             else if (pmap.dfgPortType == DFG_PORT_TYPE_OUT)
             {
@@ -1958,6 +2117,8 @@ int Dialog_DefinePortMapping(std::vector<_portMapping> &io_pmap)
 
                   || pmap.dfgPortDataType == L"PolygonMesh"
 
+                  || pmap.dfgPortDataType == L"Points"
+
                   || pmap.dfgPortDataType == L"Float64<>"
 
                   || pmap.dfgPortDataType == L"Vec3<>")
@@ -118,6 +118,8 @@ struct _portMapping
 
           && dfgPortDataType != L"PolygonMesh"
 
+          && dfgPortDataType != L"Points"
+
           && dfgPortDataType != L"Float64<>"
 
           && dfgPortDataType != L"Vec3<>")
@@ -125,7 +127,11 @@ struct _portMapping
     }
     else if (mapType == DFG_PORT_MAPTYPE_XSI_ICE_PORT)
     {
-      return false;
+      if (dfgPortType != DFG_PORT_TYPE_IN)
+        return false;
+
+      if (!isICEPortDataType(dfgPortDataType))
+        return false;
     }
     else
     {
@@ -136,6 +142,23 @@ struct _portMapping
     return true;
   }
 
+  // returns true if a DFG port of the data type in_dataType can be mapped to an ICE attribute.
+  // (note: these are the external arrays of the KL types that match an ICE data type).
+  static bool isICEPortDataType(const XSI::CString &in_dataType)
+  {
+    return (   in_dataType == L"Integer<>"
+            || in_dataType == L"SInt32<>"
+
+            || in_dataType == L"Scalar<>"
+            || in_dataType == L"Float32<>"
+
+            || in_dataType == L"Vec2<>"
+            || in_dataType == L"Vec3<>"
+            || in_dataType == L"Color<>"
+            || in_dataType == L"Quat<>"
+            || in_dataType == L"Mat44<>");
+  }
+
   // returns true if the two port mappings match (same name, type, etc.).
   static bool areMatching(const _portMapping &a, const _portMapping &b, bool considerPortDataType = true)
   {
@@ -209,6 +232,20 @@ struct _opUserData
   long int updateCounter;   // counts how many times the operator's _Update() function was called.
   bool execFabricStep12;    // true: execute the Fabric steps 1 and 2 (i.e. set dfg args and execute graph).
 
+  // state of a DFG input port mapped to an ICE attribute (see DFG_PORT_MAPTYPE_XSI_ICE_PORT).
+  struct _iceAttributePort
+  {
+    unsigned long long  hash;     // content hash of the ICE attribute when the port was last set.
+    const void         *data;     // memory referenced by the port's external array.
+    unsigned int        count;    // amount of elements in the external array.
+    std::vector <float> buffer;   // converted values, for Quat and Mat44 (different layout in ICE and KL) and constant attributes.
+    _iceAttributePort() : hash(0), data(NULL), count(0) {}
+  };
+  std::map <std::string, _iceAttributePort> iceAttributePorts;
+
+  // evaluation ID of the point cloud connected to a "Points" port when the port was last set (0 = never).
+  std::map <std::string, LONG> pointCloudEvalIDs;
+
   // this is used by the functions that create new operators.
   // note: we need to make this a global thing, because we cannot access
   //       things such as the user data and the operator in the
@@ -325,6 +362,10 @@ struct _polymesh
         vertColors;
         polyNodeUVWs;
         polyNodeColors;
+
+    the UVW and color sets after the first one are stored by name (see getExtraNodeSetAttributeName()) in:
+        extraUVWNames     / extraPolyNodeUVWs;
+        extraColorNames   / extraPolyNodeColors;
   */
 
   unsigned int            numVertices;
@@ -339,6 +380,10 @@ struct _polymesh
   std::vector <float>     polyNodeNormals;
   std::vector <float>     polyNodeUVWs;
   std::vector <float>     polyNodeColors;
+  std::vector <std::string>           extraUVWNames;
+  std::vector < std::vector <float> > extraPolyNodeUVWs;
+  std::vector <std::string>           extraColorNames;
+  std::vector < std::vector <float> > extraPolyNodeColors;
 
   // mesh bounding box.
   float bbox[6];
@@ -362,6 +407,10 @@ struct _polymesh
     polyNodeNormals .clear();
     polyNodeUVWs    .clear();
     polyNodeColors  .clear();
+    extraUVWNames       .clear();
+    extraPolyNodeUVWs   .clear();
+    extraColorNames     .clear();
+    extraPolyNodeColors .clear();
     for (int i = 0; i < 6; i++)
       bbox[i] = 0;
   }
@@ -381,6 +430,10 @@ struct _polymesh
     polyNodeNormals.resize(inMesh.polyNodeNormals.size());  memcpy(polyNodeNormals.data(), inMesh.polyNodeNormals.data(), polyNodeNormals.size() * sizeof(float)   );
     polyNodeUVWs   .resize(inMesh.polyNodeUVWs   .size());  memcpy(polyNodeUVWs   .data(), inMesh.polyNodeUVWs   .data(), polyNodeUVWs   .size() * sizeof(float)   );
     polyNodeColors .resize(inMesh.polyNodeColors .size());  memcpy(polyNodeColors .data(), inMesh.polyNodeColors .data(), polyNodeColors .size() * sizeof(float)   );
+    extraUVWNames       = inMesh.extraUVWNames;
+    extraPolyNodeUVWs   = inMesh.extraPolyNodeUVWs;
+    extraColorNames     = inMesh.extraColorNames;
+    extraPolyNodeColors = inMesh.extraPolyNodeColors;
     for (int i = 0; i < 6; i++)
       bbox[i] = inMesh.bbox[i];
   }
@@ -44,6 +44,7 @@
 #include "FabricDFGPlugin.h"
 #include "FabricDFGOperators.h"
 #include "FabricDFGTools.h"
+#include "FabricSpliceConversion.h"
 
 using namespace XSI;
 using namespace XSI::MATH;
@@ -195,7 +196,11 @@ bool dfgTools::GetOperatorPortMapping(XSI::CRef &in_op, std::vector<_portMapping
                 && pg.GetName() == pmap.dfgPortName)
             {
               // found one.
+              // (note: ICE ports also have a port group, they are told apart by the port's "XSI_mapType" metadata).
               pmap.mapType = DFG_PORT_MAPTYPE_XSI_PORT;
+              const char *mapTypeData = exec.getExecPortMetadata(pmap.dfgPortName.GetAsciiString(), "XSI_mapType");
+              if (mapTypeData && atoi(mapTypeData) == DFG_PORT_MAPTYPE_XSI_ICE_PORT)
+                pmap.mapType = DFG_PORT_MAPTYPE_XSI_ICE_PORT;
 
               // now look if there also is a connected input port of the same name.
               for (int k=0;k<opPortsInput.GetCount();k++)
@@ -286,6 +291,8 @@ XSI::siClassID dfgTools::GetSiClassIdFromResolvedDataType(const XSI::CString &re
 
   if (resDataType == L"PolygonMesh")                            return siPolygonMeshID;
 
+  if (resDataType == L"Points")                                 return siPrimitiveID;
+
   if (resDataType == L"Float64<>" )                             return siClusterPropertyID;
 
   if (resDataType == L"Vec3<>" )                                return siShapeKeyID;  
@@ -293,6 +300,15 @@ XSI::siClassID dfgTools::GetSiClassIdFromResolvedDataType(const XSI::CString &re
   return siUnknownClassID;  // no match.
 }
 
+XSI::siClassID dfgTools::GetSiClassIdFromPortMapping(const _portMapping &pmap)
+{
+  // ICE ports are connected to the primitive that holds the ICE attribute.
+  if (pmap.mapType == DFG_PORT_MAPTYPE_XSI_ICE_PORT)
+    return siPrimitiveID;
+
+  return GetSiClassIdFromResolvedDataType(pmap.dfgPortDataType);
+}
+
 XSI::CString &dfgTools::GetSiClassIdDescription(const XSI::siClassID in_siClassID, XSI::CString &out_description)
 {
   switch (in_siClassID)
@@ -553,7 +569,30 @@ bool dfgTools::FileExists(const char *filePath)
   return false;
 }
 
-bool dfgTools::GetGeometryFromX3DObject(const XSI::X3DObject &in_x3DObj, double in_currFrame, bool in_useGlobalSRT, XSI::CDoubleArray &out_vertexPositions, XSI::CLongArray &out_polyVIndices, XSI::CLongArray &out_polyVCount, LONG &out_numNodes, bool &inout_useVertMotions, XSI::CFloatArray &out_vertMotions, bool noWarnMotions, bool &inout_useNodeNormals, bool in_useNormals, XSI::CFloatArray &out_nodeNormals, bool noWarnNormals, bool &inout_useNodeUVWs, XSI::CFloatArray &out_nodeUVWs, bool noWarnUVWs, bool &inout_useNodeColors, XSI::CFloatArray &out_nodeColors, bool noWarnColors, XSI::CString &in_nameMotions, XSI::CString &in_nameNormals, XSI::CString &in_nameUVWs, XSI::CString &in_nameColors, XSI::CString &errmsg, XSI::CString &wrnmsg)
+// gets the cluster property sets of in_refs after the first one (the first one is handled by GetGeometryFromX3DObject()).
+// the values are ordered by polygon node, like the first set, and the names are the ones of
+// the SpliceOp's attributes (see getExtraNodeSetAttributeName()).
+static void getAdditionalNodeSets(const CRefArray &in_refs, const CLongArray &in_nodeIndices, LONG in_valueSize, std::vector <std::string> &out_names, std::vector < std::vector <float> > &out_values)
+{
+  for (LONG i=1;i<in_refs.GetCount();i++)
+  {
+    ClusterProperty cProp(in_refs[i]);
+    CFloatArray tmpValues(0);
+    if (   !cProp.IsValid()
+        ||  cProp.GetValueSize() != in_valueSize
+        ||  cProp.GetValues(tmpValues) != CStatus::OK)
+      continue;
+
+    out_names .push_back(getExtraNodeSetAttributeName(cProp.GetName(), in_valueSize == 3));
+    out_values.push_back(std::vector <float>(in_nodeIndices.GetCount() * in_valueSize));
+    float *nv = out_values.back().data();
+    for (LONG j=0;j<in_nodeIndices.GetCount();j++,nv+=in_valueSize)
+      for (LONG k=0;k<in_valueSize;k++)
+        nv[k] = tmpValues[in_nodeIndices[j] * in_valueSize + k];
+  }
+}
+
+bool dfgTools::GetGeometryFromX3DObject(const XSI::X3DObject &in_x3DObj, double in_currFrame, bool in_useGlobalSRT, XSI::CDoubleArray &out_vertexPositions, XSI::CLongArray &out_polyVIndices, XSI::CLongArray &out_polyVCount, LONG &out_numNodes, bool &inout_useVertMotions, XSI::CFloatArray &out_vertMotions, bool noWarnMotions, bool &inout_useNodeNormals, bool in_useNormals, XSI::CFloatArray &out_nodeNormals, bool noWarnNormals, bool &inout_useNodeUVWs, XSI::CFloatArray &out_nodeUVWs, bool noWarnUVWs, bool &inout_useNodeColors, XSI::CFloatArray &out_nodeColors, bool noWarnColors, XSI::CString &in_nameMotions, XSI::CString &in_nameNormals, XSI::CString &in_nameUVWs, XSI::CString &in_nameColors, XSI::CString &errmsg, XSI::CString &wrnmsg, _polymesh *out_extraSets)
 {
   // init.
   errmsg = L"";
@@ -1122,6 +1161,13 @@ bool dfgTools::GetGeometryFromX3DObject(const XSI::X3DObject &in_x3DObj, double
     }
   }
 
+  // get the additional UVW and color sets.
+  if (out_extraSets)
+  {
+    if (inout_useNodeUVWs)    getAdditionalNodeSets(ga.GetUVs(),          nodeIndices, 3, out_extraSets->extraUVWNames,   out_extraSets->extraPolyNodeUVWs);
+    if (inout_useNodeColors)  getAdditionalNodeSets(ga.GetVertexColors(), nodeIndices, 4, out_extraSets->extraColorNames, out_extraSets->extraPolyNodeColors);
+  }
+
   // done.
   return true;
 }
@@ -1144,6 +1190,7 @@ bool dfgTools::GetGeometryFromX3DObject(const XSI::X3DObject &in_x3DObj, double
   CFloatArray   nodeNormals      (0);
   CFloatArray   nodeUVWs         (0);
   CFloatArray   nodeColors       (0);
+  _polymesh     extraSets;
   if (!GetGeometryFromX3DObject(in_x3DObj,
                                 in_currFrame,
                                 false,
@@ -1160,7 +1207,8 @@ bool dfgTools::GetGeometryFromX3DObject(const XSI::X3DObject &in_x3DObj, double
                                 CString(),
                                 CString(),
                                 out_errmsg,
-                                out_wrnmsg ) )
+                                out_wrnmsg,
+                                &extraSets ) )
   {
     return false;
   }
@@ -1199,6 +1247,12 @@ bool dfgTools::GetGeometryFromX3DObject(const XSI::X3DObject &in_x3DObj, double
     return false;
   }
 
+  // move the additional UVW and color sets (SetFromFlatArrays() clears them).
+  out_polymesh.extraUVWNames      .swap(extraSets.extraUVWNames);
+  out_polymesh.extraPolyNodeUVWs  .swap(extraSets.extraPolyNodeUVWs);
+  out_polymesh.extraColorNames    .swap(extraSets.extraColorNames);
+  out_polymesh.extraPolyNodeColors.swap(extraSets.extraPolyNodeColors);
+
   // done.
   return true;
 }
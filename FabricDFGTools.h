@@ -33,6 +33,10 @@ class dfgTools
   
   // returns the matching siClassID for a given DFG resolved data type.
   static XSI::siClassID GetSiClassIdFromResolvedDataType(const XSI::CString &resDataType);
+
+  // returns the matching siClassID for a given port mapping
+  // (i.e. the one of the resolved data type, or siPrimitiveID for ICE ports).
+  static XSI::siClassID GetSiClassIdFromPortMapping(const _portMapping &pmap);
   
   // gets the description of a siCLassID.
   static XSI::CString &GetSiClassIdDescription(const XSI::siClassID in_siClassID, XSI::CString &out_description);
@@ -69,9 +73,10 @@ class dfgTools
   //          in_nameColors         L"" or name of the color data to use.
   //          errmsg                ref at CString that will contain an error description if this functions returns false.
   //          wrnmsg                ref at CString that will contain a warning if this functions returns true, or L"" if no warning.
+  //          out_extraSets         NULL or pointer at a _polymesh whose extra* members will contain the UVW and color sets after the first one (named like the SpliceOp names them, see getExtraNodeSetAttributeName()).
   // returns: true on success else false (with an error description in errmsg).
   // note: this function was taken "as is" from the class MZDXSI which is part of the main Mootzoid c++ lib (see mootzoid_XSI.h and mootzoid_XSI.cpp).
-  static bool GetGeometryFromX3DObject(const XSI::X3DObject &in_x3DObj, double in_currFrame, bool in_useGlobalSRT, XSI::CDoubleArray &out_vertexPositions, XSI::CLongArray &out_polyVIndices, XSI::CLongArray &out_polyVCount, LONG &out_numNodes, bool &inout_useVertMotions, XSI::CFloatArray &out_vertMotions, bool noWarnMotions, bool &inout_useNodeNormals, bool in_useNormals, XSI::CFloatArray &out_nodeNormals, bool noWarnNormals, bool &inout_useNodeUVWs, XSI::CFloatArray &out_nodeUVWs, bool noWarnUVWs, bool &inout_useNodeColors, XSI::CFloatArray &out_nodeColors, bool noWarnColors, XSI::CString &in_nameMotions, XSI::CString &in_nameNormals, XSI::CString &in_nameUVWs, XSI::CString &in_nameColors, XSI::CString &errmsg, XSI::CString &wrnmsg);
+  static bool GetGeometryFromX3DObject(const XSI::X3DObject &in_x3DObj, double in_currFrame, bool in_useGlobalSRT, XSI::CDoubleArray &out_vertexPositions, XSI::CLongArray &out_polyVIndices, XSI::CLongArray &out_polyVCount, LONG &out_numNodes, bool &inout_useVertMotions, XSI::CFloatArray &out_vertMotions, bool noWarnMotions, bool &inout_useNodeNormals, bool in_useNormals, XSI::CFloatArray &out_nodeNormals, bool noWarnNormals, bool &inout_useNodeUVWs, XSI::CFloatArray &out_nodeUVWs, bool noWarnUVWs, bool &inout_useNodeColors, XSI::CFloatArray &out_nodeColors, bool noWarnColors, XSI::CString &in_nameMotions, XSI::CString &in_nameNormals, XSI::CString &in_nameUVWs, XSI::CString &in_nameColors, XSI::CString &errmsg, XSI::CString &wrnmsg, _polymesh *out_extraSets = NULL);
 
   // gets the geometry from the input X3DObject and stores it in out_polymesh.
   // params:  in_x3DObj             ref at X3DObject.
@@ -0,0 +1,448 @@
+
+#include "FabricProfiler.h"
+#include "FabricSplicePlugin.h"
+
+#include <xsi_application.h>
+#include <xsi_ref.h>
+
+#include <map>
+#include <fstream>
+#include <sstream>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
+
+using namespace XSI;
+
+QAtomicInt FabricProfiler::s_enabled(0);
+std::vector<FabricProfiler::event> FabricProfiler::s_events;
+
+static QElapsedTimer gProfilerTimer;
+static QMutex gProfilerMutex;
+static std::map<unsigned int, std::string> gProfilerOperatorNames;
+
+static const char * getEventKindName(FabricProfiler::EventKind kind)
+{
+  switch(kind)
+  {
+    case FabricProfiler::EventKind_InputTransfer:  return "input";
+    case FabricProfiler::EventKind_Execute:        return "execute";
+    case FabricProfiler::EventKind_OutputTransfer: return "output";
+    case FabricProfiler::EventKind_Skipped:        return "skipped";
+    case FabricProfiler::EventKind_Scope:          return "scope";
+  }
+  return "";
+}
+
+static std::string escapeJSON(const std::string & str)
+{
+  std::string result;
+  for(size_t i=0;i<str.length();i++)
+  {
+    unsigned char c = (unsigned char)str[i];
+    if(c == '"' || c == '\\')
+    {
+      result += '\\';
+      result += (char)c;
+    }
+    else if(c < 0x20)
+    {
+      // control characters have to be written as \u00XX.
+      static const char * hexDigits = "0123456789abcdef";
+      result += "\\u00";
+      result += hexDigits[c >> 4];
+      result += hexDigits[c & 0xf];
+    }
+    else
+      result += (char)c;
+  }
+  return result;
+}
+
+void FabricProfiler::start()
+{
+  QMutexLocker lock(&gProfilerMutex);
+  s_events.clear();
+  gProfilerOperatorNames.clear();
+  gProfilerTimer.start();
+  s_enabled.fetchAndStoreOrdered(1);
+}
+
+void FabricProfiler::stop()
+{
+  s_enabled.fetchAndStoreOrdered(0);
+}
+
+double FabricProfiler::getTimeMs()
+{
+  if(!gProfilerTimer.isValid())
+    return 0.0;
+  return (double)gProfilerTimer.nsecsElapsed() * 1.0e-6;
+}
+
+void FabricProfiler::record(unsigned int objectID, double frame, EventKind kind, const char * portName, double startMs, double durationMs, size_t bytes)
+{
+  if(!isEnabled())
+    return;
+
+  event e;
+  e.objectID = objectID;
+  e.frame = frame;
+  e.kind = kind;
+  e.portName = portName ? portName : "";
+  e.threadID = (unsigned long long)QThread::currentThreadId();
+  e.startMs = startMs;
+  e.durationMs = durationMs;
+  e.bytes = bytes;
+
+  QMutexLocker lock(&gProfilerMutex);
+  s_events.push_back(e);
+}
+
+void FabricProfiler::recordSkipped(unsigned int objectID, double frame)
+{
+  record(objectID, frame, EventKind_Skipped, "", getTimeMs(), 0.0);
+}
+
+size_t FabricProfiler::getDataTypeBytes(const std::string & dataType)
+{
+  if(dataType == "Boolean" || dataType == "Byte" || dataType == "UInt8" || dataType == "SInt8")
+    return 1;
+  if(dataType == "UInt16" || dataType == "SInt16")
+    return 2;
+  if(dataType == "Integer" || dataType == "SInt32" || dataType == "UInt32" || dataType == "Scalar" || dataType == "Float32" || dataType == "Index" || dataType == "Count")
+    return 4;
+  if(dataType == "Float64" || dataType == "SInt64" || dataType == "UInt64" || dataType == "Size" || dataType == "DataSize" || dataType == "Vec2")
+    return 8;
+  if(dataType == "Vec3" || dataType == "RGB")
+    return 12;
+  if(dataType == "Vec4" || dataType == "Quat" || dataType == "Color" || dataType == "RGBA")
+    return 16;
+  if(dataType == "Mat33")
+    return 36;
+  if(dataType == "Xfo")
+    return 40;
+  if(dataType == "Mat44")
+    return 64;
+  return 0;
+}
+
+size_t FabricProfiler::getDataTypeBytes(const std::string & dataType, size_t arraySize)
+{
+  if(!isArrayDataType(dataType))
+    return getDataTypeBytes(dataType);
+  return arraySize * getDataTypeBytes(dataType.substr(0, dataType.length() - 2));
+}
+
+bool FabricProfiler::isArrayDataType(const std::string & dataType)
+{
+  if(dataType.length() <= 2)
+    return false;
+  std::string suffix = dataType.substr(dataType.length() - 2);
+  return suffix == "[]" || suffix == "<>";
+}
+
+size_t FabricProfiler::getGeometryBytes(FabricCore::RTVal & rtVal)
+{
+  size_t bytes = 0;
+  try
+  {
+    if(!rtVal.isValid())
+      return 0;
+    if(rtVal.isArray())
+    {
+      for(uint32_t i=0;i<rtVal.getArraySize();i++)
+      {
+        FabricCore::RTVal element = rtVal.getArrayElement(i);
+        bytes += getGeometryBytes(element);
+      }
+      return bytes;
+    }
+    if(!rtVal.isObject() || rtVal.isNullObject())
+      return 0;
+
+    // positions are stored as Vec3, topology as UInt32 indices.
+    std::string typeName = rtVal.getTypeNameCStr();
+    if(typeName == "PolygonMesh")
+    {
+      bytes += (size_t)rtVal.callMethod("Size", "pointCount", 0, 0).getUInt64() * 12;
+      bytes += (size_t)rtVal.callMethod("Size", "polygonPointsCount", 0, 0).getUInt64() * 4;
+    }
+    else if(typeName == "Lines")
+    {
+      bytes += (size_t)rtVal.callMethod("Size", "pointCount", 0, 0).getUInt64() * 12;
+      bytes += (size_t)rtVal.callMethod("Size", "lineCount", 0, 0).getUInt64() * 8;
+    }
+    else if(typeName == "Points")
+    {
+      bytes += (size_t)rtVal.callMethod("Size", "size", 0, 0).getUInt64() * 12;
+    }
+  }
+  catch(FabricCore::Exception e)
+  {
+    // not a geometry we know.
+  }
+  return bytes;
+}
+
+std::string FabricProfiler::getOperatorName(unsigned int objectID)
+{
+  std::map<unsigned int, std::string>::iterator it = gProfilerOperatorNames.find(objectID);
+  if(it != gProfilerOperatorNames.end())
+    return it->second;
+
+  CRef ref = Application().GetObjectFromID(objectID);
+  std::string name = ref.IsValid() ? ref.GetAsText().GetAsciiString() : "";
+  if(name.empty())
+  {
+    std::stringstream ss;
+    ss << "objectID_" << objectID;
+    name = ss.str();
+  }
+  gProfilerOperatorNames.insert(std::pair<unsigned int, std::string>(objectID, name));
+  return name;
+}
+
+// accumulated values per operator, used by the report and the JSON export.
+struct profilerPortData
+{
+  double ms;
+  size_t bytes;
+  profilerPortData() { ms = 0.0; bytes = 0; }
+};
+
+struct profilerFrameData
+{
+  std::map<std::string, profilerPortData> inputs;
+  std::map<std::string, profilerPortData> outputs;
+  double executeMs;
+  unsigned int executions;
+  unsigned int skipped;
+  profilerFrameData() { executeMs = 0.0; executions = 0; skipped = 0; }
+};
+
+typedef std::map<double, profilerFrameData> profilerFrames;
+typedef std::map<std::string, profilerFrames> profilerOperators;
+
+static void accumulateEvents(const std::vector<FabricProfiler::event> & events, profilerOperators & result)
+{
+  for(size_t i=0;i<events.size();i++)
+  {
+    const FabricProfiler::event & e = events[i];
+    if(e.kind == FabricProfiler::EventKind_Scope)
+      continue;
+    profilerFrameData & frame = result[FabricProfiler::getOperatorName(e.objectID)][e.frame];
+    if(e.kind == FabricProfiler::EventKind_InputTransfer)
+    {
+      frame.inputs[e.portName].ms += e.durationMs;
+      frame.inputs[e.portName].bytes += e.bytes;
+    }
+    else if(e.kind == FabricProfiler::EventKind_OutputTransfer)
+    {
+      frame.outputs[e.portName].ms += e.durationMs;
+      frame.outputs[e.portName].bytes += e.bytes;
+    }
+    else if(e.kind == FabricProfiler::EventKind_Execute)
+    {
+      frame.executeMs += e.durationMs;
+      frame.executions++;
+    }
+    else if(e.kind == FabricProfiler::EventKind_Skipped)
+      frame.skipped++;
+  }
+}
+
+void FabricProfiler::logReport()
+{
+  std::vector<event> events;
+  {
+    QMutexLocker lock(&gProfilerMutex);
+    events = s_events;
+  }
+
+  profilerOperators operators;
+  accumulateEvents(events, operators);
+
+  for(profilerOperators::iterator it = operators.begin(); it != operators.end(); it++)
+  {
+    double inputMs = 0.0, outputMs = 0.0, executeMs = 0.0;
+    size_t inputBytes = 0, outputBytes = 0;
+    unsigned int executions = 0, skipped = 0;
+    for(profilerFrames::iterator fit = it->second.begin(); fit != it->second.end(); fit++)
+    {
+      std::map<std::string, profilerPortData>::iterator pit;
+      for(pit = fit->second.inputs.begin(); pit != fit->second.inputs.end(); pit++)
+      {
+        inputMs += pit->second.ms;
+        inputBytes += pit->second.bytes;
+      }
+      for(pit = fit->second.outputs.begin(); pit != fit->second.outputs.end(); pit++)
+      {
+        outputMs += pit->second.ms;
+        outputBytes += pit->second.bytes;
+      }
+      executeMs += fit->second.executeMs;
+      executions += fit->second.executions;
+      skipped += fit->second.skipped;
+    }
+
+    std::stringstream ss;
+    ss << "[Profiler] " << it->first << ": " << it->second.size() << " frame(s), "
+       << executions << " execution(s) " << executeMs << " ms, "
+       << "inputs " << inputMs << " ms " << inputBytes << " bytes, "
+       << "outputs " << outputMs << " ms " << outputBytes << " bytes, "
+       << skipped << " skipped evaluation(s)";
+    xsiLogFunc(ss.str().c_str());
+  }
+}
+
+bool FabricProfiler::exportCSV(const std::string & fileName)
+{
+  std::ofstream file(fileName.c_str());
+  if(!file.is_open())
+    return false;
+
+  QMutexLocker lock(&gProfilerMutex);
+  file << "operator,frame,kind,port,start_ms,duration_ms,bytes\n";
+  for(size_t i=0;i<s_events.size();i++)
+  {
+    const event & e = s_events[i];
+    if(e.kind == EventKind_Scope)
+      continue;
+    file << getOperatorName(e.objectID) << "," << e.frame << "," << getEventKindName(e.kind) << ","
+         << e.portName << "," << e.startMs << "," << e.durationMs << "," << e.bytes << "\n";
+  }
+  return true;
+}
+
+static void writePortsJSON(std::ofstream & file, std::map<std::string, profilerPortData> & ports)
+{
+  file << "{";
+  for(std::map<std::string, profilerPortData>::iterator it = ports.begin(); it != ports.end(); it++)
+  {
+    if(it != ports.begin())
+      file << ",";
+    file << "\"" << escapeJSON(it->first) << "\":{\"ms\":" << it->second.ms << ",\"bytes\":" << it->second.bytes << "}";
+  }
+  file << "}";
+}
+
+bool FabricProfiler::exportJSON(const std::string & fileName)
+{
+  std::ofstream file(fileName.c_str());
+  if(!file.is_open())
+    return false;
+
+  std::vector<event> events;
+  {
+    QMutexLocker lock(&gProfilerMutex);
+    events = s_events;
+  }
+
+  profilerOperators operators;
+  accumulateEvents(events, operators);
+
+  file << "{\"operators\":{";
+  for(profilerOperators::iterator it = operators.begin(); it != operators.end(); it++)
+  {
+    if(it != operators.begin())
+      file << ",";
+    file << "\n\"" << escapeJSON(it->first) << "\":{\"frames\":[";
+    for(profilerFrames::iterator fit = it->second.begin(); fit != it->second.end(); fit++)
+    {
+      if(fit != it->second.begin())
+        file << ",";
+      file << "\n{\"frame\":" << fit->first;
+      file << ",\"inputs\":";
+      writePortsJSON(file, fit->second.inputs);
+      file << ",\"execute_ms\":" << fit->second.executeMs;
+      file << ",\"executions\":" << fit->second.executions;
+      file << ",\"outputs\":";
+      writePortsJSON(file, fit->second.outputs);
+      file << ",\"skipped\":" << fit->second.skipped << "}";
+    }
+    file << "]}";
+  }
+  file << "}}\n";
+  return true;
+}
+
+bool FabricProfiler::exportChromeTrace(const std::string & fileName)
+{
+  std::ofstream file(fileName.c_str());
+  if(!file.is_open())
+    return false;
+
+  QMutexLocker lock(&gProfilerMutex);
+  file << "{\"traceEvents\":[";
+  for(size_t i=0;i<s_events.size();i++)
+  {
+    const event & e = s_events[i];
+    if(i > 0)
+      file << ",";
+    // the ports and scopes of one thread nest on the same timeline row.
+    std::string name = e.portName.empty() ? getEventKindName(e.kind) : e.portName;
+    file << "\n{\"name\":\"" << escapeJSON(name) << "\",\"cat\":\"" << getEventKindName(e.kind) << "\"";
+    if(e.kind == EventKind_Skipped)
+      file << ",\"ph\":\"i\",\"s\":\"t\"";
+    else
+      file << ",\"ph\":\"X\",\"dur\":" << (e.durationMs * 1000.0);
+    file << ",\"ts\":" << (e.startMs * 1000.0) << ",\"pid\":0,\"tid\":" << e.threadID << ",\"args\":{";
+    if(e.objectID != UINT_MAX)
+      file << "\"operator\":\"" << escapeJSON(getOperatorName(e.objectID)) << "\",";
+    file << "\"frame\":" << e.frame;
+    if(e.kind != EventKind_Scope)
+      file << ",\"bytes\":" << e.bytes;
+    file << "}}";
+  }
+  file << "\n]}\n";
+  return true;
+}
+
+FabricProfilerScope::FabricProfilerScope(unsigned int objectID, double frame, FabricProfiler::EventKind kind, const char * portName)
+{
+  _enabled = FabricProfiler::isEnabled();
+  if(!_enabled)
+    return;
+  _objectID = objectID;
+  _frame = frame;
+  _kind = kind;
+  _portName = portName ? portName : "";
+  _bytes = 0;
+  _startMs = FabricProfiler::getTimeMs();
+  _endMs = -1.0;
+}
+
+void FabricProfilerScope::stop()
+{
+  if(!_enabled || _endMs >= 0.0)
+    return;
+  _endMs = FabricProfiler::getTimeMs();
+}
+
+FabricProfilerScope::~FabricProfilerScope()
+{
+  if(!_enabled)
+    return;
+  stop();
+  FabricProfiler::record(_objectID, _frame, _kind, _portName.c_str(), _startMs, _endMs - _startMs, _bytes);
+}
+
+FabricTraceScope::FabricTraceScope(const char * name, unsigned int objectID, double frame)
+{
+  _enabled = FabricProfiler::isEnabled();
+  if(!_enabled)
+    return;
+  _name = name;
+  _objectID = objectID;
+  _frame = frame;
+  _startMs = FabricProfiler::getTimeMs();
+}
+
+FabricTraceScope::~FabricTraceScope()
+{
+  if(!_enabled)
+    return;
+  FabricProfiler::record(_objectID, _frame, FabricProfiler::EventKind_Scope, _name, _startMs, FabricProfiler::getTimeMs() - _startMs);
+}
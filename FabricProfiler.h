@@ -0,0 +1,115 @@
+#ifndef __FabricProfiler_H_
+#define __FabricProfiler_H_
+
+#include <string>
+#include <vector>
+#include <limits.h>
+
+#include <FabricCore.h>
+
+#include <QtCore/QAtomicInt>
+
+// per operator profiler shared by the SpliceOp and the CanvasOp.
+// it is enabled by 'fabricSplice startProfiling' and records, per operator and
+// per frame, the time spent transfering each port, executing the graph and
+// the amount of evaluations that were skipped because no input was dirty.
+// the result can be exported as CSV, JSON or Chrome trace ('fabricSplice stopProfiling').
+// the Chrome trace also holds the named scopes (operator updates, render pass),
+// to be loaded into chrome://tracing or Perfetto.
+class FabricProfiler
+{
+public:
+
+  enum EventKind
+  {
+    EventKind_InputTransfer,
+    EventKind_Execute,
+    EventKind_OutputTransfer,
+    EventKind_Skipped,
+    EventKind_Scope
+  };
+
+  struct event
+  {
+    unsigned int objectID;
+    double frame;
+    EventKind kind;
+    std::string portName;     // for EventKind_Scope: the name of the scope.
+    unsigned long long threadID;
+    double startMs;
+    double durationMs;
+    size_t bytes;
+  };
+
+  static void start();
+  static void stop();
+  static bool isEnabled() { return (int)s_enabled != 0; }
+
+  // milliseconds elapsed since start().
+  static double getTimeMs();
+
+  static void record(unsigned int objectID, double frame, EventKind kind, const char * portName, double startMs, double durationMs, size_t bytes = 0);
+  static void recordSkipped(unsigned int objectID, double frame);
+
+  // size in bytes of a single value of a plain KL type (0 if unknown).
+  static size_t getDataTypeBytes(const std::string & dataType);
+  // size in bytes of a value of a plain KL type or of an array of them ("Vec3[]" or "Vec3<>"),
+  // arraySize being the amount of elements (ignored if dataType is not an array type).
+  static size_t getDataTypeBytes(const std::string & dataType, size_t arraySize);
+  // true if dataType is a variable ("Vec3[]") or external ("Vec3<>") array type.
+  static bool isArrayDataType(const std::string & dataType);
+  // rough size in bytes of the data held by a PolygonMesh / Lines / Points RTVal (or an array of them).
+  // this calls KL methods, so it is meant to be used after FabricProfilerScope::stop().
+  static size_t getGeometryBytes(FabricCore::RTVal & rtVal);
+
+  static std::string getOperatorName(unsigned int objectID);
+  static void logReport();
+  static bool exportCSV(const std::string & fileName);
+  static bool exportJSON(const std::string & fileName);
+  static bool exportChromeTrace(const std::string & fileName);
+
+private:
+  static QAtomicInt s_enabled;
+  static std::vector<event> s_events;
+};
+
+// records the time between its construction and destruction.
+class FabricProfilerScope
+{
+public:
+  FabricProfilerScope(unsigned int objectID, double frame, FabricProfiler::EventKind kind, const char * portName = "");
+  ~FabricProfilerScope();
+
+  // ends the timed section, so the bytes can be computed without being timed.
+  void stop();
+  void setBytes(size_t bytes) { _bytes = bytes; }
+  void addBytes(size_t bytes) { _bytes += bytes; }
+
+private:
+  bool _enabled;
+  unsigned int _objectID;
+  double _frame;
+  FabricProfiler::EventKind _kind;
+  std::string _portName;
+  double _startMs;
+  double _endMs;
+  size_t _bytes;
+};
+
+// records a named span (EventKind_Scope) between its construction and destruction,
+// only exported to the Chrome trace.
+class FabricTraceScope
+{
+public:
+  FabricTraceScope(const char * name, unsigned int objectID = UINT_MAX, double frame = 0.0);
+  ~FabricTraceScope();
+
+private:
+  bool _enabled;
+  const char * _name;
+  unsigned int _objectID;
+  double _frame;
+  double _startMs;
+};
+
+#endif
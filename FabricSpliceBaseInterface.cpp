@@ -4,6 +4,7 @@
 #include "FabricSpliceOperators.h"
 #include "FabricSpliceCommands.h"
 #include "FabricSpliceDialogs.h"
+#include "FabricProfiler.h"
 
 #include <string>
 #include <fstream>
@@ -42,8 +43,69 @@
 #include <xsi_x3dobject.h>
 #include <xsi_comapihandler.h>
 
+#include <QtCore/QThread>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QAtomicInt>
+
 using namespace XSI;
 
+// thread compiling the source code of a KL operator in the background.
+// while it runs the operator is not evaluated and keeps its last outputs,
+// and every other access to the graph waits for it (see waitForCompilation).
+class KLCompileThread : public QThread
+{
+public:
+  KLCompileThread(FabricSplice::DGGraph graph, const CString &operatorName, const CString &operatorCode, const CString &operatorEntry)
+  {
+    _graph = graph;
+    _operatorName = operatorName.GetAsciiString();
+    _operatorCode = operatorCode.GetAsciiString();
+    _operatorEntry = operatorEntry.GetAsciiString();
+    _ms = 0;
+  }
+
+  const std::string & getOperatorName() const { return _operatorName; }
+  double getMs() const { return _ms; }
+  bool hasErrors() const { return (int)_errors > 0; }
+
+  // called by the log callbacks for errors reported while compiling,
+  // so the status doesn't depend on the (deferred) messages.
+  static void reportErrorForCurrentThread()
+  {
+    KLCompileThread * thread = dynamic_cast<KLCompileThread*>(QThread::currentThread());
+    if(thread)
+      thread->_errors.ref();
+  }
+
+protected:
+  virtual void run()
+  {
+    QElapsedTimer timer;
+    timer.start();
+    try
+    {
+      _graph.setKLOperatorSourceCode(_operatorName.c_str(), _operatorCode.c_str(), _operatorEntry.c_str());
+    }
+    catch(FabricSplice::Exception e)
+    {
+      xsiLogErrorFunc(e.what());
+    }
+    catch(FabricCore::Exception e)
+    {
+      xsiLogErrorFunc(e.getDesc_cstr());
+    }
+    _ms = (double)timer.nsecsElapsed() * 1.0e-6;
+  }
+
+private:
+  FabricSplice::DGGraph _graph;
+  std::string _operatorName;
+  std::string _operatorCode;
+  std::string _operatorEntry;
+  double _ms;
+  QAtomicInt _errors;
+};
+
 std::vector<FabricSpliceBaseInterface*> FabricSpliceBaseInterface::_instances;
 FabricSpliceBaseInterface * FabricSpliceBaseInterface::_currentInstance = NULL;
 
@@ -59,6 +121,9 @@ FabricSpliceBaseInterface::FabricSpliceBaseInterface(){
     _objectID = UINT_MAX;
     _instances.push_back(this);
     _nbOutputPorts = 0;
+    _compileThread = NULL;
+    _staleOutputsWarned = false;
+    _lastTransferTime = 0;
 
     FabricSplice::setDCCOperatorSourceCodeCallback(&getSourceCodeForOperator);
   }
@@ -75,6 +140,12 @@ FabricSpliceBaseInterface::FabricSpliceBaseInterface(){
 }
 
 FabricSpliceBaseInterface::~FabricSpliceBaseInterface(){
+  if(_compileThread)
+  {
+    _compileThread->wait();
+    delete(_compileThread);
+    _compileThread = NULL;
+  }
   for(size_t i=0;i<_instances.size();i++){
     if(_instances[i] == this){
       std::vector<FabricSpliceBaseInterface*>::iterator iter = _instances.begin() + i;
@@ -111,6 +182,7 @@ FabricSpliceBaseInterface * FabricSpliceBaseInterface::getInstanceByObjectID(uns
 
 CStatus FabricSpliceBaseInterface::updateXSIOperator()
 {
+  waitForCompilation();
   FabricSplice::Logging::AutoTimer globalTimer("XSI::updateXSIOperator");
   std::string localTimerName = (std::string("XSI::")+_spliceGraph.getName()+"::updateXSIOperator()").c_str();
   FabricSplice::Logging::AutoTimer localTimer(localTimerName);
@@ -128,6 +200,9 @@ CStatus FabricSpliceBaseInterface::updateXSIOperator()
   CValue mute = oldOp.GetParameterValue("mute");
   CValue debug = oldOp.GetParameterValue("debug");
   CValue alwaysConvertMeshes = oldOp.GetParameterValue("alwaysConvertMeshes");
+  CValue compileInBackground = oldOp.GetParameterValue("compileInBackground");
+  CValue transferPointsAsFloat32 = oldOp.GetParameterValue("transferPointsAsFloat32");
+  CValue releaseBuffersWhenIdle = oldOp.GetParameterValue("releaseBuffersWhenIdle");
 
   // create the operator
   CustomOperator op = Application().GetFactory().CreateObject(L"SpliceOp");
@@ -141,7 +216,31 @@ CStatus FabricSpliceBaseInterface::updateXSIOperator()
     CString targets = it->second.targets;
     CRefArray targetRefs = getCRefArrayFromCString(targets);
 
-    PortGroup group(op.AddPortGroup(portName, targetRefs.GetCount(), targetRefs.GetCount()));
+    // with the 'driveClusters' port option a PolygonMesh output also drives the
+    // UV and vertex color cluster properties of its mesh from the same evaluation,
+    // this way generators changing the topology can write them without a second
+    // operator (see transferOutputPort). the extra ports are named <port>Cluster<i>.
+    CRefArray clusterRefs;
+    bool driveClusters = false;
+    if(portMode == FabricSplice::Port_Mode_OUT && it->second.dataType == "PolygonMesh" && targetRefs.GetCount() == 1)
+    {
+      FabricCore::Variant option = _spliceGraph.getDGPort(portName.GetAsciiString()).getOption("driveClusters");
+      driveClusters = option.isBoolean() && option.getBoolean();
+    }
+    if(driveClusters)
+    {
+      CGeometryAccessor acc = PolygonMesh(Primitive(targetRefs[0]).GetGeometry()).GetGeometryAccessor();
+      CRefArray uvRefs = acc.GetUVs();
+      CRefArray vertexColorRefs = acc.GetVertexColors();
+      if(uvRefs.GetCount() > 0)
+        clusterRefs.Add(uvRefs[0]);
+      if(vertexColorRefs.GetCount() > 0)
+        clusterRefs.Add(vertexColorRefs[0]);
+    }
+    it->second.drivesClusters = clusterRefs.GetCount() > 0;
+
+    LONG groupCount = targetRefs.GetCount() + clusterRefs.GetCount();
+    PortGroup group(op.AddPortGroup(portName, groupCount, groupCount));
     for(LONG i=0;i<targetRefs.GetCount();i++)
     {
       if(portMode == FabricSplice::Port_Mode_IN)
@@ -199,6 +298,11 @@ CStatus FabricSpliceBaseInterface::updateXSIOperator()
         it->second.portIndices.Add(portIndex);
       }
     }
+    for(LONG i=0;i<clusterRefs.GetCount();i++)
+    {
+      CString indexStr(i);
+      op.AddOutputPort(clusterRefs[i], portName+"Cluster"+indexStr, group.GetIndex());
+    }
 
     if(portMode == FabricSplice::Port_Mode_OUT)
     {
@@ -230,6 +334,9 @@ CStatus FabricSpliceBaseInterface::updateXSIOperator()
     op.PutParameterValue("mute", mute);
     op.PutParameterValue("debug", debug);
     op.PutParameterValue("alwaysConvertMeshes", alwaysConvertMeshes);
+    op.PutParameterValue("compileInBackground", compileInBackground);
+    op.PutParameterValue("transferPointsAsFloat32", transferPointsAsFloat32);
+    op.PutParameterValue("releaseBuffersWhenIdle", releaseBuffersWhenIdle);
   }
 
   _currentInstance = NULL;
@@ -284,6 +391,7 @@ CStatus FabricSpliceBaseInterface::updateXSIOperator()
 
 void FabricSpliceBaseInterface::forceEvaluate()
 {
+  waitForCompilation();
   CRef ref = Application().GetObjectFromID(_objectID);
   CustomOperator op(ref);
   bool alwaysEvaluate = op.GetParameterValue("alwaysevaluate");
@@ -326,6 +434,7 @@ CStatus FabricSpliceBaseInterface::constructXSIParameters(CustomOperator &op, Fa
 {
   if(_currentInstance == NULL)
     return CStatus::Unexpected;
+  _currentInstance->waitForCompilation();
 
   for(std::map<std::string, parameterInfo>::iterator it = _currentInstance->_parameters.begin(); it != _currentInstance->_parameters.end(); it++)
   {
@@ -427,6 +536,8 @@ CValueArray FabricSpliceBaseInterface::getSpliceXSIPortTypeCombo()
   combo.Add(L"Mat44"); combo.Add(L"Mat44");
   combo.Add(L"Xfo"); combo.Add(L"Xfo");
   combo.Add(L"Lines"); combo.Add(L"Lines");
+  combo.Add(L"Strands"); combo.Add(L"Strands");
+  combo.Add(L"PointCloud"); combo.Add(L"PointCloud");
   combo.Add(L"PolygonMesh"); combo.Add(L"PolygonMesh");
   return combo;
 }
@@ -457,6 +568,7 @@ CValueArray FabricSpliceBaseInterface::getSpliceInternalPortTypeCombo()
 
 CStatus FabricSpliceBaseInterface::addXSIParameter(const CString &portName, const CString &dataType, const CString &portModeStr, const XSI::CString &dgNode, const FabricCore::Variant &defaultValue, const XSI::CString &extStr)
 {
+  waitForCompilation();
   FabricSplice::Port_Mode portMode = FabricSplice::Port_Mode_IN;
   if(portModeStr.IsEqualNoCase("out"))
     portMode = FabricSplice::Port_Mode_OUT;
@@ -476,6 +588,7 @@ CStatus FabricSpliceBaseInterface::addXSIParameter(const CString &portName, cons
 
 CStatus FabricSpliceBaseInterface::addXSIPort(const CRefArray &targets, const CString &portName, const CString &dataType, const FabricSplice::Port_Mode &portMode, const XSI::CString &dgNode, bool validateDataType)
 {
+  waitForCompilation();
   if(validateDataType &&
      dataType != "Boolean" && 
      dataType != "Integer" && 
@@ -492,14 +605,24 @@ CStatus FabricSpliceBaseInterface::addXSIPort(const CRefArray &targets, const CS
      dataType != "PolygonMesh" &&
      dataType != "PolygonMesh[]" &&
      dataType != "Lines" &&
-     dataType != "Lines[]")
+     dataType != "Lines[]" &&
+     dataType != "Strands" &&
+     dataType != "PointCloud")
   {
     xsiLogErrorFunc("Operator port dataType '"+dataType+"' not supported.");
     return CStatus::Unexpected;
   }
 
-  if(!addSplicePort(portName, dataType, portMode, dgNode).Succeeded())
+  // strands and point clouds are transfered as Lines and Points in KL
+  CString klDataType = dataType;
+  if(dataType == "Strands")
+    klDataType = "Lines";
+  else if(dataType == "PointCloud")
+    klDataType = "Points";
+  if(!addSplicePort(portName, klDataType, portMode, dgNode).Succeeded())
     return CStatus::Unexpected;
+  if(klDataType != dataType)
+    _spliceGraph.getDGPort(portName.GetAsciiString()).setOption("SoftimageDataType", FabricCore::Variant::CreateString(dataType.GetAsciiString()));
 
   portInfo info;
   info.realPortName = portName;
@@ -508,6 +631,7 @@ CStatus FabricSpliceBaseInterface::addXSIPort(const CRefArray &targets, const CS
   info.portMode = portMode;
   info.targets = targets.GetAsText();
   info.outPortElementsProcessed = 0;
+  info.drivesClusters = false;
   _ports.insert(std::pair<std::string, portInfo>(portName.GetAsciiString(), info));
 
   if(portMode != FabricSplice::Port_Mode_IN)
@@ -520,6 +644,7 @@ CStatus FabricSpliceBaseInterface::addXSIPort(const CRefArray &targets, const CS
 
 CStatus FabricSpliceBaseInterface::addXSIICEPort(const CRefArray &targets, const CString &portName, const CString &dataType, const CString &iceAttrName, const XSI::CString &dgNode)
 {
+  waitForCompilation();
   if(!addXSIPort(targets, portName, dataType, FabricSplice::Port_Mode_IN, dgNode, false).Succeeded())
     return CStatus::Unexpected;
   _spliceGraph.getDGPort(portName.GetAsciiString()).setOption("ICEAttribute", FabricCore::Variant::CreateString(iceAttrName.GetAsciiString()));
@@ -529,6 +654,7 @@ CStatus FabricSpliceBaseInterface::addXSIICEPort(const CRefArray &targets, const
 
 CStatus FabricSpliceBaseInterface::addSplicePort(const CString &portName, const CString &dataType, const FabricSplice::Port_Mode &portMode, const XSI::CString &dgNode, bool autoInitObjects, const FabricCore::Variant &defaultValue, const XSI::CString &extStr)
 {
+  waitForCompilation();
   if(_parameters.find(portName.GetAsciiString()) != _parameters.end())
   {
     xsiLogErrorFunc("Port '"+portName+"' already exists!");
@@ -570,6 +696,7 @@ CStatus FabricSpliceBaseInterface::addSplicePort(const CString &portName, const
 
 CStatus FabricSpliceBaseInterface::removeSplicePort(const CString &portName)
 {
+  waitForCompilation();
   XSISPLICE_CATCH_BEGIN()
 
   FabricSplice::DGPort port = _spliceGraph.getDGPort(portName.GetAsciiString());
@@ -585,6 +712,7 @@ CStatus FabricSpliceBaseInterface::removeSplicePort(const CString &portName)
     _nbOutputPorts -= portIt->second.portIndices.GetCount();
     _ports.erase(portIt);
   }
+  iceAttributeHashCache.erase(portName.GetAsciiString());
 
   _spliceGraph.removeDGNodeMember(portName.GetAsciiString(), port.getDGNodeName());
 
@@ -594,6 +722,7 @@ CStatus FabricSpliceBaseInterface::removeSplicePort(const CString &portName)
 
 CStatus FabricSpliceBaseInterface::rerouteXSIPort(const CString &portName, FabricCore::Variant &scriptArgs)
 {
+  waitForCompilation();
   XSISPLICE_CATCH_BEGIN()
 
   std::map<std::string, portInfo>::iterator portIt = _ports.find(portName.GetAsciiString());
@@ -665,6 +794,7 @@ void FabricSpliceBaseInterface::setXSIPortTargets(const CString &portName, const
 
 CString FabricSpliceBaseInterface::getParameterString()
 {
+  waitForCompilation();
   return _spliceGraph.generateKLOperatorParameterList().getStringData();
 }
 
@@ -774,6 +904,20 @@ bool FabricSpliceBaseInterface::checkEvalIDCache(LONG evalID, int &evalIDCacheIn
   return result;
 }
 
+// amount of bytes held by a port, for the profiler.
+// the geometry types query the RTVal, so this is called once the profiler scope is stopped.
+static size_t getPortBytes(FabricSplice::DGPort &port, const CString &dataType)
+{
+  bool isArray = dataType.Length() > 2 && dataType.GetSubString(dataType.Length()-2, 2) == L"[]";
+  CString singleDataType = isArray ? dataType.GetSubString(0, dataType.Length()-2) : dataType;
+  if(singleDataType == L"PolygonMesh" || singleDataType == L"Lines" || singleDataType == L"Strands" || singleDataType == L"PointCloud")
+  {
+    FabricCore::RTVal rtVal = port.getRTVal();
+    return FabricProfiler::getGeometryBytes(rtVal);
+  }
+  return FabricProfiler::getDataTypeBytes(dataType.GetAsciiString(), isArray ? port.getArrayCount() : 0);
+}
+
 bool FabricSpliceBaseInterface::transferInputPorts(XSI::CRef opRef, OperatorContext &context)
 {
   FabricSplice::Logging::AutoTimer globalTimer("XSI::transferInputPorts");
@@ -857,6 +1001,12 @@ bool FabricSpliceBaseInterface::transferInputPorts(XSI::CRef opRef, OperatorCont
   // setting to determine if we need to always convert meshes
   bool alwaysConvertMeshes = op.GetParameterValue("alwaysConvertMeshes");
 
+  // setting to transfer the mesh points as Float32 (half the bandwidth of Float64)
+  bool float32Points = op.GetParameterValue("transferPointsAsFloat32");
+  _lastTransferTime = time(NULL);
+
+  double profilerFrame = FabricProfiler::isEnabled() ? context.GetTime().GetTime(CTime::Frames) : 0.0;
+
   // Simple values are cached in the CValues cache member. we don't know how many cache values we will require
   // because this depends on the port type. We simply grow the array as we need it, and never shrink it. Every 
   // time we store a cache value, we should increment this value. 
@@ -909,12 +1059,16 @@ bool FabricSpliceBaseInterface::transferInputPorts(XSI::CRef opRef, OperatorCont
       continue;
     nodeHasInputs = true;
     std::string portName = it->first;
+    FabricProfilerScope profilerScope(_objectID, profilerFrame, FabricProfiler::EventKind_InputTransfer, portName.c_str());
 
     try
     {
       FabricSplice::DGPort splicePort = _spliceGraph.getDGPort(portName.c_str());
 
       FabricCore::Variant iceAttrName = splicePort.getOption("ICEAttribute");
+      // the offsets of a packed ICE attribute are uploaded together with its values port.
+      if(iceAttrName.isString() && splicePort.getOption("ICEAttributeOffsets").isBoolean())
+        continue;
       if(iceAttrName.isString())
       {
         Primitive prim((CRef)context.GetInputValue(it->second.realPortName+CString(CValue(CValue(0)))));
@@ -931,7 +1085,35 @@ bool FabricSpliceBaseInterface::transferInputPorts(XSI::CRef opRef, OperatorCont
         CString iceAttrStr = iceAttrName.getStringData();
         ICEAttribute iceAttr = xsiGeo.GetICEAttributeFromName(iceAttrStr);
         if(iceAttr.IsValid()){
-          convertInputICEAttribute(splicePort, it->second.dataType, iceAttr, xsiGeo);
+          // the evaluation ID changes with anything on the primitive, so only
+          // convert the attribute if its own content changed. the hash is only
+          // stored once the conversion succeeded, so a failed one is retried.
+          unsigned long long hash = 0;
+          if(!alwaysConvertMeshes && !alwaysEvaluate)
+          {
+            hash = getICEAttributeHash(iceAttr);
+            std::map<std::string, unsigned long long>::iterator hashIt = iceAttributeHashCache.find(portName);
+            if(hash != 0 && hashIt != iceAttributeHashCache.end() && hashIt->second == hash)
+              continue;
+            if(hashIt != iceAttributeHashCache.end())
+              iceAttributeHashCache.erase(hashIt);
+          }
+          std::string offsetsPortName = portName + "Offsets";
+          if(_ports.find(offsetsPortName) != _ports.end())
+          {
+            FabricSplice::DGPort offsetsPort = _spliceGraph.getDGPort(offsetsPortName.c_str());
+            if(offsetsPort.isValid() && offsetsPort.getOption("ICEAttributeOffsets").isBoolean())
+            {
+              convertInputICEAttribute(splicePort, it->second.dataType, iceAttr, xsiGeo, &offsetsPort);
+              addDirtyInput(offsetsPortName, evalContext, -1);
+            }
+            else
+              convertInputICEAttribute(splicePort, it->second.dataType, iceAttr, xsiGeo);
+          }
+          else
+            convertInputICEAttribute(splicePort, it->second.dataType, iceAttr, xsiGeo);
+          if(hash != 0)
+            iceAttributeHashCache[portName] = hash;
           addDirtyInput(portName, evalContext, -1);
           result = true;
         }
@@ -1057,8 +1239,11 @@ bool FabricSpliceBaseInterface::transferInputPorts(XSI::CRef opRef, OperatorCont
         
         PolygonMesh mesh = PolygonMesh(prim.GetGeometry().GetRef());
 
+        std::vector<LONG> * clusterEvalIDs = (alwaysConvertMeshes || alwaysEvaluate) ? NULL : &clusterEvalIDsCache[portName];
+        if(it->second.meshBuffers.size() == 0)
+          it->second.meshBuffers.resize(1);
         FabricCore::RTVal rtVal = splicePort.getRTVal();
-        convertInputPolygonMesh(mesh, rtVal);
+        convertInputPolygonMesh(mesh, rtVal, clusterEvalIDs, &it->second.meshBuffers[0], float32Points);
         splicePort.setRTVal(rtVal);
 
         addDirtyInput(portName, evalContext, -1);
@@ -1082,16 +1267,19 @@ bool FabricSpliceBaseInterface::transferInputPorts(XSI::CRef opRef, OperatorCont
           }
 
           PolygonMesh mesh = PolygonMesh(prim.GetGeometry().GetRef());
+          std::vector<LONG> * clusterEvalIDs = (alwaysConvertMeshes || alwaysEvaluate) ? NULL : &clusterEvalIDsCache[portName+"["+std::string(CString(i).GetAsciiString())+"]"];
+          if(it->second.meshBuffers.size() <= (size_t)i)
+            it->second.meshBuffers.resize(i+1);
           if(arrayVal.getArraySize() <= i)
           {
             FabricCore::RTVal rtVal;
-            convertInputPolygonMesh(mesh, rtVal);
+            convertInputPolygonMesh(mesh, rtVal, clusterEvalIDs, &it->second.meshBuffers[i], float32Points);
             arrayVal.callMethod("", "push", 1, &rtVal);
           }
           else
           {
             FabricCore::RTVal rtVal = arrayVal.getArrayElement(i);
-            convertInputPolygonMesh( mesh, rtVal);
+            convertInputPolygonMesh( mesh, rtVal, clusterEvalIDs, &it->second.meshBuffers[i], float32Points);
             arrayVal.setArrayElement(i, rtVal);
           }
           addDirtyInput(portName, evalContext, i);
@@ -1157,11 +1345,65 @@ bool FabricSpliceBaseInterface::transferInputPorts(XSI::CRef opRef, OperatorCont
         }
         splicePort.setRTVal(arrayVal);
       }
+      else if(it->second.dataType == "Strands")
+      {
+        Primitive prim;
+        if(it->second.portMode == FabricSplice::Port_Mode_IO && portName == outPortName)
+          prim = context.GetOutputTarget();
+        else
+          prim = (CRef)context.GetInputValue(portName.c_str()+CString(CValue(0)));
+
+        // Now check if the input geometry has changed scince our previous evaluation.
+        if(!alwaysConvertMeshes)
+        {
+          LONG evalID = ProjectItem(prim).GetEvaluationID();
+          if(checkEvalIDCache( evalID, evalIDCacheIndex, alwaysEvaluate))
+            continue;
+        }
+
+        FabricCore::RTVal rtVal = splicePort.getRTVal();
+        convertInputStrands(prim.GetGeometry(), rtVal);
+        splicePort.setRTVal(rtVal);
+        addDirtyInput(portName, evalContext, -1);
+        result = true;
+      }
+      else if(it->second.dataType == "PointCloud")
+      {
+        Primitive prim;
+        if(it->second.portMode == FabricSplice::Port_Mode_IO && portName == outPortName)
+          prim = context.GetOutputTarget();
+        else
+          prim = (CRef)context.GetInputValue(portName.c_str()+CString(CValue(0)));
+
+        // a single evaluation ID check covers all the attributes of the point cloud.
+        if(!alwaysConvertMeshes)
+        {
+          LONG evalID = ProjectItem(prim).GetEvaluationID();
+          if(checkEvalIDCache( evalID, evalIDCacheIndex, alwaysEvaluate))
+            continue;
+        }
+
+        CString iceAttrNames;
+        FabricCore::Variant iceAttrNamesVar = splicePort.getOption("iceAttributes");
+        if(iceAttrNamesVar.isString())
+          iceAttrNames = iceAttrNamesVar.getStringData();
+
+        FabricCore::RTVal rtVal = splicePort.getRTVal();
+        convertInputPointCloud(prim.GetGeometry(), rtVal, iceAttrNames);
+        splicePort.setRTVal(rtVal);
+        addDirtyInput(portName, evalContext, -1);
+        result = true;
+      }
       else
       {
         xsiLogErrorFunc("Skipping input port of type "+it->second.dataType);
       }
 
+      if(FabricProfiler::isEnabled())
+      {
+        profilerScope.stop();
+        profilerScope.setBytes(getPortBytes(splicePort, it->second.dataType));
+      }
     }
     catch(FabricSplice::Exception e)
     {
@@ -1199,6 +1441,9 @@ CStatus FabricSpliceBaseInterface::transferOutputPort(OperatorContext &context)
 
     FabricSplice::DGPort splicePort = _spliceGraph.getDGPort(it->first.c_str());
 
+    double profilerFrame = FabricProfiler::isEnabled() ? context.GetTime().GetTime(CTime::Frames) : 0.0;
+    FabricProfilerScope profilerScope(_objectID, profilerFrame, FabricProfiler::EventKind_OutputTransfer, outPortName.c_str());
+
     if(it->second.dataType == "Boolean" ||
        it->second.dataType == "Integer" ||
        it->second.dataType == "Scalar" ||
@@ -1319,9 +1564,18 @@ CStatus FabricSpliceBaseInterface::transferOutputPort(OperatorContext &context)
         return CStatus::Unexpected;
       }
 
-      Primitive prim(context.GetOutputTarget());
-      PolygonMesh mesh(prim.GetGeometry());
-      convertOutputPolygonMesh( mesh, rtVal);
+      ClusterProperty clusterProp(context.GetOutputTarget());
+      if(clusterProp.IsValid())
+        convertOutputPolygonMeshClusterProperty(clusterProp, rtVal);
+      else
+      {
+        Primitive prim(context.GetOutputTarget());
+        PolygonMesh mesh(prim.GetGeometry());
+        CustomOperator op(context.GetSource());
+        if(it->second.meshBuffers.size() == 0)
+          it->second.meshBuffers.resize(1);
+        convertOutputPolygonMesh( mesh, rtVal, !it->second.drivesClusters, &it->second.meshBuffers[0], bool(op.GetParameterValue("transferPointsAsFloat32")));
+      }
     }
     else if(it->second.dataType == "Lines" || it->second.dataType == "Lines[]")
     {
@@ -1366,11 +1620,56 @@ CStatus FabricSpliceBaseInterface::transferOutputPort(OperatorContext &context)
       NurbsCurveList curveList(prim.GetGeometry());
       convertOutputLines( curveList, rtVal);
     }
+    else if(it->second.dataType == "Strands")
+    {
+      FabricCore::RTVal rtVal = splicePort.getRTVal();
+      if(!rtVal.isValid() || rtVal.isNullObject())
+      {
+        xsiLogErrorFunc("Error writing to OutPort:" + CString(outPortName.c_str()) + ": Strands is not valid. Please construct the Lines holding the strands in your KL operator.");
+        return CStatus::Unexpected;
+      }
+
+      Primitive prim(context.GetOutputTarget());
+      CString errorMessage;
+      if(!convertOutputStrands(prim.GetGeometry(), rtVal, errorMessage))
+      {
+        xsiLogErrorFunc("Error writing to OutPort:" + CString(outPortName.c_str()) + ": " + errorMessage);
+        return CStatus::Unexpected;
+      }
+    }
+    else if(it->second.dataType == "PointCloud")
+    {
+      FabricCore::RTVal rtVal = splicePort.getRTVal();
+      if(!rtVal.isValid() || rtVal.isNullObject())
+      {
+        xsiLogErrorFunc("Error writing to OutPort:" + CString(outPortName.c_str()) + ": PointCloud is not valid. Please construct the Points holding the point cloud in your KL operator.");
+        return CStatus::Unexpected;
+      }
+
+      CString iceAttrNames;
+      FabricCore::Variant iceAttrNamesVar = splicePort.getOption("iceAttributes");
+      if(iceAttrNamesVar.isString())
+        iceAttrNames = iceAttrNamesVar.getStringData();
+
+      Primitive prim(context.GetOutputTarget());
+      CString errorMessage;
+      if(!convertOutputPointCloud(prim.GetGeometry(), rtVal, iceAttrNames, errorMessage))
+      {
+        xsiLogErrorFunc("Error writing to OutPort:" + CString(outPortName.c_str()) + ": " + errorMessage);
+        return CStatus::Unexpected;
+      }
+    }
     else
     {
       xsiLogErrorFunc("Skipping output port of type "+it->second.dataType);
     }
 
+    if(FabricProfiler::isEnabled())
+    {
+      profilerScope.stop();
+      profilerScope.setBytes(getPortBytes(splicePort, it->second.dataType));
+    }
+
   }
   catch(FabricSplice::Exception e)
   {
@@ -1385,6 +1684,10 @@ CStatus FabricSpliceBaseInterface::transferOutputPort(OperatorContext &context)
 
 CStatus FabricSpliceBaseInterface::evaluate()
 {
+  // the graph is owned by the compile thread
+  if(isCompiling())
+    return CStatus::OK;
+
   CRef ofRef = Application().GetObjectFromID((LONG)getObjectID());
 
   FabricSplice::Logging::AutoTimer globalTimer("XSI::evaluate");
@@ -1404,11 +1707,13 @@ CStatus FabricSpliceBaseInterface::evaluate()
 
 FabricSplice::DGGraph FabricSpliceBaseInterface::getSpliceGraph()
 {
+  waitForCompilation();
   return _spliceGraph;
 }
 
 CStatus FabricSpliceBaseInterface::addKLOperator(const CString &operatorName, const CString &operatorCode, const CString &operatorEntry, const XSI::CString &dgNode, const FabricCore::Variant &portMap)
 {
+  waitForCompilation();
   FabricSplice::Logging::AutoTimer globalTimer("XSI::addKLOperator");
   std::string localTimerName = (std::string("XSI::")+_spliceGraph.getName()+"::addKLOperator()").c_str();
   FabricSplice::Logging::AutoTimer localTimer(localTimerName);
@@ -1423,6 +1728,7 @@ CStatus FabricSpliceBaseInterface::addKLOperator(const CString &operatorName, co
 
 bool FabricSpliceBaseInterface::hasKLOperator(const XSI::CString &operatorName, const XSI::CString &dgNode)
 {
+  waitForCompilation();
   FabricSplice::Logging::AutoTimer globalTimer("XSI::hasKLOperator");
   std::string localTimerName = (std::string("XSI::")+_spliceGraph.getName()+"::hasKLOperator()").c_str();
   FabricSplice::Logging::AutoTimer localTimer(localTimerName);
@@ -1436,6 +1742,7 @@ bool FabricSpliceBaseInterface::hasKLOperator(const XSI::CString &operatorName,
 
 CString FabricSpliceBaseInterface::getKLOperatorCode(const CString &operatorName)
 {
+  waitForCompilation();
   XSISPLICE_CATCH_BEGIN()
 
   return _spliceGraph.getKLOperatorSourceCode(operatorName.GetAsciiString());
@@ -1448,6 +1755,25 @@ CStatus FabricSpliceBaseInterface::setKLOperatorCode(const CString &operatorName
 {
   XSISPLICE_CATCH_BEGIN()
 
+  // only one compilation per graph at a time
+  waitForCompilation();
+
+  CustomOperator op(Application().GetObjectFromID(_objectID));
+  bool compileInBackground = false;
+  if(op.IsValid())
+    compileInBackground = op.GetParameterValue("compileInBackground");
+
+  if(compileInBackground)
+  {
+    // the code is swapped in by the compile thread, and the
+    // operator is evaluated again once the FabricSpliceTimer
+    // event sees that the thread is done.
+    _compileStatus = L"Compiling '"+operatorName+L"'...";
+    _compileThread = new KLCompileThread(_spliceGraph, operatorName, operatorCode, operatorEntry);
+    _compileThread->start();
+    return CStatus::OK;
+  }
+
   _spliceGraph.setKLOperatorSourceCode(operatorName.GetAsciiString(), operatorCode.GetAsciiString(), operatorEntry.GetAsciiString());
   forceEvaluate();
 
@@ -1455,8 +1781,104 @@ CStatus FabricSpliceBaseInterface::setKLOperatorCode(const CString &operatorName
   return CStatus::OK;
 }
 
+bool FabricSpliceBaseInterface::isCompiling()
+{
+  return _compileThread != NULL;
+}
+
+bool FabricSpliceBaseInterface::isAnyCompiling()
+{
+  for(size_t i=0;i<_instances.size();i++)
+  {
+    if(_instances[i]->isCompiling())
+      return true;
+  }
+  return false;
+}
+
+void FabricSpliceBaseInterface::reportCompileError()
+{
+  KLCompileThread::reportErrorForCurrentThread();
+}
+
+void FabricSpliceBaseInterface::waitForCompilation()
+{
+  if(_compileThread == NULL)
+    return;
+  _compileThread->wait();
+  finishCompilation();
+}
+
+void FabricSpliceBaseInterface::finishCompilation()
+{
+  KLCompileThread * thread = _compileThread;
+  _compileThread = NULL;
+  _staleOutputsWarned = false;
+
+  CString operatorName = thread->getOperatorName().c_str();
+  CString ms((LONG)thread->getMs());
+  if(thread->hasErrors())
+    _compileStatus = L"Compiling '"+operatorName+L"' failed ("+ms+L" ms).";
+  else
+    _compileStatus = L"Compiled '"+operatorName+L"' in "+ms+L" ms.";
+  delete(thread);
+
+  CustomProperty editor = editorPropGet();
+  if(editor.IsValid() && (LONG)editor.GetParameterValue(L"objectID") == (LONG)getObjectID())
+    editor.PutParameterValue(L"compileStatus", _compileStatus);
+
+  XSISPLICE_CATCH_BEGIN()
+  forceEvaluate();
+  XSISPLICE_CATCH_END()
+}
+
+bool FabricSpliceBaseInterface::warnStaleOutputs()
+{
+  if(_staleOutputsWarned)
+    return false;
+  _staleOutputsWarned = true;
+  return true;
+}
+
+void FabricSpliceBaseInterface::processFinishedCompilations()
+{
+  for(size_t i=0;i<_instances.size();i++)
+  {
+    FabricSpliceBaseInterface * interf = _instances[i];
+    if(interf->_compileThread == NULL || !interf->_compileThread->isFinished())
+      continue;
+    interf->finishCompilation();
+  }
+}
+
+void FabricSpliceBaseInterface::releaseIdleStagingBuffers(double idleSeconds)
+{
+  time_t now = time(NULL);
+  for(size_t i=0;i<_instances.size();i++)
+  {
+    FabricSpliceBaseInterface * interf = _instances[i];
+    if(interf->_lastTransferTime == 0 || difftime(now, interf->_lastTransferTime) < idleSeconds)
+      continue;
+
+    CustomOperator op(Application().GetObjectFromID(interf->getObjectID()));
+    if(!op.IsValid() || !bool(op.GetParameterValue("releaseBuffersWhenIdle")))
+      continue;
+
+    for(std::map<std::string, portInfo>::iterator it = interf->_ports.begin(); it != interf->_ports.end(); it++)
+    {
+      for(size_t j=0;j<it->second.meshBuffers.size();j++)
+        it->second.meshBuffers[j].release();
+      it->second.meshBuffers.clear();
+    }
+
+    // nothing to release until the next evaluation.
+    interf->_lastTransferTime = 0;
+  }
+}
+
 CStatus FabricSpliceBaseInterface::setKLOperatorFile(const CString &operatorName, const CString &filename, const CString &entry)
 {
+  waitForCompilation();
   XSISPLICE_CATCH_BEGIN()
 
   _spliceGraph.setKLOperatorFilePath(operatorName.GetAsciiString(), filename.GetAsciiString(), entry.GetAsciiString());
@@ -1468,6 +1890,7 @@ CStatus FabricSpliceBaseInterface::setKLOperatorFile(const CString &operatorName
 
 CStatus FabricSpliceBaseInterface::setKLOperatorEntry(const CString &operatorName, const CString &operatorEntry)
 {
+  waitForCompilation();
   XSISPLICE_CATCH_BEGIN()
 
   _spliceGraph.setKLOperatorEntry(operatorName.GetAsciiString(), operatorEntry.GetAsciiString());
@@ -1479,6 +1902,7 @@ CStatus FabricSpliceBaseInterface::setKLOperatorEntry(const CString &operatorNam
 
 CStatus FabricSpliceBaseInterface::setKLOperatorIndex(const CString &operatorName, unsigned int operatorIndex)
 {
+  waitForCompilation();
   XSISPLICE_CATCH_BEGIN()
 
   _spliceGraph.setKLOperatorIndex(operatorName.GetAsciiString(), operatorIndex);
@@ -1489,6 +1913,7 @@ CStatus FabricSpliceBaseInterface::setKLOperatorIndex(const CString &operatorNam
 
 CStatus FabricSpliceBaseInterface::removeKLOperator(const CString &operatorName, const XSI::CString &dgNode)
 {
+  waitForCompilation();
   XSISPLICE_CATCH_BEGIN()
 
   _spliceGraph.removeKLOperator(operatorName.GetAsciiString(), dgNode.GetAsciiString());
@@ -1500,6 +1925,7 @@ CStatus FabricSpliceBaseInterface::removeKLOperator(const CString &operatorName,
 
 CStatus FabricSpliceBaseInterface::storePersistenceData(CString file)
 {
+  waitForCompilation();
   FabricSplice::Logging::AutoTimer globalTimer("XSI::storePersistenceData");
   std::string localTimerName = (std::string("XSI::")+_spliceGraph.getName()+"::storePersistenceData()").c_str();
   FabricSplice::Logging::AutoTimer localTimer(localTimerName);
@@ -1527,6 +1953,7 @@ CStatus FabricSpliceBaseInterface::storePersistenceData(CString file)
 
 CStatus FabricSpliceBaseInterface::restoreFromPersistenceData(CString file)
 {
+  waitForCompilation();
   FabricSplice::Logging::AutoTimer globalTimer("XSI::restoreFromPersistenceData");
   std::string localTimerName = (std::string("XSI::")+_spliceGraph.getName()+"::restoreFromPersistenceData()").c_str();
   FabricSplice::Logging::AutoTimer localTimer(localTimerName);
@@ -1555,6 +1982,7 @@ CStatus FabricSpliceBaseInterface::restoreFromPersistenceData(CString file)
   _parameters.clear();
   _ports.clear();
   _nbOutputPorts = 0;
+  iceAttributeHashCache.clear();
 
   CParameterRefArray params = op.GetParameters();
   for(LONG i=0;i<params.GetCount();i++)
@@ -1594,8 +2022,9 @@ CStatus FabricSpliceBaseInterface::restoreFromPersistenceData(CString file)
 
     portInfo info;
     info.outPortElementsProcessed = 0;
+    info.drivesClusters = false;
     info.realPortName = portName;
-    info.dataType = port.getDataType();
+    info.dataType = getXSIDataTypeFromPort(port);
     info.isArray = port.isArray();
     if(info.isArray)
       info.dataType += L"[]";
@@ -1633,6 +2062,12 @@ CStatus FabricSpliceBaseInterface::restoreFromPersistenceData(CString file)
         if(groupPort.GetPortType() == siPortInput)
           continue;
       }
+      // the cluster properties driven by a PolygonMesh port are not targets.
+      if(info.dataType == "PolygonMesh" && groupPortName.FindString(portName+"Cluster") == 0)
+      {
+        info.drivesClusters = true;
+        continue;
+      }
       if(groupPort.GetPortType() == siPortOutput)
         info.portIndices.Add(groupPort.GetIndex());
       targets.Add(xsiPort.GetTarget());
@@ -1652,6 +2087,7 @@ CStatus FabricSpliceBaseInterface::restoreFromPersistenceData(CString file)
 
 CStatus FabricSpliceBaseInterface::saveToFile(CString fileName)
 {
+  waitForCompilation();
   XSISPLICE_CATCH_BEGIN()
 
   FabricSplice::PersistenceInfo info;
@@ -1667,6 +2103,7 @@ CStatus FabricSpliceBaseInterface::saveToFile(CString fileName)
 
 CStatus FabricSpliceBaseInterface::loadFromFile(CString fileName, FabricCore::Variant &scriptArgs, bool hideUI)
 {
+  waitForCompilation();
   FabricSplice::Logging::AutoTimer globalTimer("XSI::loadFromFile");
   std::string localTimerName = (std::string("XSI::")+_spliceGraph.getName()+"::loadFromFile()").c_str();
   FabricSplice::Logging::AutoTimer localTimer(localTimerName);
@@ -1676,6 +2113,7 @@ CStatus FabricSpliceBaseInterface::loadFromFile(CString fileName, FabricCore::Va
   _parameters.clear();
   _ports.clear();
   _nbOutputPorts = 0;
+  iceAttributeHashCache.clear();
 
   bool skipPicking = FabricSplice::Scripting::consumeBooleanArgument(scriptArgs, "skipPicking", false, true);
 
@@ -1732,6 +2170,7 @@ CStatus FabricSpliceBaseInterface::loadFromFile(CString fileName, FabricCore::Va
       portInfo info;
       info.realPortName = portName;
       info.dataType = dataType;
+      info.drivesClusters = false;
       info.isArray = port.isArray();
       if(info.isArray)
         info.dataType += L"[]";
@@ -1774,6 +2213,7 @@ CStatus FabricSpliceBaseInterface::loadFromFile(CString fileName, FabricCore::Va
       portInfo info;
       info.realPortName = portName;
       info.dataType = dataType;
+      info.drivesClusters = false;
       info.isArray = port.isArray();
       if(info.isArray)
         info.dataType += L"[]";
@@ -1826,7 +2266,7 @@ CStatus FabricSpliceBaseInterface::loadFromFile(CString fileName, FabricCore::Va
           CString iceAttributeName = port.getOption("ICEAttribute").getStringData();
           CString errorMessage;
           CString targetDataType = getSpliceDataTypeFromICEAttribute(targetRefs, iceAttributeName, errorMessage);
-          if(targetDataType != info.dataType)
+          if(!isICEAttributePortDataType(info.dataType, targetDataType))
           {
             xsiLogErrorFunc(errorMessage);
             allConnected = false;
@@ -1884,6 +2324,7 @@ CStatus FabricSpliceBaseInterface::loadFromFile(CString fileName, FabricCore::Va
 
 CString FabricSpliceBaseInterface::getDGPortInfo()
 {
+  waitForCompilation();
   try
   {
     std::string portInfoStr = _spliceGraph.getDGPortInfo();
@@ -1914,6 +2355,7 @@ CString FabricSpliceBaseInterface::getDGPortInfo()
 
 CStatus FabricSpliceBaseInterface::disconnectForExport(XSI::CString file, Model &model)
 {
+  waitForCompilation();
   FabricSplice::Logging::AutoTimer globalTimer("XSI::disconnectForExport");
   std::string localTimerName = (std::string("XSI::")+_spliceGraph.getName()+"::disconnectForExport()").c_str();
   FabricSplice::Logging::AutoTimer localTimer(localTimerName);
@@ -2048,6 +2490,7 @@ CStatus FabricSpliceBaseInterface::disconnectForExport(XSI::CString file, Model
 
 CStatus FabricSpliceBaseInterface::reconnectForImport(Model &model)
 {
+  waitForCompilation();
   FabricSplice::Logging::AutoTimer globalTimer("XSI::reconnectForImport");
   std::string localTimerName = (std::string("XSI::")+_spliceGraph.getName()+"::reconnectForImport()").c_str();
   FabricSplice::Logging::AutoTimer localTimer(localTimerName);
@@ -2110,6 +2553,7 @@ CStatus FabricSpliceBaseInterface::reconnectForImport(Model &model)
         continue;
       portInfo info;
       info.realPortName = key.c_str();
+      info.drivesClusters = false;
       info.isArray = isArrayVar->getBoolean();
       info.portMode = (FabricSplice::Port_Mode)portModeVar->getSInt32();
       info.dataType = dataTypeVar->getStringData();
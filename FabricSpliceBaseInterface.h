@@ -14,6 +14,7 @@
 #include <xsi_model.h>
 #include <vector>
 #include <map>
+#include <ctime>
 
 #include <FabricSplice.h>
 
@@ -22,6 +23,8 @@
 #define XSISPLICE_CATCH_END_VOID() } catch(FabricSplice::Exception e){ return; }
 #define XSISPLICE_CATCH_END_CSTATUS() } catch(FabricSplice::Exception e){ return CStatus::Fail; }
 
+class KLCompileThread;
+
 class FabricSpliceBaseInterface {
 
 public:
@@ -65,6 +68,19 @@ public:
   bool hasKLOperator(const XSI::CString &operatorName, const XSI::CString &dgNode);
   XSI::CString getKLOperatorCode(const XSI::CString &operatorName);
   XSI::CStatus setKLOperatorCode(const XSI::CString &operatorName, const XSI::CString &operatorCode, const XSI::CString &operatorEntry);
+  bool isCompiling();
+  static bool isAnyCompiling();
+  // blocks until the background compilation of this graph (if any) is done.
+  void waitForCompilation();
+  // returns true once per background compilation, to warn about stale outputs.
+  bool warnStaleOutputs();
+  XSI::CString getCompileStatus() { return _compileStatus; }
+  static void processFinishedCompilations();
+  // called by the error log callbacks, flags the compilation running on the current thread as failed.
+  static void reportCompileError();
+  // releases the mesh staging buffers of the operators idle for more than idleSeconds
+  // (only for the ones with the releaseBuffersWhenIdle parameter enabled).
+  static void releaseIdleStagingBuffers(double idleSeconds);
   XSI::CStatus setKLOperatorFile(const XSI::CString &operatorName, const XSI::CString &filename, const XSI::CString &entry);
   XSI::CStatus setKLOperatorEntry(const XSI::CString &operatorName, const XSI::CString &operatorEntry);
   XSI::CStatus setKLOperatorIndex(const XSI::CString &operatorName, unsigned int operatorIndex);
@@ -112,6 +128,8 @@ protected:
     XSI::CString targets;
     XSI::CLongArray portIndices;
     LONG outPortElementsProcessed;
+    bool drivesClusters;  // PolygonMesh output with the 'driveClusters' option, also writing the UV / vertex color cluster properties
+    std::vector<meshStagingBuffers> meshBuffers;  // per array element, reused between evaluations
   };
 
   std::map<std::string, parameterInfo> _parameters;
@@ -121,9 +139,21 @@ protected:
 
   std::vector< std::vector<XSI::CValue> > valuesCache;
   std::vector<LONG> evalIDsCache;
+  // evaluation IDs of the UV / color cluster properties of the input meshes, per port (and array index).
+  std::map<std::string, std::vector<LONG> > clusterEvalIDsCache;
+  // content hashes of the ICE attributes read by the ICE ports, per port.
+  std::map<std::string, unsigned long long> iceAttributeHashCache;
+  // last time the ports were transfered, to release the staging buffers when idle
+  time_t _lastTransferTime;
 
   FabricCore::RTVal iceNodeRTVal;
 
+  // background compilation of KL operators (see compileInBackground parameter)
+  KLCompileThread * _compileThread;
+  XSI::CString _compileStatus;
+  bool _staleOutputsWarned;
+  void finishCompilation();
+
   void addDirtyInput(std::string portName, FabricCore::RTVal evalContext, int index);
   bool checkIfValueChangedAndDirtyInput(XSI::CValue value, std::vector<XSI::CValue> &cachedValues, bool alwaysEvaluate, std::string portName, FabricCore::RTVal evalContext, int index);
   bool checkEvalIDCache(LONG evalID, int &evalIDCacheIndex, bool alwaysEvaluate);
@@ -26,6 +26,7 @@
 #include "FabricSpliceCommands.h"
 #include "FabricSpliceBaseInterface.h"
 #include "FabricSpliceRenderPass.h"
+#include "FabricProfiler.h"
 
 using namespace XSI;
 
@@ -112,6 +113,22 @@ SICALLBACK fabricSplice_Execute(CRef & in_ctxt)
       {
         FabricSplice::Logging::resetTimer(FabricSplice::Logging::getTimerName(i));
       }    
+      FabricProfiler::start();
+      getFloat32PointsBytesSaved(true);
+      return xsiErrorOccured();
+    }
+    else if(actionStr.IsEqualNoCase("benchmarkConversion"))
+    {
+      // reference: the objects to convert, data: the number of iterations,
+      // auxiliary: an optional ICE attribute name to benchmark instead of the geometry.
+      CRefArray targetRefs = getCRefArrayFromCString(referenceStr);
+      if(targetRefs.GetCount() == 0)
+      {
+        xsiLogErrorFunc("benchmarkConversion requires the objects to convert as reference.");
+        return CStatus::InvalidArgument;
+      }
+      int iterations = dataStr.IsEmpty() ? 10 : atoi(dataStr.GetAsciiString());
+      benchmarkInputConversion(targetRefs, iterations, auxiliaryStr);
       return xsiErrorOccured();
     }
     else if(actionStr.IsEqualNoCase("stopProfiling"))
@@ -121,6 +138,42 @@ SICALLBACK fabricSplice_Execute(CRef & in_ctxt)
         FabricSplice::Logging::logTimer(FabricSplice::Logging::getTimerName(i));
       }    
       FabricSplice::Logging::disableTimers();
+      FabricProfiler::stop();
+      FabricProfiler::logReport();
+
+      size_t float32BytesSaved = getFloat32PointsBytesSaved(true);
+      if(float32BytesSaved > 0)
+        xsiLogFunc("Float32 point transfers saved "+CString((LONG)(float32BytesSaved / 1024))+" KB of bandwidth.");
+
+      // optionally export the per operator profile.
+      // reference: the file name, data: the format ("csv", "json" or "trace").
+      if(!referenceStr.IsEmpty())
+      {
+        CString formatStr = dataStr;
+        if(formatStr.IsEmpty())
+        {
+          formatStr = L"json";
+          if(referenceStr.Length() > 4 && referenceStr.GetSubString(referenceStr.Length()-4, 4).IsEqualNoCase(L".csv"))
+            formatStr = L"csv";
+        }
+
+        bool exported = false;
+        if(formatStr.IsEqualNoCase(L"csv"))
+          exported = FabricProfiler::exportCSV(referenceStr.GetAsciiString());
+        else if(formatStr.IsEqualNoCase(L"json"))
+          exported = FabricProfiler::exportJSON(referenceStr.GetAsciiString());
+        else if(formatStr.IsEqualNoCase(L"trace"))
+          exported = FabricProfiler::exportChromeTrace(referenceStr.GetAsciiString());
+        else
+        {
+          xsiLogErrorFunc("Unknown profiling export format '"+formatStr+"', use 'csv', 'json' or 'trace'.");
+          return CStatus::InvalidArgument;
+        }
+        if(!exported)
+          xsiLogErrorFunc("Unable to write profiling file '"+referenceStr+"'.");
+        else
+          xsiLogFunc("Profiling written to '"+referenceStr+"'.");
+      }
       return xsiErrorOccured();
     }
 
@@ -348,9 +401,14 @@ SICALLBACK fabricSplice_Execute(CRef & in_ctxt)
           }
         }
 
+        // a flat port on a 2D ICE attribute receives the packed values, plus an offsets port.
+        bool packedICEAttribute = false;
+        if(!iceAttrStr.IsEmpty() && !dataTypeStr.IsEmpty() && dataTypeStr != targetDataType)
+          packedICEAttribute = dataTypeStr + "[]" == targetDataType && isICEAttributePortDataType(dataTypeStr, targetDataType);
+
         if(!dataTypeStr.IsEmpty())
         {
-          if(dataTypeStr != targetDataType && dataTypeStr != targetDataType + "[]")
+          if(dataTypeStr != targetDataType && dataTypeStr != targetDataType + "[]" && !packedICEAttribute)
           {
             xsiLogErrorFunc("Unable to connect port to targets. The data types do not match. Port Data Type:'" + dataTypeStr + "', Target Data Type:'" + targetDataType + "'.");
             return CStatus::Unexpected;
@@ -369,6 +427,14 @@ SICALLBACK fabricSplice_Execute(CRef & in_ctxt)
           status = interf->addXSIICEPort(targetRefs, processNameCString(portNameStr), targetDataType, iceAttrStr, processNameCString(dgNodeStr));
           if(!status.Succeeded())
             return status;
+          if(packedICEAttribute)
+          {
+            CString offsetsPortName = processNameCString(portNameStr + L"Offsets");
+            status = interf->addXSIICEPort(targetRefs, offsetsPortName, L"Integer[]", iceAttrStr, processNameCString(dgNodeStr));
+            if(!status.Succeeded())
+              return status;
+            interf->getSpliceGraph().getDGPort(offsetsPortName.GetAsciiString()).setOption("ICEAttributeOffsets", FabricCore::Variant::CreateBoolean(true));
+          }
         }
 
         // add all additional arguments as flags on the port
@@ -1,6 +1,8 @@
 
 #include "FabricSpliceConversion.h"
+#include "FabricSpliceConversionKernels.h"
 #include "FabricSplicePlugin.h"
+#include "FabricProfiler.h"
 
 #ifdef _WIN32
   #include <windows.h>
@@ -20,6 +22,7 @@
 #include <xsi_comapihandler.h>
 #include <xsi_x3dobject.h>
 #include <xsi_polygonmesh.h>
+#include <xsi_cluster.h>
 #include <xsi_geometryaccessor.h>
 #include <xsi_polygonface.h>
 #include <xsi_polygonnode.h>
@@ -31,9 +34,16 @@
 #include <xsi_controlpoint.h>
 #include <xsi_geometryaccessor.h>
 #include <xsi_group.h>
+#include <xsi_projectitem.h>
 #include <xsi_iceattributedataarray2D.h>
+#include <xsi_boolarray.h>
+#include <xsi_doublearray.h>
 
 #include <algorithm>
+#include <sstream>
+#include <iomanip>
+
+#include <QtCore/QElapsedTimer>
 
 using namespace XSI;
 
@@ -170,6 +180,12 @@ CString getSpliceDataTypeFromRef(const CRef &ref, const CString & portType)
     return "PolygonMesh";
   if(Primitive(ref).GetType().IsEqualNoCase("crvlist"))
     return "Lines";
+  if(Primitive(ref).GetType().IsEqualNoCase("pointcloud"))
+  {
+    if(portType != L"PointCloud" && Primitive(ref).GetGeometry().GetICEAttributeFromName(L"StrandPosition").IsValid())
+      return "Strands";
+    return "PointCloud";
+  }
   
   Parameter param(ref);
   if(param.IsValid())
@@ -219,6 +235,14 @@ CString getSpliceDataTypeFromRef(const CRef &ref, const CString & portType)
   return CString();
 }
 
+CString getXSIDataTypeFromPort(FabricSplice::DGPort & port)
+{
+  FabricCore::Variant xsiDataType = port.getOption("SoftimageDataType");
+  if(xsiDataType.isString())
+    return xsiDataType.getStringData();
+  return port.getDataType();
+}
+
 CString getSpliceDataTypeFromICEAttribute(const CRefArray &refs, const CString & iceAttrName, CString & errorMessage)
 {
   if(refs.GetCount() > 1)
@@ -285,8 +309,298 @@ CString getSpliceDataTypeFromICEAttribute(const CRefArray &refs, const CString &
   return L"";
 }
 
-void convertInputICEAttribute(FabricSplice::DGPort & port, CString dataType, ICEAttribute & attr, XSI::Geometry & geo)
+template<class ARRAY>
+static unsigned long long hashICEAttributeValues(ICEAttribute & attr, size_t elementBytes)
+{
+  ARRAY xsiValues;
+  attr.GetDataArray(xsiValues);
+  if(xsiValues.GetCount() == 0)
+    return 0;
+  return hashBytes(&xsiValues[0], elementBytes * xsiValues.GetCount(), xsiValues.GetCount());
+}
+
+template<class ARRAY2D, class ARRAY>
+static unsigned long long hashICEAttributeValues2D(ICEAttribute & attr, size_t elementBytes)
+{
+  ARRAY2D xsiValues;
+  ARRAY xsiSubValues;
+  attr.GetDataArray2D(xsiValues);
+  unsigned long long h = xsiValues.GetCount();
+  for(ULONG i=0;i<xsiValues.GetCount();i++)
+  {
+    xsiValues.GetSubArray(i, xsiSubValues);
+    // the count is part of the seed, so moving values between elements changes the hash.
+    if(xsiSubValues.GetCount() == 0)
+      h = hashBytes(NULL, 0, h + 1);
+    else
+      h = hashBytes(&xsiSubValues[0], elementBytes * xsiSubValues.GetCount(), h + xsiSubValues.GetCount());
+  }
+  return h;
+}
+
+unsigned long long getICEAttributeHash(ICEAttribute & attr)
+{
+  if(attr.GetStructureType() == siICENodeStructureSingle)
+  {
+    switch(attr.GetDataType())
+    {
+      case siICENodeDataLong:       return hashICEAttributeValues<CICEAttributeDataArrayLong>(attr, sizeof(LONG));
+      case siICENodeDataFloat:      return hashICEAttributeValues<CICEAttributeDataArrayFloat>(attr, sizeof(float));
+      case siICENodeDataVector2:    return hashICEAttributeValues<CICEAttributeDataArrayVector2f>(attr, sizeof(float) * 2);
+      case siICENodeDataVector3:    return hashICEAttributeValues<CICEAttributeDataArrayVector3f>(attr, sizeof(float) * 3);
+      case siICENodeDataQuaternion: return hashICEAttributeValues<CICEAttributeDataArrayQuaternionf>(attr, sizeof(MATH::CQuaternionf));
+      case siICENodeDataMatrix44:   return hashICEAttributeValues<CICEAttributeDataArrayMatrix4f>(attr, sizeof(MATH::CMatrix4f));
+      case siICENodeDataColor4:     return hashICEAttributeValues<CICEAttributeDataArrayColor4f>(attr, sizeof(float) * 4);
+      case siICENodeDataString:
+      {
+        CICEAttributeDataArrayString xsiValues;
+        attr.GetDataArray(xsiValues);
+        unsigned long long h = xsiValues.GetCount();
+        for(ULONG i=0;i<xsiValues.GetCount();i++)
+        {
+          CString value = xsiValues[i];
+          h = hashBytes(value.GetAsciiString(), strlen(value.GetAsciiString()), h);
+        }
+        return h;
+      }
+      default: break;
+    }
+  }
+  else if(attr.GetStructureType() == siICENodeStructureArray)
+  {
+    switch(attr.GetDataType())
+    {
+      case siICENodeDataLong:       return hashICEAttributeValues2D<CICEAttributeDataArray2DLong, CICEAttributeDataArrayLong>(attr, sizeof(LONG));
+      case siICENodeDataFloat:      return hashICEAttributeValues2D<CICEAttributeDataArray2DFloat, CICEAttributeDataArrayFloat>(attr, sizeof(float));
+      case siICENodeDataVector2:    return hashICEAttributeValues2D<CICEAttributeDataArray2DVector2f, CICEAttributeDataArrayVector2f>(attr, sizeof(float) * 2);
+      case siICENodeDataVector3:    return hashICEAttributeValues2D<CICEAttributeDataArray2DVector3f, CICEAttributeDataArrayVector3f>(attr, sizeof(float) * 3);
+      case siICENodeDataQuaternion: return hashICEAttributeValues2D<CICEAttributeDataArray2DQuaternionf, CICEAttributeDataArrayQuaternionf>(attr, sizeof(MATH::CQuaternionf));
+      case siICENodeDataMatrix44:   return hashICEAttributeValues2D<CICEAttributeDataArray2DMatrix4f, CICEAttributeDataArrayMatrix4f>(attr, sizeof(MATH::CMatrix4f));
+      case siICENodeDataColor4:     return hashICEAttributeValues2D<CICEAttributeDataArray2DColor4f, CICEAttributeDataArrayColor4f>(attr, sizeof(float) * 4);
+      default: break;
+    }
+  }
+  // unsupported types are never considered unchanged.
+  return 0;
+}
+
+template<class ARRAY>
+static void getICEAttributeDataPointer(ICEAttribute & attr, const void *& data, unsigned int & count)
+{
+  ARRAY xsiValues;
+  attr.GetDataArray(xsiValues);
+  count = xsiValues.GetCount();
+  data = count > 0 ? (const void *)&xsiValues[0] : NULL;
+}
+
+// a constant ICE attribute only holds one value, it is repeated for all elements into buffer.
+static void expandConstantICEAttribute(const void * value, size_t floatsPerElement, ULONG elementCount, std::vector<float> & buffer)
+{
+  buffer.resize(elementCount * floatsPerElement);
+  for(ULONG i=0;i<elementCount;i++)
+    memcpy(&buffer[i * floatsPerElement], value, sizeof(float) * floatsPerElement);
+}
+
+bool getICEAttributeExternalArray(ICEAttribute & attr, const std::string & klDataType, const void *& data, unsigned int & count, std::vector<float> & buffer, bool convert)
+{
+  data = NULL;
+  count = 0;
+  if(attr.GetStructureType() != siICENodeStructureSingle)
+    return false;
+
+  // the hash of a constant attribute doesn't change with the amount of elements.
+  bool isConstant = attr.IsConstant();
+  ULONG elementCount = attr.GetElementCount();
+
+  siICENodeDataType dataType = attr.GetDataType();
+  size_t floatsPerElement = 0;
+  if((klDataType == "Integer" || klDataType == "SInt32") && dataType == siICENodeDataLong)
+  {
+    getICEAttributeDataPointer<CICEAttributeDataArrayLong>(attr, data, count);
+    floatsPerElement = 1;
+  }
+  else if((klDataType == "Scalar" || klDataType == "Float32") && dataType == siICENodeDataFloat)
+  {
+    getICEAttributeDataPointer<CICEAttributeDataArrayFloat>(attr, data, count);
+    floatsPerElement = 1;
+  }
+  else if(klDataType == "Vec2" && dataType == siICENodeDataVector2)
+  {
+    getICEAttributeDataPointer<CICEAttributeDataArrayVector2f>(attr, data, count);
+    floatsPerElement = 2;
+  }
+  else if(klDataType == "Vec3" && dataType == siICENodeDataVector3)
+  {
+    getICEAttributeDataPointer<CICEAttributeDataArrayVector3f>(attr, data, count);
+    floatsPerElement = 3;
+  }
+  else if(klDataType == "Color" && dataType == siICENodeDataColor4)
+  {
+    getICEAttributeDataPointer<CICEAttributeDataArrayColor4f>(attr, data, count);
+    floatsPerElement = 4;
+  }
+  else if(klDataType == "Quat" && dataType == siICENodeDataQuaternion)
+  {
+    // the buffer still holds the values of the previous conversion if convert is false.
+    if(convert || (isConstant && buffer.size() != elementCount * 4))
+    {
+      CICEAttributeDataArrayQuaternionf xsiValues;
+      attr.GetDataArray(xsiValues);
+      if(isConstant && xsiValues.GetCount() > 0)
+      {
+        float value[4];
+        convertICEQuaternionsToKL(&xsiValues[0], value, 1);
+        expandConstantICEAttribute(value, 4, elementCount, buffer);
+      }
+      else
+      {
+        buffer.resize(xsiValues.GetCount() * 4);
+        if(xsiValues.GetCount() > 0)
+          convertICEQuaternionsToKL(&xsiValues[0], &buffer[0], xsiValues.GetCount());
+      }
+    }
+    count = (unsigned int)(buffer.size() / 4);
+    data = count > 0 ? (const void *)&buffer[0] : NULL;
+    return true;
+  }
+  else if(klDataType == "Mat44" && dataType == siICENodeDataMatrix44)
+  {
+    if(convert || (isConstant && buffer.size() != elementCount * 16))
+    {
+      CICEAttributeDataArrayMatrix4f xsiValues;
+      attr.GetDataArray(xsiValues);
+      if(isConstant && xsiValues.GetCount() > 0)
+      {
+        float value[16];
+        convertICEMatricesToKL(&xsiValues[0], value, 1);
+        expandConstantICEAttribute(value, 16, elementCount, buffer);
+      }
+      else
+      {
+        buffer.resize(xsiValues.GetCount() * 16);
+        if(xsiValues.GetCount() > 0)
+          convertICEMatricesToKL(&xsiValues[0], &buffer[0], xsiValues.GetCount());
+      }
+    }
+    count = (unsigned int)(buffer.size() / 16);
+    data = count > 0 ? (const void *)&buffer[0] : NULL;
+    return true;
+  }
+  else
+    return false;
+
+  // the other types reference the ICE memory, unless the attribute is constant.
+  if(isConstant && count > 0)
+  {
+    if(convert || buffer.size() != elementCount * floatsPerElement)
+      expandConstantICEAttribute(data, floatsPerElement, elementCount, buffer);
+    count = (unsigned int)(buffer.size() / floatsPerElement);
+    data = count > 0 ? (const void *)&buffer[0] : NULL;
+  }
+  return true;
+}
+
+bool isICEAttributePortDataType(const CString & portDataType, const CString & attrDataType)
+{
+  if(portDataType == attrDataType)
+    return true;
+  if(attrDataType.Length() < 4 || attrDataType.GetSubString(attrDataType.Length() - 4, 4) != L"[][]")
+    return false;
+  // packed values or the offsets of a 2D attribute
+  if(portDataType + L"[]" == attrDataType && portDataType != L"String[]")
+    return true;
+  return portDataType == L"Integer[]";
+}
+
+// appends the sub arrays of a 2D ICE attribute to a single buffer, and records the start
+// of each element (plus the end) in offsets.
+template<class ARRAY2D, class ARRAY>
+static void packICEAttributeValues(ICEAttribute & attr, size_t elementBytes, std::vector<char> & packed, std::vector<int32_t> & offsets)
+{
+  ARRAY2D xsiValues;
+  ARRAY xsiSubValues;
+  attr.GetDataArray2D(xsiValues);
+  offsets.resize(xsiValues.GetCount() + 1);
+  offsets[0] = 0;
+  for(ULONG i=0;i<xsiValues.GetCount();i++)
+  {
+    xsiValues.GetSubArray(i, xsiSubValues);
+    offsets[i+1] = offsets[i] + (int32_t)xsiSubValues.GetCount();
+    if(xsiSubValues.GetCount() == 0)
+      continue;
+    size_t offset = packed.size();
+    packed.resize(offset + elementBytes * xsiSubValues.GetCount());
+    memcpy(&packed[offset], &xsiSubValues[0], elementBytes * xsiSubValues.GetCount());
+  }
+}
+
+// uploads all sub arrays of a 2D ICE attribute into a flat port with a single call,
+// and their offsets into offsetsPort (if any) from the same pass.
+static void convertInputPackedICEAttribute(FabricSplice::DGPort & port, const CString & dataType, ICEAttribute & attr, FabricSplice::DGPort * offsetsPort)
+{
+  std::vector<char> packed;
+  std::vector<int32_t> offsets(1, 0);
+  if(attr.GetDataType() == siICENodeDataLong && dataType == L"Integer[]")
+    packICEAttributeValues<CICEAttributeDataArray2DLong, CICEAttributeDataArrayLong>(attr, sizeof(int32_t), packed, offsets);
+  else if(attr.GetDataType() == siICENodeDataFloat && dataType == L"Scalar[]")
+    packICEAttributeValues<CICEAttributeDataArray2DFloat, CICEAttributeDataArrayFloat>(attr, sizeof(float), packed, offsets);
+  else if(attr.GetDataType() == siICENodeDataVector2 && dataType == L"Vec2[]")
+    packICEAttributeValues<CICEAttributeDataArray2DVector2f, CICEAttributeDataArrayVector2f>(attr, sizeof(float) * 2, packed, offsets);
+  else if(attr.GetDataType() == siICENodeDataVector3 && dataType == L"Vec3[]")
+    packICEAttributeValues<CICEAttributeDataArray2DVector3f, CICEAttributeDataArrayVector3f>(attr, sizeof(float) * 3, packed, offsets);
+  else if(attr.GetDataType() == siICENodeDataColor4 && dataType == L"Color[]")
+    packICEAttributeValues<CICEAttributeDataArray2DColor4f, CICEAttributeDataArrayColor4f>(attr, sizeof(float) * 4, packed, offsets);
+  else if(attr.GetDataType() == siICENodeDataQuaternion && dataType == L"Quat[]")
+  {
+    CICEAttributeDataArray2DQuaternionf xsiValues;
+    CICEAttributeDataArrayQuaternionf xsiSubValues;
+    attr.GetDataArray2D(xsiValues);
+    offsets.resize(xsiValues.GetCount() + 1);
+    for(ULONG i=0;i<xsiValues.GetCount();i++)
+    {
+      xsiValues.GetSubArray(i, xsiSubValues);
+      offsets[i+1] = offsets[i] + (int32_t)xsiSubValues.GetCount();
+      if(xsiSubValues.GetCount() == 0)
+        continue;
+      size_t offset = packed.size();
+      packed.resize(offset + sizeof(float) * 4 * xsiSubValues.GetCount());
+      convertICEQuaternionsToKL(&xsiSubValues[0], (float*)&packed[offset], xsiSubValues.GetCount());
+    }
+  }
+  else if(attr.GetDataType() == siICENodeDataMatrix44 && dataType == L"Mat44[]")
+  {
+    CICEAttributeDataArray2DMatrix4f xsiValues;
+    CICEAttributeDataArrayMatrix4f xsiSubValues;
+    attr.GetDataArray2D(xsiValues);
+    offsets.resize(xsiValues.GetCount() + 1);
+    for(ULONG i=0;i<xsiValues.GetCount();i++)
+    {
+      xsiValues.GetSubArray(i, xsiSubValues);
+      offsets[i+1] = offsets[i] + (int32_t)xsiSubValues.GetCount();
+      if(xsiSubValues.GetCount() == 0)
+        continue;
+      size_t offset = packed.size();
+      packed.resize(offset + sizeof(float) * 16 * xsiSubValues.GetCount());
+      convertICEMatricesToKL(&xsiSubValues[0], (float*)&packed[offset], xsiSubValues.GetCount());
+    }
+  }
+  else
+    return;
+
+  port.setArrayData(packed.size() > 0 ? &packed[0] : NULL, packed.size());
+  if(offsetsPort)
+    offsetsPort->setArrayData(&offsets[0], sizeof(int32_t) * offsets.size());
+}
+
+void convertInputICEAttribute(FabricSplice::DGPort & port, CString dataType, ICEAttribute & attr, XSI::Geometry & geo, FabricSplice::DGPort * offsetsPort)
 {
+  // a flat port on a 2D attribute receives the packed values
+  if(attr.GetStructureType() == siICENodeStructureArray && dataType.GetSubString(dataType.Length() - 4, 4) != L"[][]")
+  {
+    convertInputPackedICEAttribute(port, dataType, attr, offsetsPort);
+    return;
+  }
+
   if(attr.GetStructureType() == siICENodeStructureSingle)
   {
     if(attr.GetDataType() == siICENodeDataLong && dataType == L"Integer[]")
@@ -331,14 +645,8 @@ void convertInputICEAttribute(FabricSplice::DGPort & port, CString dataType, ICE
       CICEAttributeDataArrayQuaternionf xsiValues;
       attr.GetDataArray(xsiValues);
       std::vector<float> portValues(xsiValues.GetCount()*4);
-      size_t offset = 0;
-      for(LONG i=0;i<xsiValues.GetCount();i++)
-      {
-        portValues[offset++] = xsiValues[i].GetX();
-        portValues[offset++] = xsiValues[i].GetY();
-        portValues[offset++] = xsiValues[i].GetZ();
-        portValues[offset++] = xsiValues[i].GetW();
-      }
+      if(xsiValues.GetCount() > 0)
+        convertICEQuaternionsToKL(&xsiValues[0], &portValues[0], xsiValues.GetCount());
       port.setArrayData(&portValues[0], sizeof(float) * portValues.size());
     }
     else if(attr.GetDataType() == siICENodeDataMatrix44 && dataType == L"Mat44[]")
@@ -346,26 +654,8 @@ void convertInputICEAttribute(FabricSplice::DGPort & port, CString dataType, ICE
       CICEAttributeDataArrayMatrix4f xsiValues;
       attr.GetDataArray(xsiValues);
       std::vector<float> portValues(xsiValues.GetCount()*16);
-      size_t offset = 0;
-      for(LONG i=0;i<xsiValues.GetCount();i++)
-      {
-        portValues[offset++] = xsiValues[i].GetValue(0, 0);
-        portValues[offset++] = xsiValues[i].GetValue(1, 0);
-        portValues[offset++] = xsiValues[i].GetValue(2, 0);
-        portValues[offset++] = xsiValues[i].GetValue(3, 0);
-        portValues[offset++] = xsiValues[i].GetValue(0, 1);
-        portValues[offset++] = xsiValues[i].GetValue(1, 1);
-        portValues[offset++] = xsiValues[i].GetValue(2, 1);
-        portValues[offset++] = xsiValues[i].GetValue(3, 1);
-        portValues[offset++] = xsiValues[i].GetValue(0, 2);
-        portValues[offset++] = xsiValues[i].GetValue(1, 2);
-        portValues[offset++] = xsiValues[i].GetValue(2, 2);
-        portValues[offset++] = xsiValues[i].GetValue(3, 2);
-        portValues[offset++] = xsiValues[i].GetValue(0, 3);
-        portValues[offset++] = xsiValues[i].GetValue(1, 3);
-        portValues[offset++] = xsiValues[i].GetValue(2, 3);
-        portValues[offset++] = xsiValues[i].GetValue(3, 3);
-      }
+      if(xsiValues.GetCount() > 0)
+        convertICEMatricesToKL(&xsiValues[0], &portValues[0], xsiValues.GetCount());
       port.setArrayData(&portValues[0], sizeof(float) * portValues.size());
     }
     else if(attr.GetDataType() == siICENodeDataColor4 && dataType == L"Color[]")
@@ -513,15 +803,9 @@ void convertInputICEAttribute(FabricSplice::DGPort & port, CString dataType, ICE
       {
         xsiValues.GetSubArray(i, xsiSubValues);
 
-        size_t offset = 0;
         std::vector<float> portValues(xsiSubValues.GetCount() * 4);
-        for(size_t j=0;j<xsiSubValues.GetCount();j++)
-        {
-          portValues[offset++] = xsiSubValues[j].GetX();
-          portValues[offset++] = xsiSubValues[j].GetY();
-          portValues[offset++] = xsiSubValues[j].GetZ();
-          portValues[offset++] = xsiSubValues[j].GetW();
-        }
+        if(xsiSubValues.GetCount() > 0)
+          convertICEQuaternionsToKL(&xsiSubValues[0], &portValues[0], xsiSubValues.GetCount());
 
         FabricCore::RTVal element = value.getArrayElement(i);
         element.setArraySize(xsiSubValues.GetCount());
@@ -547,27 +831,9 @@ void convertInputICEAttribute(FabricSplice::DGPort & port, CString dataType, ICE
       {
         xsiValues.GetSubArray(i, xsiSubValues);
 
-        size_t offset = 0;
         std::vector<float> portValues(xsiSubValues.GetCount() * 16);
-        for(size_t j=0;j<xsiSubValues.GetCount();j++)
-        {
-          portValues[offset++] = xsiSubValues[j].GetValue(0, 0);
-          portValues[offset++] = xsiSubValues[j].GetValue(1, 0);
-          portValues[offset++] = xsiSubValues[j].GetValue(2, 0);
-          portValues[offset++] = xsiSubValues[j].GetValue(3, 0);
-          portValues[offset++] = xsiSubValues[j].GetValue(0, 1);
-          portValues[offset++] = xsiSubValues[j].GetValue(1, 1);
-          portValues[offset++] = xsiSubValues[j].GetValue(2, 1);
-          portValues[offset++] = xsiSubValues[j].GetValue(3, 1);
-          portValues[offset++] = xsiSubValues[j].GetValue(0, 2);
-          portValues[offset++] = xsiSubValues[j].GetValue(1, 2);
-          portValues[offset++] = xsiSubValues[j].GetValue(2, 2);
-          portValues[offset++] = xsiSubValues[j].GetValue(3, 2);
-          portValues[offset++] = xsiSubValues[j].GetValue(0, 3);
-          portValues[offset++] = xsiSubValues[j].GetValue(1, 3);
-          portValues[offset++] = xsiSubValues[j].GetValue(2, 3);
-          portValues[offset++] = xsiSubValues[j].GetValue(3, 3);
-        }
+        if(xsiSubValues.GetCount() > 0)
+          convertICEMatricesToKL(&xsiSubValues[0], &portValues[0], xsiSubValues.GetCount());
 
         FabricCore::RTVal element = value.getArrayElement(i);
         element.setArraySize(xsiSubValues.GetCount());
@@ -619,11 +885,59 @@ X3DObject getX3DObjectFromRef(const CRef &ref)
   return getX3DObjectFromRef(obj.GetParent());
 }
 
-void convertInputPolygonMesh(PolygonMesh mesh, FabricCore::RTVal & rtVal)
+std::string getExtraNodeSetAttributeName(const CString & clusterPropertyName, bool isUVWs)
+{
+  return std::string(isUVWs ? "uvw_" : "color_") + clusterPropertyName.GetAsciiString();
+}
+
+// sets a named Vec3 (UVs) or Color attribute of a PolygonMesh from the values of a cluster property
+// (see getExtraNodeSetAttributeName()).
+static void setPolygonMeshAttributeFromClusterValues(FabricCore::RTVal & rtVal, const CString & name, bool isUVs, CFloatArray & values)
+{
+  FabricCore::RTVal nameVal = FabricSplice::constructStringRTVal(getExtraNodeSetAttributeName(name, isUVs).c_str());
+  FabricCore::RTVal attributes = rtVal.callMethod("GeometryAttributes", "getAttributes", 0, 0);
+  if(isUVs)
+    attributes.callMethod("Vec3Attribute", "getOrCreateVec3Attribute", 1, &nameVal);
+  else
+    attributes.callMethod("ColorAttribute", "getOrCreateColorAttribute", 1, &nameVal);
+
+  std::vector<FabricCore::RTVal> args(2);
+  args[0] = nameVal;
+  args[1] = FabricSplice::constructExternalArrayRTVal(isUVs ? "Vec3" : "Color", values.GetCount() / (isUVs ? 3 : 4), &values[0]);
+  rtVal.callMethod("", "setAttributeFromPolygonPackedData", 2, &args[0]);
+}
+
+// returns true if the cluster property at the given slot has changed since the previous conversion.
+static bool hasClusterPropertyChanged(ClusterProperty & prop, size_t slot, std::vector<LONG> *clusterEvalIDs, bool requireTopoUpdate)
+{
+  if(!clusterEvalIDs)
+    return true;
+  if(clusterEvalIDs->size() <= slot)
+    clusterEvalIDs->resize(slot+1, -1);
+  LONG evalID = ProjectItem(prop).GetEvaluationID();
+  bool changed = requireTopoUpdate || (*clusterEvalIDs)[slot] != evalID;
+  (*clusterEvalIDs)[slot] = evalID;
+  return changed;
+}
+
+static size_t gFloat32PointsBytesSaved = 0;
+
+size_t getFloat32PointsBytesSaved(bool reset)
+{
+  size_t bytes = gFloat32PointsBytesSaved;
+  if(reset)
+    gFloat32PointsBytesSaved = 0;
+  return bytes;
+}
+
+void convertInputPolygonMesh(PolygonMesh mesh, FabricCore::RTVal & rtVal, std::vector<LONG> *clusterEvalIDs, meshStagingBuffers *buffers, bool float32Points)
 {
   if(!rtVal.isValid() || rtVal.isNullObject())
     rtVal = FabricSplice::constructObjectRTVal("PolygonMesh");
   
+  meshStagingBuffers localBuffers;
+  meshStagingBuffers & buf = buffers ? *buffers : localBuffers;
+
   CGeometryAccessor acc = mesh.GetGeometryAccessor();
 
   // determine if we need a topology update
@@ -631,53 +945,82 @@ void convertInputPolygonMesh(PolygonMesh mesh, FabricCore::RTVal & rtVal)
   unsigned int nbSamples = rtVal.callMethod("UInt64", "polygonPointsCount", 0, 0).getUInt64();
   bool requireTopoUpdate = nbPolygons != acc.GetPolygonCount() || nbSamples != acc.GetNodeCount();
 
-  MATH::CVector3Array xsiPoints;
-  CLongArray xsiIndices;
-  if(requireTopoUpdate)
-    mesh.Get(xsiPoints, xsiIndices);
-  else
-    xsiPoints = mesh.GetPoints().GetPositionArray();
+  // the accessor fills the staging arrays in place.
+  acc.GetVertexPositions(buf.positions);
 
   std::vector<FabricCore::RTVal> args(2);
-  args[0] = FabricSplice::constructExternalArrayRTVal("Float64", xsiPoints.GetCount() * 3, &xsiPoints[0]);
-  args[1] = FabricSplice::constructUInt32RTVal(3); // components
-  rtVal.callMethod("", "setPointsFromExternalArray_d", 2, &args[0]);
-  xsiPoints.Clear();
+  if(float32Points && buf.positions.GetCount() > 0)
+  {
+    size_t count = buf.positions.GetCount();
+    if(buf.float32Points.size() < count)
+      buf.float32Points.resize(count);
+    convertDoublesToFloats(buf.positions.GetArray(), count, &buf.float32Points[0]);
+    args[0] = FabricSplice::constructExternalArrayRTVal("Float32", count, &buf.float32Points[0]);
+    args[1] = FabricSplice::constructUInt32RTVal(3); // components
+    rtVal.callMethod("", "setPointsFromExternalArray", 2, &args[0]);
+    gFloat32PointsBytesSaved += count * (sizeof(double) - sizeof(float));
+  }
+  else
+  {
+    args[0] = FabricSplice::constructExternalArrayRTVal("Float64", buf.positions.GetCount(), (void*)buf.positions.GetArray());
+    args[1] = FabricSplice::constructUInt32RTVal(3); // components
+    rtVal.callMethod("", "setPointsFromExternalArray_d", 2, &args[0]);
+  }
 
   if(requireTopoUpdate)
   {
-    std::vector<FabricCore::RTVal> args(1);
-    args[0] = FabricSplice::constructExternalArrayRTVal("UInt32", xsiIndices.GetCount(), &xsiIndices[0]);
-    rtVal.callMethod("", "setTopologyFromCombinedExternalArray", 1, &args[0]);
-    xsiIndices.Clear();
+    acc.GetPolygonVerticesCount(buf.polygonCounts);
+    acc.GetVertexIndices(buf.indices);
+    args[0] = FabricSplice::constructExternalArrayRTVal("UInt32", buf.polygonCounts.GetCount(), (void*)buf.polygonCounts.GetArray());
+    args[1] = FabricSplice::constructExternalArrayRTVal("UInt32", buf.indices.GetCount(), (void*)buf.indices.GetArray());
+    rtVal.callMethod("", "setTopologyFromCountsIndicesExternalArrays", 2, &args[0]);
   }
 
+  // the first UV and color sets go to the default attributes of the mesh,
+  // the other ones to attributes named after their cluster property.
+  // the cluster properties are only uploaded if they changed (not on deformation only).
   CRefArray uvRefs = acc.GetUVs();
-  if(uvRefs.GetCount() > 0)
+  for(LONG i=0;i<uvRefs.GetCount();i++)
   {
-    ClusterProperty prop(uvRefs[0]);
-    CFloatArray values;
+    ClusterProperty prop(uvRefs[i]);
+    if(!hasClusterPropertyChanged(prop, i, clusterEvalIDs, requireTopoUpdate))
+      continue;
+    CFloatArray & values = buf.values;
     prop.GetValues(values);
+    if(values.GetCount() == 0)
+      continue;
 
-    std::vector<FabricCore::RTVal> args(2);
-    args[0] = FabricSplice::constructExternalArrayRTVal("Float32", values.GetCount(), &values[0]);
-    args[1] = FabricSplice::constructUInt32RTVal(3); // components
-    rtVal.callMethod("", "setUVsFromExternalArray", 2, &args[0]);
-    values.Clear();
+    if(i == 0)
+    {
+      std::vector<FabricCore::RTVal> args(2);
+      args[0] = FabricSplice::constructExternalArrayRTVal("Float32", values.GetCount(), &values[0]);
+      args[1] = FabricSplice::constructUInt32RTVal(3); // components
+      rtVal.callMethod("", "setUVsFromExternalArray", 2, &args[0]);
+    }
+    else if(prop.GetValueSize() == 3)
+      setPolygonMeshAttributeFromClusterValues(rtVal, prop.GetName(), true, values);
   }
 
   CRefArray vertexColorRefs = acc.GetVertexColors();
-  if(vertexColorRefs.GetCount() > 0)
+  for(LONG i=0;i<vertexColorRefs.GetCount();i++)
   {
-    ClusterProperty prop(vertexColorRefs[0]);
-    CFloatArray values;
+    ClusterProperty prop(vertexColorRefs[i]);
+    if(!hasClusterPropertyChanged(prop, uvRefs.GetCount() + i, clusterEvalIDs, requireTopoUpdate))
+      continue;
+    CFloatArray & values = buf.values;
     prop.GetValues(values);
+    if(values.GetCount() == 0)
+      continue;
 
-    std::vector<FabricCore::RTVal> args(2);
-    args[0] = FabricSplice::constructExternalArrayRTVal("Float32", values.GetCount(), &values[0]);
-    args[1] = FabricSplice::constructUInt32RTVal(4); // components
-    rtVal.callMethod("", "setVertexColorsFromExternalArray", 2, &args[0]);
-    values.Clear();
+    if(i == 0)
+    {
+      std::vector<FabricCore::RTVal> args(2);
+      args[0] = FabricSplice::constructExternalArrayRTVal("Float32", values.GetCount(), &values[0]);
+      args[1] = FabricSplice::constructUInt32RTVal(4); // components
+      rtVal.callMethod("", "setVertexColorsFromExternalArray", 2, &args[0]);
+    }
+    else if(prop.GetValueSize() == 4)
+      setPolygonMeshAttributeFromClusterValues(rtVal, prop.GetName(), false, values);
   }
 }
 
@@ -686,52 +1029,64 @@ void convertInputLines(NurbsCurveList curveList, FabricCore::RTVal & rtVal)
   if(!rtVal.isValid() || rtVal.isNullObject())
     rtVal = FabricSplice::constructObjectRTVal("Lines");
 
-  MATH::CVector3Array xsiPoints = curveList.GetPoints().GetPositionArray();
-  FabricCore::RTVal xsiPointsVal = FabricSplice::constructExternalArrayRTVal("Float64", xsiPoints.GetCount() * 3, &xsiPoints[0]);
-  rtVal.callMethod("", "_setPositionsFromExternalArray_d", 1, &xsiPointsVal);
-
-  CNurbsCurveRefArray xsiCurves = curveList.GetCurves();
-  size_t nbSegments = 0;
-  for(ULONG j=0;j<xsiCurves.GetCount();j++)
-  {
-    NurbsCurve xsiCurve = xsiCurves[j];
-    CControlPointRefArray controls = xsiCurve.GetControlPoints();
-    CKnotArray knots = xsiCurve.GetKnots();
-    nbSegments += controls.GetCount() - 1;
-    bool closed = false;
-    knots.GetClosed(closed);
-    if(closed)
-      nbSegments++;
-  }
-
+  // query all curves at once as flat arrays, instead of accessing
+  // the control points and knots of each curve.
+  CDoubleArray controlPoints;
+  CLongArray nbControlPoints;
+  CDoubleArray knots;
+  CLongArray nbKnots;
+  CBoolArray closed;
+  CLongArray degrees;
+  CLongArray parameterizations;
+  curveList.Get(siSINurbs, controlPoints, nbControlPoints, knots, nbKnots, closed, degrees, parameterizations);
+
+  // the control points are (x, y, z, w), the weights are dropped.
+  // each curve has at most as many segments as control points, so the
+  // indices are built in a single pass and trimmed afterwards.
+  size_t nbPoints = controlPoints.GetCount() / 4;
+  std::vector<double> positions(nbPoints * 3);
+  std::vector<uint32_t> indices(nbPoints * 2);
   size_t voffset = 0;
   size_t coffset = 0;
-  std::vector<uint32_t> indices(nbSegments*2);
-  for(ULONG j=0;j<xsiCurves.GetCount();j++)
+  for(LONG j=0;j<nbControlPoints.GetCount();j++)
   {
-    NurbsCurve xsiCurve = xsiCurves[j];
-    CControlPointRefArray controls = xsiCurve.GetControlPoints();
-    for(ULONG k=0;k<controls.GetCount()-1;k++)
+    size_t nbCurvePoints = (size_t)nbControlPoints[j];
+    if(nbCurvePoints == 0)
+      continue;
+
+    size_t firstPoint = coffset;
+    for(size_t k=0;k<nbCurvePoints;k++)
     {
-      indices[voffset++] = coffset++;
-      indices[voffset++] = coffset;
+      positions[coffset*3+0] = controlPoints[coffset*4+0];
+      positions[coffset*3+1] = controlPoints[coffset*4+1];
+      positions[coffset*3+2] = controlPoints[coffset*4+2];
+      if(k > 0)
+      {
+        indices[voffset++] = coffset - 1;
+        indices[voffset++] = coffset;
+      }
+      coffset++;
     }
-    bool closed = false;
-    CKnotArray knots = xsiCurve.GetKnots();
-    knots.GetClosed(closed);
-    if(closed) {
-      indices[voffset++] = coffset;
-      indices[voffset++] = coffset - controls.GetCount() + 1;
+    if(closed[j])
+    {
+      indices[voffset++] = coffset - 1;
+      indices[voffset++] = firstPoint;
     }
-    coffset++;
   }
+  indices.resize(voffset);
 
-  FabricCore::RTVal indicesVal = FabricSplice::constructExternalArrayRTVal("UInt32", indices.size(), &indices[0]);
+  FabricCore::RTVal xsiPointsVal = FabricSplice::constructExternalArrayRTVal("Float64", positions.size(), positions.size() > 0 ? &positions[0] : NULL);
+  rtVal.callMethod("", "_setPositionsFromExternalArray_d", 1, &xsiPointsVal);
+
+  FabricCore::RTVal indicesVal = FabricSplice::constructExternalArrayRTVal("UInt32", indices.size(), indices.size() > 0 ? &indices[0] : NULL);
   rtVal.callMethod("", "_setTopologyFromExternalArray", 1, &indicesVal);
 }
 
-void convertOutputPolygonMesh(PolygonMesh mesh, FabricCore::RTVal & rtVal)
+void convertOutputPolygonMesh(PolygonMesh mesh, FabricCore::RTVal & rtVal, bool writeClusters, meshStagingBuffers *buffers, bool float32Points)
 {
+  meshStagingBuffers localBuffers;
+  meshStagingBuffers & buf = buffers ? *buffers : localBuffers;
+
   CGeometryAccessor acc = mesh.GetGeometryAccessor();
 
   unsigned int nbPoints = rtVal.callMethod("UInt64", "pointCount", 0, 0).getUInt64();
@@ -740,11 +1095,24 @@ void convertOutputPolygonMesh(PolygonMesh mesh, FabricCore::RTVal & rtVal)
 
   bool requireTopoUpdate = nbPolygons != acc.GetPolygonCount() || nbSamples != acc.GetNodeCount();
 
-  MATH::CVector3Array xsiPoints;
-  CLongArray xsiIndices;
+  MATH::CVector3Array & xsiPoints = buf.points;
+  CLongArray & xsiIndices = buf.indices;
   xsiPoints.Resize(nbPoints);
 
-  if(xsiPoints.GetCount() > 0)
+  if(xsiPoints.GetCount() > 0 && float32Points)
+  {
+    size_t count = xsiPoints.GetCount() * 3;
+    if(buf.float32Points.size() < count)
+      buf.float32Points.resize(count);
+    FabricCore::RTVal args[2] = {
+      FabricSplice::constructExternalArrayRTVal("Float32", count, &buf.float32Points[0]),
+      FabricSplice::constructUInt32RTVal(3)
+    };
+    rtVal.callMethod("", "getPointsAsExternalArray", 2, &args[0]);
+    convertFloatsToDoubles(&buf.float32Points[0], count, (double *)&xsiPoints[0]);
+    gFloat32PointsBytesSaved += count * (sizeof(double) - sizeof(float));
+  }
+  else if(xsiPoints.GetCount() > 0)
   {
     FabricCore::RTVal args[2] = {
       FabricSplice::constructExternalArrayRTVal("Float64", xsiPoints.GetCount() * 3, &xsiPoints[0]),
@@ -779,7 +1147,8 @@ void convertOutputPolygonMesh(PolygonMesh mesh, FabricCore::RTVal & rtVal)
   else
     mesh.GetPoints().PutPositionArray(xsiPoints);
 
-  if(nbPoints == 0)
+  // the clusters are driven by separate output ports, see convertOutputPolygonMeshClusterProperty.
+  if(nbPoints == 0 || !writeClusters)
     return;
 
   if(rtVal.callMethod("Boolean", "hasUVs", 0, 0).getBoolean())
@@ -789,7 +1158,8 @@ void convertOutputPolygonMesh(PolygonMesh mesh, FabricCore::RTVal & rtVal)
     {
       ClusterProperty prop(uvRefs[0]);
       LONG numComponents = prop.GetValueSize();
-      CFloatArray values(nbSamples * numComponents);
+      CFloatArray & values = buf.values;
+      values.Resize(nbSamples * numComponents);
       if(values.GetCount() > 0 && values.GetCount() == prop.GetElements().GetCount() * numComponents)
       {
         FabricCore::RTVal args[2] = {
@@ -798,7 +1168,6 @@ void convertOutputPolygonMesh(PolygonMesh mesh, FabricCore::RTVal & rtVal)
         };
         rtVal.callMethod("", "getUVsAsExternalArray", 2, &args[0]);
         prop.SetValues(&values[0], values.GetCount() / numComponents);
-        values.Clear();
       }
       else{
         // [phtaylor] I'm not sure how the user is supposed to fix this problem. Writing to clusters while modifying topology isn't supported by Softimage.
@@ -817,7 +1186,8 @@ void convertOutputPolygonMesh(PolygonMesh mesh, FabricCore::RTVal & rtVal)
     if(vertexColorRefs.GetCount() > 0)
     {
       ClusterProperty prop(vertexColorRefs[0]);
-      CFloatArray values(nbSamples * 4);
+      CFloatArray & values = buf.values;
+      values.Resize(nbSamples * 4);
 
       if(values.GetCount() > 0 && values.GetCount() == prop.GetElements().GetCount() * 4)
       {
@@ -827,7 +1197,6 @@ void convertOutputPolygonMesh(PolygonMesh mesh, FabricCore::RTVal & rtVal)
         };
         rtVal.callMethod("", "getVertexColorsAsExternalArray", 2, &args[0]);
         prop.SetValues(&values[0], values.GetCount() / 4);
-        values.Clear();
       }
       else{
         // [phtaylor] I'm not sure how the user is supposed to fix this problem. Writing to clusters while modifying topology isn't supported by Softimage.
@@ -841,6 +1210,75 @@ void convertOutputPolygonMesh(PolygonMesh mesh, FabricCore::RTVal & rtVal)
   }
 }
 
+void convertOutputPolygonMeshClusterProperty(ClusterProperty prop, FabricCore::RTVal & rtVal)
+{
+  bool isUVs = prop.GetPropertyType() == siClusterPropertyUVType;
+  if(!isUVs && prop.GetPropertyType() != siClusterPropertyVertexColorType)
+    return;
+
+  LONG numComponents = isUVs ? prop.GetValueSize() : 4;
+  LONG nbElements = prop.GetElements().GetCount();
+  if(nbElements == 0)
+    return;
+
+  // the port always gets written, without data on the KL mesh the
+  // cluster is reset (zero UVs, white vertex colors).
+  CFloatArray values(nbElements * numComponents);
+  if(!rtVal.callMethod("Boolean", isUVs ? "hasUVs" : "hasVertexColors", 0, 0).getBoolean())
+  {
+    xsiLogFunc("The PolygonMesh has no "+CString(isUVs ? "UVs" : "Vertex Colors")+", resetting cluster property '"+prop.GetFullName()+"'.");
+    for(LONG i=0;i<values.GetCount();i++)
+      values[i] = isUVs ? 0.0f : 1.0f;
+    prop.SetValues(&values[0], nbElements);
+    return;
+  }
+
+  unsigned int nbSamples = rtVal.callMethod("UInt64", "polygonPointsCount", 0, 0).getUInt64();
+  CFloatArray samples(nbSamples * numComponents);
+  if(nbSamples > 0)
+  {
+    FabricCore::RTVal args[2] = {
+      FabricSplice::constructExternalArrayRTVal("Float32", samples.GetCount(), &samples[0]),
+      FabricSplice::constructUInt32RTVal(numComponents)
+    };
+    rtVal.callMethod("", isUVs ? "getUVsAsExternalArray" : "getVertexColorsAsExternalArray", 2, &args[0]);
+  }
+
+  // the elements of the cluster property map to the samples through the
+  // cluster's element indices. when the topology changes the cluster may
+  // not cover the new mesh yet (or may be partial), so the values are
+  // gathered per element, elements past the new samples are left at zero.
+  Cluster cluster(prop.GetParent());
+  CLongArray sampleIndices;
+  if(cluster.IsValid())
+    sampleIndices = cluster.GetElements().GetArray();
+  if(sampleIndices.GetCount() != nbElements)
+  {
+    sampleIndices.Resize(nbElements);
+    for(LONG i=0;i<nbElements;i++)
+      sampleIndices[i] = i;
+  }
+
+  LONG missing = 0;
+  for(LONG i=0;i<nbElements;i++)
+  {
+    LONG sample = sampleIndices[i];
+    if(sample < 0 || (ULONG)sample >= nbSamples)
+    {
+      memset(&values[i * numComponents], 0, sizeof(float) * numComponents);
+      missing++;
+      continue;
+    }
+    memcpy(&values[i * numComponents], &samples[sample * numComponents], sizeof(float) * numComponents);
+  }
+  if(missing > 0)
+  {
+    CString missingStr(missing);
+    xsiLogFunc("Cluster property '"+prop.GetFullName()+"' has "+missingStr+" elements outside of the PolygonMesh, they are set to zero.");
+  }
+
+  prop.SetValues(&values[0], nbElements);
+}
 
 void convertOutputLines(NurbsCurveList curveList, FabricCore::RTVal & rtVal)
 {
@@ -864,65 +1302,531 @@ void convertOutputLines(NurbsCurveList curveList, FabricCore::RTVal & rtVal)
     rtVal.callMethod("", "_getTopologyAsExternalArray", 1, &indices);
   }
 
+  // build the flat arrays of NurbsCurveList::Set in a single pass over the segments
+  // (see convertSegmentsToCurves). upper bounds: one curve and two vertices per segment.
+  std::vector<uint32_t> curveVertices(nbSegments * 2);
+  std::vector<uint32_t> curveCounts(nbSegments);
+  std::vector<uint8_t> curveClosed(nbSegments);
   size_t nbCurves = 0;
   if(nbPoints > 0 && nbSegments > 0)
+    nbCurves = convertSegmentsToCurves(&xsiIndices[0], nbSegments, &curveVertices[0], &curveCounts[0], &curveClosed[0]);
+
+  size_t nbControlPointsTotal = 0;
+  for(size_t i=0;i<nbCurves;i++)
+    nbControlPointsTotal += curveCounts[i];
+
+  CDoubleArray controlPoints(LONG(nbControlPointsTotal * 4));
+  CDoubleArray knots(LONG(nbControlPointsTotal + nbCurves));
+  size_t nbKnotsTotal = 0;
+  if(nbCurves > 0)
+    nbKnotsTotal = convertCurvesToNurbs((const double*)&xsiPoints[0], &curveVertices[0], &curveCounts[0], &curveClosed[0], nbCurves, &controlPoints[0], &knots[0]);
+  knots.Resize(LONG(nbKnotsTotal));
+
+  CLongArray nbControlPoints(LONG(nbCurves));
+  CLongArray nbKnots(LONG(nbCurves));
+  CBoolArray closed(LONG(nbCurves));
+  CLongArray degrees(LONG(nbCurves));
+  CLongArray parameterizations(LONG(nbCurves));
+  for(size_t i=0;i<nbCurves;i++)
   {
-    nbCurves++;
-    for(size_t i=2;i<xsiIndices.size();i+=2)
+    nbControlPoints[i] = curveCounts[i];
+    nbKnots[i] = curveCounts[i] + (curveClosed[i] ? 1 : 0);
+    closed[i] = curveClosed[i] != 0;
+    degrees[i] = 1;
+    parameterizations[i] = 1; //siNonUniformParameterization;
+  }
+
+  curveList.Set(LONG(nbCurves), controlPoints, nbControlPoints, knots, nbKnots, closed, degrees, parameterizations, siSINurbs);
+}
+
+// copies flat data into the values of a Scalar / Integer / Vec2... attribute of a geometry.
+// the attribute is resized through its own resize() and written in place, this way the
+// attributes container and the version of the attribute stay consistent.
+template<typename T>
+static void setGeometryAttributeValues(FabricCore::RTVal & rtVal, const std::string & attrType, const char * name, const std::vector<T> & values, size_t components)
+{
+  FabricCore::RTVal attributes = rtVal.callMethod("GeometryAttributes", "getAttributes", 0, 0);
+  FabricCore::RTVal nameVal = FabricSplice::constructStringRTVal(name);
+  FabricCore::RTVal attr = attributes.callMethod((attrType+"Attribute").c_str(), ("getOrCreate"+attrType+"Attribute").c_str(), 1, &nameVal);
+
+  FabricCore::RTVal countVal = FabricSplice::constructUInt32RTVal(values.size() / components);
+  attr.callMethod("", "resize", 1, &countVal);
+  if(values.size() > 0)
+  {
+    FabricCore::RTVal data = attr.maybeGetMember("values").callMethod("Data", "data", 0, 0);
+    memcpy(data.getData(), &values[0], sizeof(T) * values.size());
+  }
+  attr.callMethod("", "incrementVersion", 0, 0);
+}
+
+// copies the values of a Scalar / Vec2 attribute of a geometry, returns false if there is no such attribute.
+static bool getGeometryAttributeValues(FabricCore::RTVal & rtVal, const std::string & attrType, const char * name, std::vector<float> & values, size_t components)
+{
+  FabricCore::RTVal attributes = rtVal.callMethod("GeometryAttributes", "getAttributes", 0, 0);
+  FabricCore::RTVal nameVal = FabricSplice::constructStringRTVal(name);
+  if(!attributes.callMethod("Boolean", "has", 1, &nameVal).getBoolean())
+    return false;
+  FabricCore::RTVal attr = attributes.callMethod((attrType+"Attribute").c_str(), ("getOrCreate"+attrType+"Attribute").c_str(), 1, &nameVal);
+
+  FabricCore::RTVal valuesVal = attr.maybeGetMember("values");
+  values.resize(valuesVal.getArraySize() * components);
+  if(values.size() > 0)
+  {
+    FabricCore::RTVal data = valuesVal.callMethod("Data", "data", 0, 0);
+    memcpy(&values[0], data.getData(), sizeof(float) * values.size());
+  }
+  return true;
+}
+
+// returns a per point ICE attribute of the given type which can be written by the operator.
+// the attribute has to be initialized per point by an ICE tree below the operator, an attribute
+// added by the operator itself (or set to a single value) is constant and can't hold the data.
+// returns an invalid attribute if it is missing, constant, read-only or of another type.
+static ICEAttribute getWritableICEAttribute(Geometry geo, const CString & name, siICENodeDataType dataType, siICENodeStructureType structureType, CString & errorMessage)
+{
+  ICEAttribute attr = geo.GetICEAttributeFromName(name);
+  if(!attr.IsValid() || !attr.IsDefined())
+  {
+    errorMessage = L"The ICE attribute '"+name+L"' doesn't exist, please initialize it per point in an ICE tree below the operator.";
+    return ICEAttribute();
+  }
+  if(attr.GetDataType() != dataType || attr.GetStructureType() != structureType || attr.GetContextType() != siICENodeContextComponent0D)
+  {
+    errorMessage = L"The ICE attribute '"+name+L"' already exists, but has the wrong type or context.";
+    return ICEAttribute();
+  }
+  if(attr.IsConstant())
+  {
+    errorMessage = L"The ICE attribute '"+name+L"' is constant, please set it per point in an ICE tree below the operator.";
+    return ICEAttribute();
+  }
+  if(attr.IsReadonly())
+  {
+    errorMessage = L"The ICE attribute '"+name+L"' is read-only.";
+    return ICEAttribute();
+  }
+  return attr;
+}
+
+void convertInputStrands(Geometry geo, FabricCore::RTVal & rtVal)
+{
+  if(!rtVal.isValid() || rtVal.isNullObject())
+    rtVal = FabricSplice::constructObjectRTVal("Lines");
+
+  CICEAttributeDataArray2DVector3f xsiPositions;
+  ICEAttribute positionAttr = geo.GetICEAttributeFromName(L"StrandPosition");
+  if(positionAttr.IsValid() && positionAttr.GetElementCount() > 0)
+    positionAttr.GetDataArray2D(xsiPositions);
+
+  CICEAttributeDataArray2DFloat xsiSizes;
+  ICEAttribute sizeAttr = geo.GetICEAttributeFromName(L"StrandSize");
+  bool hasSizes = sizeAttr.IsValid() && sizeAttr.GetElementCount() > 0 && sizeAttr.GetDataType() == siICENodeDataFloat && sizeAttr.GetStructureType() == siICENodeStructureArray;
+  if(hasSizes)
+    sizeAttr.GetDataArray2D(xsiSizes);
+
+  CICEAttributeDataArrayLong xsiIDs;
+  ICEAttribute idAttr = geo.GetICEAttributeFromName(L"ID");
+  bool hasIDs = idAttr.IsValid() && idAttr.GetElementCount() > 0 && idAttr.GetDataType() == siICENodeDataLong && idAttr.GetStructureType() == siICENodeStructureSingle;
+  if(hasIDs)
+    idAttr.GetDataArray(xsiIDs);
+
+  CICEAttributeDataArrayVector3f xsiUVWs;
+  ICEAttribute uvwAttr = geo.GetICEAttributeFromName(L"StrandUVW");
+  bool hasUVWs = uvwAttr.IsValid() && uvwAttr.GetElementCount() > 0 && uvwAttr.GetDataType() == siICENodeDataVector3 && uvwAttr.GetStructureType() == siICENodeStructureSingle;
+  if(hasUVWs)
+    uvwAttr.GetDataArray(xsiUVWs);
+
+  // the sub arrays are views on the ICE data, so the first pass only counts.
+  ULONG nbStrands = xsiPositions.GetCount();
+  CICEAttributeDataArrayVector3f xsiStrand;
+  size_t nbPoints = 0;
+  size_t nbSegments = 0;
+  for(ULONG i=0;i<nbStrands;i++)
+  {
+    xsiPositions.GetSubArray(i, xsiStrand);
+    nbPoints += xsiStrand.GetCount();
+    if(xsiStrand.GetCount() > 1)
+      nbSegments += xsiStrand.GetCount() - 1;
+  }
+
+  std::vector<double> positions(nbPoints * 3);
+  std::vector<uint32_t> indices(nbSegments * 2);
+  std::vector<float> widths(hasSizes ? nbPoints : 0);
+  std::vector<int32_t> strandIDs(hasIDs ? nbPoints : 0);
+  std::vector<float> strandUVs(hasUVWs ? nbPoints * 2 : 0);
+
+  CICEAttributeDataArrayFloat xsiStrandSizes;
+  size_t poffset = 0;
+  size_t voffset = 0;
+  for(ULONG i=0;i<nbStrands;i++)
+  {
+    xsiPositions.GetSubArray(i, xsiStrand);
+    ULONG count = xsiStrand.GetCount();
+    if(count == 0)
+      continue;
+
+    for(ULONG j=0;j<count;j++)
+    {
+      positions[(poffset+j)*3+0] = xsiStrand[j].GetX();
+      positions[(poffset+j)*3+1] = xsiStrand[j].GetY();
+      positions[(poffset+j)*3+2] = xsiStrand[j].GetZ();
+    }
+    for(ULONG j=1;j<count;j++)
+    {
+      indices[voffset++] = poffset + j - 1;
+      indices[voffset++] = poffset + j;
+    }
+
+    if(hasSizes)
+    {
+      xsiSizes.GetSubArray(i, xsiStrandSizes);
+      if(xsiStrandSizes.GetCount() == count)
+        memcpy(&widths[poffset], &xsiStrandSizes[0], sizeof(float) * count);
+      else if(xsiStrandSizes.GetCount() > 0)
+        std::fill(widths.begin() + poffset, widths.begin() + poffset + count, xsiStrandSizes[0]);
+    }
+    if(hasIDs && i < xsiIDs.GetCount())
+      std::fill(strandIDs.begin() + poffset, strandIDs.begin() + poffset + count, (int32_t)xsiIDs[i]);
+    if(hasUVWs && i < xsiUVWs.GetCount())
     {
-      if(xsiIndices[i] != xsiIndices[i-1])
-        nbCurves++;
+      for(ULONG j=0;j<count;j++)
+      {
+        strandUVs[(poffset+j)*2+0] = xsiUVWs[i].GetX();
+        strandUVs[(poffset+j)*2+1] = xsiUVWs[i].GetY();
+      }
     }
+
+    poffset += count;
   }
 
-  CNurbsCurveDataArray curveData(nbCurves);
+  FabricCore::RTVal positionsVal = FabricSplice::constructExternalArrayRTVal("Float64", positions.size(), positions.size() > 0 ? &positions[0] : NULL);
+  rtVal.callMethod("", "_setPositionsFromExternalArray_d", 1, &positionsVal);
 
-  if(nbCurves > 0)
+  FabricCore::RTVal indicesVal = FabricSplice::constructExternalArrayRTVal("UInt32", indices.size(), indices.size() > 0 ? &indices[0] : NULL);
+  rtVal.callMethod("", "_setTopologyFromExternalArray", 1, &indicesVal);
+
+  if(hasSizes)
+    setGeometryAttributeValues(rtVal, "Scalar", "width", widths, 1);
+  if(hasIDs)
+    setGeometryAttributeValues(rtVal, "Integer", "strandID", strandIDs, 1);
+  if(hasUVWs)
+    setGeometryAttributeValues(rtVal, "Vec2", "strandUV", strandUVs, 2);
+}
+
+bool convertOutputStrands(Geometry geo, FabricCore::RTVal & rtVal, CString & errorMessage)
+{
+  unsigned int nbPoints = rtVal.callMethod("UInt64", "pointCount", 0, 0).getUInt64();
+  unsigned int nbSegments = rtVal.callMethod("UInt64", "lineCount", 0, 0).getUInt64();
+
+  std::vector<double> positions(nbPoints * 3);
+  std::vector<uint32_t> indices(nbSegments * 2);
+  if(nbPoints > 0)
+  {
+    FabricCore::RTVal positionsVal = FabricSplice::constructExternalArrayRTVal("Float64", positions.size(), &positions[0]);
+    rtVal.callMethod("", "_getPositionsAsExternalArray_d", 1, &positionsVal);
+  }
+  if(nbSegments > 0)
   {
-    size_t coffset = 0;
-    for(size_t i=0;i<nbCurves;i++)
+    FabricCore::RTVal indicesVal = FabricSplice::constructExternalArrayRTVal("UInt32", indices.size(), &indices[0]);
+    rtVal.callMethod("", "_getTopologyAsExternalArray", 1, &indicesVal);
+  }
+
+  std::vector<float> widths;
+  std::vector<float> strandUVs;
+  bool hasWidths = getGeometryAttributeValues(rtVal, "Scalar", "width", widths, 1) && widths.size() == nbPoints;
+  bool hasUVs = getGeometryAttributeValues(rtVal, "Vec2", "strandUV", strandUVs, 2) && strandUVs.size() == nbPoints * 2;
+
+  // a strand continues as long as a segment starts where the previous one ended,
+  // the same walk as for the NurbsCurveList of a Lines port (see convertOutputLines).
+  std::vector<uint32_t> strandVertices(nbSegments * 2);
+  std::vector<uint32_t> strandCounts(nbSegments);
+  std::vector<uint8_t> strandClosed(nbSegments);
+  size_t nbCurves = 0;
+  if(nbPoints > 0 && nbSegments > 0)
+    nbCurves = convertSegmentsToCurves(&indices[0], nbSegments, &strandVertices[0], &strandCounts[0], &strandClosed[0]);
+
+  ULONG nbStrands = (ULONG)nbCurves;
+  if(geo.GetPoints().GetCount() != (LONG)nbStrands)
+  {
+    errorMessage = L"The point cloud has "+CString((LONG)geo.GetPoints().GetCount())+L" points but the Lines hold "+CString((LONG)nbStrands)+L" strands, there has to be one point per strand.";
+    return false;
+  }
+
+  // the ICE data is written in place, the same way as the CanvasOp does for its outputs.
+  ICEAttribute positionAttr = getWritableICEAttribute(geo, L"StrandPosition", siICENodeDataVector3, siICENodeStructureArray, errorMessage);
+  if(!positionAttr.IsValid())
+    return false;
+  CICEAttributeDataArray2DVector3f xsiPositions;
+  positionAttr.GetDataArray2D(xsiPositions);
+  if(xsiPositions.GetCount() != nbStrands)
+  {
+    errorMessage = L"The ICE attribute 'StrandPosition' doesn't have one value per point.";
+    return false;
+  }
+
+  CICEAttributeDataArray2DFloat xsiSizes;
+  if(hasWidths)
+  {
+    ICEAttribute sizeAttr = getWritableICEAttribute(geo, L"StrandSize", siICENodeDataFloat, siICENodeStructureArray, errorMessage);
+    if(sizeAttr.IsValid())
+      sizeAttr.GetDataArray2D(xsiSizes);
+    hasWidths = xsiSizes.GetCount() == nbStrands;
+  }
+
+  CICEAttributeDataArrayVector3f xsiUVWs;
+  if(hasUVs)
+  {
+    ICEAttribute uvwAttr = getWritableICEAttribute(geo, L"StrandUVW", siICENodeDataVector3, siICENodeStructureSingle, errorMessage);
+    if(uvwAttr.IsValid())
+      uvwAttr.GetDataArray(xsiUVWs);
+    hasUVs = xsiUVWs.GetCount() == nbStrands;
+  }
+
+  // the strand roots become the point positions, closed curves repeat their first point.
+  MATH::CVector3Array xsiPoints(nbStrands);
+  std::vector<MATH::CVector3f> strandPositions;
+  std::vector<float> strandSizes;
+  const uint32_t * vertices = nbStrands > 0 ? &strandVertices[0] : NULL;
+  for(ULONG s=0;s<nbStrands;s++)
+  {
+    ULONG count = strandCounts[s] + (strandClosed[s] ? 1 : 0);
+    strandPositions.resize(count);
+    strandSizes.resize(count);
+    for(ULONG j=0;j<count;j++)
     {
-      curveData[i].m_siParameterization = (siKnotParameterization)1;//siNonUniformParameterization;
-      curveData[i].m_lDegree = 1;
+      uint32_t vindex = vertices[j < strandCounts[s] ? j : 0];
+      strandPositions[j].Set((float)positions[vindex*3+0], (float)positions[vindex*3+1], (float)positions[vindex*3+2]);
+      if(hasWidths)
+        strandSizes[j] = widths[vindex];
+    }
+    xsiPoints[s].Set(positions[vertices[0]*3+0], positions[vertices[0]*3+1], positions[vertices[0]*3+2]);
+    if(hasUVs)
+      xsiUVWs[s].Set(strandUVs[vertices[0]*2+0], strandUVs[vertices[0]*2+1], 0.0f);
+    vertices += strandCounts[s];
+
+    xsiPositions.SetSubArray(s, &strandPositions[0], count);
+    if(hasWidths)
+      xsiSizes.SetSubArray(s, &strandSizes[0], count);
+  }
+
+  geo.GetPoints().PutPositionArray(xsiPoints);
+  return true;
+}
+
+// the per point attributes of a PointCloud port, as pairs of ICE and KL names.
+static void getPointCloudAttributeNames(const CString & iceAttrNames, CStringArray & iceNames, std::vector<std::string> & klNames)
+{
+  iceNames.Add(L"Size");          klNames.push_back("size");
+  iceNames.Add(L"Velocity");      klNames.push_back("velocity");
+  iceNames.Add(L"Orientation");   klNames.push_back("orientation");
+  iceNames.Add(L"Color");         klNames.push_back("color");
+
+  CStringArray customNames = iceAttrNames.Split(L",");
+  for(LONG i=0;i<customNames.GetCount();i++)
+  {
+    if(customNames[i].IsEmpty())
+      continue;
+    iceNames.Add(customNames[i]);
+    klNames.push_back(customNames[i].GetAsciiString());
+  }
+}
+
+// KL attribute type and number of floats per value of an ICE data type, false if not supported.
+static bool getGeometryAttributeTypeFromICEDataType(siICENodeDataType dataType, std::string & attrType, size_t & components)
+{
+  switch(dataType)
+  {
+    case siICENodeDataFloat:      attrType = "Scalar"; components = 1; return true;
+    case siICENodeDataVector2:    attrType = "Vec2";   components = 2; return true;
+    case siICENodeDataVector3:    attrType = "Vec3";   components = 3; return true;
+    case siICENodeDataVector4:    attrType = "Vec4";   components = 4; return true;
+    case siICENodeDataQuaternion: attrType = "Vec4";   components = 4; return true;
+    case siICENodeDataColor4:     attrType = "Color";  components = 4; return true;
+    default:                      return false;
+  }
+}
+
+// copies the values of an ICE attribute into flat floats, constant attributes are repeated for each element.
+template <class T> static void getICEAttributeFloats(ICEAttribute & attr, size_t components, std::vector<float> & values)
+{
+  CICEAttributeDataArray<T> data;
+  attr.GetDataArray(data);
+  ULONG count = attr.GetElementCount();
+  values.resize(count * components);
+  if(data.GetCount() == count && count > 0)
+    memcpy(&values[0], &data[0], sizeof(float) * values.size());
+  else if(data.GetCount() > 0)
+  {
+    for(ULONG i=0;i<count;i++)
+      memcpy(&values[i*components], &data[0], sizeof(float) * components);
+  }
+}
+
+// copies flat floats into the writable ICE data of an attribute.
+template <class T> static bool setICEAttributeFloats(ICEAttribute & attr, size_t components, const std::vector<float> & values)
+{
+  CICEAttributeDataArray<T> data;
+  attr.GetDataArray(data);
+  if(data.GetCount() * components != values.size())
+    return false;
+  if(values.size() > 0)
+    memcpy(&data[0], &values[0], sizeof(float) * values.size());
+  return true;
+}
 
-      size_t voffset = coffset + 2;
-      while(voffset < xsiIndices.size())
+void convertInputPointCloud(Geometry geo, FabricCore::RTVal & rtVal, const CString & iceAttrNames)
+{
+  if(!rtVal.isValid() || rtVal.isNullObject())
+    rtVal = FabricSplice::constructObjectRTVal("Points");
+
+  CICEAttributeDataArrayVector3f xsiPositions;
+  ICEAttribute positionAttr = geo.GetICEAttributeFromName(L"PointPosition");
+  if(positionAttr.IsValid())
+    positionAttr.GetDataArray(xsiPositions);
+  ULONG nbPoints = xsiPositions.GetCount();
+
+  FabricCore::RTVal countVal = FabricSplice::constructUInt32RTVal(nbPoints);
+  rtVal.callMethod("", "resize", 1, &countVal);
+
+  std::vector<float> values(nbPoints * 3);
+  if(nbPoints > 0)
+    memcpy(&values[0], &xsiPositions[0], sizeof(float) * values.size());
+  setGeometryAttributeValues(rtVal, "Vec3", "positions", values, 3);
+
+  CStringArray iceNames;
+  std::vector<std::string> klNames;
+  getPointCloudAttributeNames(iceAttrNames, iceNames, klNames);
+  for(LONG i=0;i<iceNames.GetCount();i++)
+  {
+    ICEAttribute attr = geo.GetICEAttributeFromName(iceNames[i]);
+    if(!attr.IsValid() || !attr.IsDefined() || attr.GetStructureType() != siICENodeStructureSingle || attr.GetElementCount() != nbPoints)
+      continue;
+
+    std::string attrType;
+    size_t components;
+    if(!getGeometryAttributeTypeFromICEDataType(attr.GetDataType(), attrType, components))
+      continue;
+
+    switch(attr.GetDataType())
+    {
+      case siICENodeDataFloat:    getICEAttributeFloats<float>(attr, components, values); break;
+      case siICENodeDataVector2:  getICEAttributeFloats<MATH::CVector2f>(attr, components, values); break;
+      case siICENodeDataVector3:  getICEAttributeFloats<MATH::CVector3f>(attr, components, values); break;
+      case siICENodeDataVector4:  getICEAttributeFloats<MATH::CVector4f>(attr, components, values); break;
+      case siICENodeDataColor4:   getICEAttributeFloats<MATH::CColor4f>(attr, components, values); break;
+      case siICENodeDataQuaternion:
       {
-        if(xsiIndices[voffset] != xsiIndices[voffset-1])
-          break;
-        voffset += 2;
+        // constant orientations are repeated for each point.
+        CICEAttributeDataArrayQuaternionf data;
+        attr.GetDataArray(data);
+        values.resize(nbPoints * 4);
+        if(data.GetCount() == nbPoints && nbPoints > 0)
+          convertICEQuaternionsToKL(&data[0], &values[0], nbPoints);
+        else if(data.GetCount() > 0)
+        {
+          convertICEQuaternionsToKL(&data[0], &values[0], 1);
+          for(ULONG j=1;j<nbPoints;j++)
+            memcpy(&values[j*4], &values[0], sizeof(float) * 4);
+        }
+        break;
       }
+      default: break;
+    }
+    setGeometryAttributeValues(rtVal, attrType, klNames[i].c_str(), values, components);
+  }
+}
+
+bool convertOutputPointCloud(Geometry geo, FabricCore::RTVal & rtVal, const CString & iceAttrNames, CString & errorMessage)
+{
+  std::vector<float> values;
+  if(!getGeometryAttributeValues(rtVal, "Vec3", "positions", values, 3))
+    values.clear();
+  ULONG nbPoints = (ULONG)(values.size() / 3);
+
+  if(geo.GetPoints().GetCount() != (LONG)nbPoints)
+  {
+    errorMessage = L"The geometry has "+CString((LONG)geo.GetPoints().GetCount())+L" points but the Points hold "+CString((LONG)nbPoints)+L", there has to be one point per KL point.";
+    return false;
+  }
+
+  MATH::CVector3Array xsiPoints(nbPoints);
+  for(ULONG i=0;i<nbPoints;i++)
+    xsiPoints[i].Set(values[i*3+0], values[i*3+1], values[i*3+2]);
+  geo.GetPoints().PutPositionArray(xsiPoints);
+
+  // the ICE data is written in place, the same way as the Strands outputs.
+  CStringArray iceNames;
+  std::vector<std::string> klNames;
+  getPointCloudAttributeNames(iceAttrNames, iceNames, klNames);
+  for(LONG i=0;i<iceNames.GetCount();i++)
+  {
+    // the ICE type of the custom attributes is taken from the geometry.
+    siICENodeDataType dataType;
+    if(iceNames[i] == L"Size")
+      dataType = siICENodeDataFloat;
+    else if(iceNames[i] == L"Velocity")
+      dataType = siICENodeDataVector3;
+    else if(iceNames[i] == L"Orientation")
+      dataType = siICENodeDataQuaternion;
+    else if(iceNames[i] == L"Color")
+      dataType = siICENodeDataColor4;
+    else
+    {
+      ICEAttribute attr = geo.GetICEAttributeFromName(iceNames[i]);
+      if(!attr.IsValid())
+        continue;
+      dataType = attr.GetDataType();
+    }
 
-      size_t nbVertices = (voffset - coffset) / 2 + 1;
-      bool isClosed = xsiIndices[coffset] == xsiIndices[voffset-1];
-      if(isClosed)
-        nbVertices--;
-      curveData[i].m_aControlPoints.Resize(nbVertices);
-      curveData[i].m_aKnots.Resize(nbVertices + (isClosed ? 1 : 0));
-      curveData[i].m_bClosed = isClosed;
+    std::string attrType;
+    size_t components;
+    if(!getGeometryAttributeTypeFromICEDataType(dataType, attrType, components))
+      continue;
+    if(!getGeometryAttributeValues(rtVal, attrType, klNames[i].c_str(), values, components))
+      continue;
+
+    // Size, Velocity, Orientation and Color are always transferred, they are only written
+    // if an ICE tree sets them per point. the custom attributes were asked for, so they
+    // have to be writable.
+    bool isDefaultAttribute = i < 4;  // see getPointCloudAttributeNames.
+    if(isDefaultAttribute)
+    {
+      ICEAttribute attr = geo.GetICEAttributeFromName(iceNames[i]);
+      if(!attr.IsValid() || !attr.IsDefined() || attr.IsConstant())
+        continue;
+    }
+
+    CString attrErrorMessage;
+    ICEAttribute attr = getWritableICEAttribute(geo, iceNames[i], dataType, siICENodeStructureSingle, attrErrorMessage);
+    if(!attr.IsValid())
+    {
+      xsiLogErrorFunc(attrErrorMessage);
+      continue;
+    }
 
-      for(size_t j=0;j<nbVertices;j++)
+    bool written = false;
+    switch(dataType)
+    {
+      case siICENodeDataFloat:    written = setICEAttributeFloats<float>(attr, components, values); break;
+      case siICENodeDataVector2:  written = setICEAttributeFloats<MATH::CVector2f>(attr, components, values); break;
+      case siICENodeDataVector3:  written = setICEAttributeFloats<MATH::CVector3f>(attr, components, values); break;
+      case siICENodeDataVector4:  written = setICEAttributeFloats<MATH::CVector4f>(attr, components, values); break;
+      case siICENodeDataColor4:   written = setICEAttributeFloats<MATH::CColor4f>(attr, components, values); break;
+      case siICENodeDataQuaternion:
       {
-        size_t vindex;
-        if(j == 0)
-          vindex = xsiIndices[coffset];
-        else
-          vindex = xsiIndices[coffset + 1 + 2 * (j-1)];
-        curveData[i].m_aControlPoints[j].Set(
-          xsiPoints[vindex].GetX(),
-          xsiPoints[vindex].GetY(),
-          xsiPoints[vindex].GetZ(),
-          1.0);
-        curveData[i].m_aKnots[j] = double(j);
+        CICEAttributeDataArrayQuaternionf data;
+        attr.GetDataArray(data);
+        written = data.GetCount() * 4 == values.size();
+        if(written && data.GetCount() > 0)
+          convertKLQuaternionsToICE(&values[0], &data[0], data.GetCount());
+        break;
       }
-      if(isClosed)
-        curveData[i].m_aKnots[nbVertices] = double(nbVertices);
-
-      coffset = voffset;
+      default: break;
     }
+    if(!written)
+      xsiLogErrorFunc(L"The ICE attribute '"+iceNames[i]+L"' doesn't have one value per point.");
   }
-
-  curveList.Set(curveData, siSINurbs);
+  return true;
 }
 
 CRef filterX3DObjectPickedRef(CRef ref, CString filter)
@@ -983,6 +1887,153 @@ CRefArray PickSingleObject(CString title, CString filter)
   return targets;
 }
 
+static void logBenchmarkResult(const CString & name, const CString & kind, double firstMs, double totalMs, int iterations, size_t bytes, size_t samples)
+{
+  double avgMs = iterations > 0 ? totalMs / double(iterations) : 0.0;
+  double mbPerSec = avgMs > 0.0 ? (double(bytes) / (1024.0 * 1024.0)) / (avgMs * 0.001) : 0.0;
+  double samplesPerSec = avgMs > 0.0 ? double(samples) / (avgMs * 0.001) : 0.0;
+
+  std::stringstream ss;
+  ss << name.GetAsciiString() << " (" << kind.GetAsciiString() << "): " << std::fixed
+     << "first " << std::setprecision(3) << firstMs << " ms, average " << avgMs << " ms over " << iterations << " iterations, "
+     << std::setprecision(1) << mbPerSec << " MB/s, " << std::setprecision(0) << samplesPerSec << " samples/s";
+  xsiLogFunc(ss.str().c_str());
+}
+
+void benchmarkInputConversion(const CRefArray & targets, int iterations, const CString & iceAttrName)
+{
+  if(iterations < 1)
+    iterations = 1;
+
+  QElapsedTimer timer;
+  for(ULONG i=0;i<targets.GetCount();i++)
+  {
+    X3DObject x3d = getX3DObjectFromRef(targets[i]);
+    if(!x3d.IsValid())
+    {
+      xsiLogErrorFunc("benchmark: '"+targets[i].GetAsText()+"' is not a 3D object.");
+      continue;
+    }
+
+    Primitive prim = x3d.GetActivePrimitive();
+    Geometry geo = prim.GetGeometry();
+    CString name = x3d.GetFullName();
+
+    if(!iceAttrName.IsEmpty())
+    {
+      ICEAttribute iceAttr = geo.GetICEAttributeFromName(iceAttrName);
+      CRefArray primRefs;
+      primRefs.Add(prim.GetRef());
+      CString errorMessage;
+      CString dataType = getSpliceDataTypeFromICEAttribute(primRefs, iceAttrName, errorMessage);
+      if(!iceAttr.IsValid() || dataType.IsEmpty())
+      {
+        xsiLogErrorFunc("benchmark: '"+name+"' has no supported ICE attribute '"+iceAttrName+"'. "+errorMessage);
+        continue;
+      }
+
+      // a scratch graph holding a single port receiving the attribute.
+      FabricSplice::DGGraph graph("benchmarkGraph");
+      graph.constructDGNode("DGNode");
+      graph.addDGNodeMember("attribute", dataType.GetAsciiString(), FabricCore::Variant(), "DGNode");
+      graph.addDGPort("attribute", "attribute", FabricSplice::Port_Mode_IN, "DGNode");
+      FabricSplice::DGPort port = graph.getDGPort("attribute");
+
+      std::string elementType = dataType.GetAsciiString();
+      elementType = elementType.substr(0, elementType.find('['));
+      size_t samples = iceAttr.GetElementCount();
+      size_t bytes = samples * FabricProfiler::getDataTypeBytes(elementType);
+
+      timer.start();
+      convertInputICEAttribute(port, dataType, iceAttr, geo);
+      double firstMs = (double)timer.nsecsElapsed() * 1.0e-6;
+
+      timer.start();
+      for(int j=0;j<iterations;j++)
+        convertInputICEAttribute(port, dataType, iceAttr, geo);
+      double totalMs = (double)timer.nsecsElapsed() * 1.0e-6;
+
+      logBenchmarkResult(name+"."+iceAttrName, dataType, firstMs, totalMs, iterations, bytes, samples);
+
+      // compare the quaternion / matrix kernels against the per element accessors.
+      if(dataType == L"Quat[]" || dataType == L"Mat44[]")
+      {
+        bool isQuat = dataType == L"Quat[]";
+        CICEAttributeDataArrayQuaternionf quats;
+        CICEAttributeDataArrayMatrix4f matrices;
+        ULONG count = 0;
+        if(isQuat)
+        {
+          iceAttr.GetDataArray(quats);
+          count = quats.GetCount();
+        }
+        else
+        {
+          iceAttr.GetDataArray(matrices);
+          count = matrices.GetCount();
+        }
+        if(count == 0)
+          continue;
+
+        std::vector<float> values(count * (isQuat ? 4 : 16));
+        timer.start();
+        for(int j=0;j<iterations;j++)
+        {
+          if(isQuat)
+            convertICEQuaternionsToKLLoop(&quats[0], &values[0], count);
+          else
+            convertICEMatricesToKLLoop(&matrices[0], &values[0], count);
+        }
+        double loopMs = (double)timer.nsecsElapsed() * 1.0e-6;
+        logBenchmarkResult(name+"."+iceAttrName, dataType+" accessor loop", loopMs / double(iterations), loopMs, iterations, bytes, samples);
+
+        timer.start();
+        for(int j=0;j<iterations;j++)
+        {
+          if(isQuat)
+            convertICEQuaternionsToKL(&quats[0], &values[0], count);
+          else
+            convertICEMatricesToKL(&matrices[0], &values[0], count);
+        }
+        double kernelMs = (double)timer.nsecsElapsed() * 1.0e-6;
+        logBenchmarkResult(name+"."+iceAttrName, dataType+" kernel", kernelMs / double(iterations), kernelMs, iterations, bytes, samples);
+      }
+      continue;
+    }
+
+    CString dataType = getSpliceDataTypeFromRef(prim.GetRef());
+    if(dataType == L"PolygonMesh" || dataType == L"Lines")
+    {
+      bool isMesh = dataType == L"PolygonMesh";
+      FabricCore::RTVal rtVal;
+      meshStagingBuffers buffers;
+
+      // the first conversion includes the topology, the following ones only the points.
+      timer.start();
+      if(isMesh)
+        convertInputPolygonMesh(PolygonMesh(geo), rtVal, NULL, &buffers);
+      else
+        convertInputLines(NurbsCurveList(geo), rtVal);
+      double firstMs = (double)timer.nsecsElapsed() * 1.0e-6;
+
+      timer.start();
+      for(int j=0;j<iterations;j++)
+      {
+        if(isMesh)
+          convertInputPolygonMesh(PolygonMesh(geo), rtVal, NULL, &buffers);
+        else
+          convertInputLines(NurbsCurveList(geo), rtVal);
+      }
+      double totalMs = (double)timer.nsecsElapsed() * 1.0e-6;
+
+      size_t samples = geo.GetPoints().GetCount();
+      logBenchmarkResult(name, dataType, firstMs, totalMs, iterations, FabricProfiler::getGeometryBytes(rtVal), samples);
+    }
+    else
+      xsiLogErrorFunc("benchmark: '"+name+"' is neither a polygon mesh nor a curve list, specify an ICE attribute to benchmark.");
+  }
+}
+
 CRefArray PickObjectArray(CString firstTitle, CString nextTitle, CString filter, ULONG maxCount)
 {
   CRefArray refs;
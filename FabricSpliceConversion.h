@@ -13,6 +13,11 @@
 #include <xsi_polygonmesh.h>
 #include <xsi_nurbscurve.h>
 #include <xsi_nurbscurvelist.h>
+#include <xsi_clusterproperty.h>
+#include <xsi_doublearray.h>
+#include <xsi_floatarray.h>
+#include <xsi_longarray.h>
+#include <xsi_vector3.h>
 #include <string>
 #include <vector>
 
@@ -32,16 +37,89 @@ void getActionSourceFromRTVal(const FabricCore::RTVal &rtVal, XSI::ActionSource
 XSI::CRefArray getCRefArrayFromCString(const XSI::CString &targets);
 XSI::CString getSpliceDataTypeFromRefArray(const XSI::CRefArray &refs, const XSI::CString &portType = L"");
 XSI::CString getSpliceDataTypeFromRef(const XSI::CRef &ref, const XSI::CString &portType = L"");
+// data type of a port on the Softimage side, which differs from the KL type for some ports (Strands).
+XSI::CString getXSIDataTypeFromPort(FabricSplice::DGPort &port);
 XSI::CString getSpliceDataTypeFromICEAttribute(const XSI::CRefArray &refs, const XSI::CString &iceAttrName, XSI::CString &errorMessage);
-void convertInputICEAttribute(FabricSplice::DGPort &port, XSI::CString dataType, XSI::ICEAttribute &attr, XSI::Geometry &geo);
+// a 2D ICE attribute can also be read into a flat port ('Vec3[]' for 'Vec3[][]'), receiving the
+// values of all elements packed. the companion 'Integer[]' port flagged with the 'ICEAttributeOffsets'
+// option is passed as offsetsPort, it receives the start of each element plus the end (computed
+// while packing), so the KL operator can split them.
+void convertInputICEAttribute(FabricSplice::DGPort &port, XSI::CString dataType, XSI::ICEAttribute &attr, XSI::Geometry &geo, FabricSplice::DGPort *offsetsPort = NULL);
+bool isICEAttributePortDataType(const XSI::CString &portDataType, const XSI::CString &attrDataType);
+// hash of the content of an ICE attribute, used to skip converting attributes which didn't
+// change when something else on the geometry did. returns 0 for unsupported types.
+unsigned long long getICEAttributeHash(XSI::ICEAttribute &attr);
+// resolves the values of a per element ICE attribute as the memory of an external KL array of
+// klDataType ('Vec3' for a Vector3 attribute), without copying them. Quat and Mat44 values have
+// a different layout in ICE and are converted into buffer (only if convert is true, otherwise the
+// previous conversion is reused), the value of a constant attribute is repeated for all elements
+// into buffer the same way. returns false if the attribute doesn't match klDataType.
+bool getICEAttributeExternalArray(XSI::ICEAttribute &attr, const std::string &klDataType, const void *&data, unsigned int &count, std::vector<float> &buffer, bool convert);
 XSI::X3DObject getX3DObjectFromRef(const XSI::CRef &ref);
+// name of the PolygonMesh attribute receiving a UVW or color set after the first one: the
+// cluster property's name prefixed with "uvw_" or "color_", so it doesn't collide with the
+// other attributes of the mesh. used by the SpliceOp and the CanvasOp.
+std::string getExtraNodeSetAttributeName(const XSI::CString &clusterPropertyName, bool isUVWs);
 
-void convertInputPolygonMesh(XSI::PolygonMesh mesh, FabricCore::RTVal &rtVal);
+// staging arrays of the mesh conversions, kept per port by the operators.
+// the arrays only grow, so converting a mesh of the same size again doesn't allocate.
+struct meshStagingBuffers
+{
+  XSI::CDoubleArray positions;
+  XSI::CLongArray polygonCounts;
+  XSI::CLongArray indices;
+  XSI::MATH::CVector3Array points;
+  XSI::CFloatArray values;
+  std::vector<float> float32Points;
+
+  void release()
+  {
+    positions.Clear();
+    polygonCounts.Clear();
+    indices.Clear();
+    points.Clear();
+    values.Clear();
+    std::vector<float>().swap(float32Points);
+  }
+};
+
+// clusterEvalIDs (optional): evaluation IDs of the UV and color cluster properties of the
+// previous conversion of this mesh, the unchanged ones are not uploaded again.
+// buffers (optional): staging arrays to reuse, temporary ones are used if NULL.
+// float32Points: transfer the points as Float32 instead of Float64.
+void convertInputPolygonMesh(XSI::PolygonMesh mesh, FabricCore::RTVal &rtVal, std::vector<LONG> *clusterEvalIDs = NULL, meshStagingBuffers *buffers = NULL, bool float32Points = false);
 void convertInputLines(XSI::NurbsCurveList curveList, FabricCore::RTVal &rtVal);
 
-void convertOutputPolygonMesh(XSI::PolygonMesh mesh, FabricCore::RTVal &rtVal);
+void convertOutputPolygonMesh(XSI::PolygonMesh mesh, FabricCore::RTVal &rtVal, bool writeClusters = true, meshStagingBuffers *buffers = NULL, bool float32Points = false);
+// writes the UVs or vertex colors of a PolygonMesh port flagged with the 'driveClusters' option
+// (e.g. fabricSplice addOutputPort with "driveClusters": true) into its first UV / color cluster.
+void convertOutputPolygonMeshClusterProperty(XSI::ClusterProperty prop, FabricCore::RTVal &rtVal);
 void convertOutputLines(XSI::NurbsCurveList curveList, FabricCore::RTVal &rtVal);
 
+// Strands ports move the ICE strands of a point cloud (one strand per point) to a KL Lines, 
+// one polyline per strand, in one bulk copy per attribute:
+// StrandPosition -> positions, StrandSize -> 'width', ID -> 'strandID' (Integer), StrandUVW -> 'strandUV' (per strand point).
+// the output requires the point cloud to already hold one point per strand, and the strand
+// attributes to be set per point by an ICE tree below the operator (constant ones can't be written).
+void convertInputStrands(XSI::Geometry geo, FabricCore::RTVal &rtVal);
+bool convertOutputStrands(XSI::Geometry geo, FabricCore::RTVal &rtVal, XSI::CString &errorMessage);
+
+// PointCloud ports move the per point ICE attributes of a geometry to a KL Points in one pass,
+// one bulk copy per attribute: PointPosition -> positions, Size -> 'size', Velocity -> 'velocity',
+// Orientation -> 'orientation' (Vec4 x y z w), Color -> 'color', plus the custom attributes
+// listed in iceAttrNames (comma separated), named like the ICE attribute.
+// the output requires the geometry to already hold one point per KL point.
+void convertInputPointCloud(XSI::Geometry geo, FabricCore::RTVal &rtVal, const XSI::CString &iceAttrNames = L"");
+bool convertOutputPointCloud(XSI::Geometry geo, FabricCore::RTVal &rtVal, const XSI::CString &iceAttrNames, XSI::CString &errorMessage);
+
+// times the input conversions for the given objects and logs their throughput.
+// used by 'fabricSplice benchmarkConversion'. the conversion kernels of both directions
+// are also timed without Softimage by the standalone benchmark (see Benchmarks/SConscript).
+void benchmarkInputConversion(const XSI::CRefArray &targets, int iterations, const XSI::CString &iceAttrName = L"");
+
+// amount of bytes not transferred thanks to the Float32 point transfers (see 'transferPointsAsFloat32').
+size_t getFloat32PointsBytesSaved(bool reset = false);
+
 XSI::CRefArray PickObjectArray(XSI::CString firstTitle, XSI::CString nextTitle, XSI::CString filter = L"global", ULONG maxCount = 0);
 
 XSI::CString processNameCString(XSI::CString name);
@@ -0,0 +1,356 @@
+#include "FabricSpliceConversionKernels.h"
+
+#include <string.h>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+  #define FABRIC_SPLICE_SSE
+  #include <xmmintrin.h>
+#endif
+
+using namespace XSI;
+
+// ICE quaternions and matrices are converted to KL straight from the data array storage.
+// the memory layout of CQuaternionf / CMatrix4f is verified once, if it isn't the expected
+// one the conversion falls back to the accessors.
+enum ICEQuaternionLayout
+{
+  ICEQuaternionLayout_Unknown,
+  ICEQuaternionLayout_WXYZ,
+  ICEQuaternionLayout_XYZW
+};
+
+static ICEQuaternionLayout getICEQuaternionLayout()
+{
+  static int result = -1;
+  if(result < 0)
+  {
+    MATH::CQuaternionf q;
+    q.Set(1.0f, 2.0f, 3.0f, 4.0f);
+    const float * f = (const float*)&q;
+    result = ICEQuaternionLayout_Unknown;
+    if(sizeof(MATH::CQuaternionf) == sizeof(float) * 4)
+    {
+      if(f[0] == 1.0f && f[1] == 2.0f && f[2] == 3.0f && f[3] == 4.0f)
+        result = ICEQuaternionLayout_WXYZ;
+      else if(f[0] == 2.0f && f[1] == 3.0f && f[2] == 4.0f && f[3] == 1.0f)
+        result = ICEQuaternionLayout_XYZW;
+    }
+  }
+  return (ICEQuaternionLayout)result;
+}
+
+static bool hasICEMatrixLayoutRowMajor()
+{
+  static int result = -1;
+  if(result < 0)
+  {
+    MATH::CMatrix4f m;
+    for(int r=0;r<4;r++)
+      for(int c=0;c<4;c++)
+        m.SetValue(r, c, float(r * 4 + c));
+    const float * f = (const float*)&m;
+    result = sizeof(MATH::CMatrix4f) == sizeof(float) * 16 ? 1 : 0;
+    for(int i=0;i<16 && result == 1;i++)
+      result = f[i] == float(i) ? 1 : 0;
+  }
+  return result == 1;
+}
+
+static bool hasICEMatrix33LayoutRowMajor()
+{
+  static int result = -1;
+  if(result < 0)
+  {
+    MATH::CMatrix3f m;
+    for(int r=0;r<3;r++)
+      for(int c=0;c<3;c++)
+        m.SetValue(r, c, float(r * 3 + c));
+    const float * f = (const float*)&m;
+    result = sizeof(MATH::CMatrix3f) == sizeof(float) * 9 ? 1 : 0;
+    for(int i=0;i<9 && result == 1;i++)
+      result = f[i] == float(i) ? 1 : 0;
+  }
+  return result == 1;
+}
+
+// KL Quat is (x, y, z, w).
+void convertICEQuaternionsToKLLoop(const MATH::CQuaternionf * src, float * dst, size_t count)
+{
+  for(size_t i=0;i<count;i++)
+  {
+    *dst++ = src[i].GetX();
+    *dst++ = src[i].GetY();
+    *dst++ = src[i].GetZ();
+    *dst++ = src[i].GetW();
+  }
+}
+
+void convertICEQuaternionsToKL(const MATH::CQuaternionf * src, float * dst, size_t count)
+{
+  ICEQuaternionLayout layout = getICEQuaternionLayout();
+  if(layout == ICEQuaternionLayout_XYZW)
+  {
+    memcpy(dst, src, sizeof(float) * 4 * count);
+    return;
+  }
+  if(layout != ICEQuaternionLayout_WXYZ)
+  {
+    convertICEQuaternionsToKLLoop(src, dst, count);
+    return;
+  }
+  const float * s = (const float*)src;
+#ifdef FABRIC_SPLICE_SSE
+  for(size_t i=0;i<count;i++,s+=4,dst+=4)
+  {
+    __m128 q = _mm_loadu_ps(s);
+    _mm_storeu_ps(dst, _mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 3, 2, 1)));
+  }
+#else
+  for(size_t i=0;i<count;i++,s+=4,dst+=4)
+  {
+    dst[0] = s[1];
+    dst[1] = s[2];
+    dst[2] = s[3];
+    dst[3] = s[0];
+  }
+#endif
+}
+
+void convertKLQuaternionsToICE(const float * src, MATH::CQuaternionf * dst, size_t count)
+{
+  ICEQuaternionLayout layout = getICEQuaternionLayout();
+  if(layout == ICEQuaternionLayout_XYZW)
+  {
+    memcpy((float*)dst, src, sizeof(float) * 4 * count);
+    return;
+  }
+  if(layout != ICEQuaternionLayout_WXYZ)
+  {
+    for(size_t i=0;i<count;i++,src+=4)
+      dst[i].Set(src[3], src[0], src[1], src[2]);
+    return;
+  }
+  float * d = (float*)dst;
+#ifdef FABRIC_SPLICE_SSE
+  for(size_t i=0;i<count;i++,src+=4,d+=4)
+  {
+    __m128 q = _mm_loadu_ps(src);
+    _mm_storeu_ps(d, _mm_shuffle_ps(q, q, _MM_SHUFFLE(2, 1, 0, 3)));
+  }
+#else
+  for(size_t i=0;i<count;i++,src+=4,d+=4)
+  {
+    d[0] = src[3];
+    d[1] = src[0];
+    d[2] = src[1];
+    d[3] = src[2];
+  }
+#endif
+}
+
+// KL Mat44 rows are the columns of the XSI matrix.
+void convertICEMatricesToKLLoop(const MATH::CMatrix4f * src, float * dst, size_t count)
+{
+  for(size_t i=0;i<count;i++)
+  {
+    for(int c=0;c<4;c++)
+      for(int r=0;r<4;r++)
+        *dst++ = src[i].GetValue(r, c);
+  }
+}
+
+void convertICEMatricesToKL(const MATH::CMatrix4f * src, float * dst, size_t count)
+{
+  if(!hasICEMatrixLayoutRowMajor())
+  {
+    convertICEMatricesToKLLoop(src, dst, count);
+    return;
+  }
+  const float * s = (const float*)src;
+#ifdef FABRIC_SPLICE_SSE
+  for(size_t i=0;i<count;i++,s+=16,dst+=16)
+  {
+    __m128 r0 = _mm_loadu_ps(s);
+    __m128 r1 = _mm_loadu_ps(s + 4);
+    __m128 r2 = _mm_loadu_ps(s + 8);
+    __m128 r3 = _mm_loadu_ps(s + 12);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps(dst, r0);
+    _mm_storeu_ps(dst + 4, r1);
+    _mm_storeu_ps(dst + 8, r2);
+    _mm_storeu_ps(dst + 12, r3);
+  }
+#else
+  for(size_t i=0;i<count;i++,s+=16,dst+=16)
+  {
+    for(int c=0;c<4;c++)
+      for(int r=0;r<4;r++)
+        dst[c * 4 + r] = s[r * 4 + c];
+  }
+#endif
+}
+
+void convertKLMatricesToICE(const float * src, MATH::CMatrix4f * dst, size_t count)
+{
+  if(!hasICEMatrixLayoutRowMajor())
+  {
+    for(size_t i=0;i<count;i++,src+=16)
+    {
+      for(int r=0;r<4;r++)
+        for(int c=0;c<4;c++)
+          dst[i].SetValue(c, r, src[r * 4 + c]);
+    }
+    return;
+  }
+  // the transposition is its own inverse.
+  convertICEMatricesToKL((const MATH::CMatrix4f *)src, (float*)dst, count);
+}
+
+// KL Mat33 rows are the columns of the XSI matrix.
+void convertICEMatrices33ToKL(const MATH::CMatrix3f * src, float * dst, size_t count)
+{
+  if(!hasICEMatrix33LayoutRowMajor())
+  {
+    for(size_t i=0;i<count;i++)
+    {
+      for(int c=0;c<3;c++)
+        for(int r=0;r<3;r++)
+          *dst++ = src[i].GetValue(r, c);
+    }
+    return;
+  }
+  const float * s = (const float*)src;
+  for(size_t i=0;i<count;i++,s+=9,dst+=9)
+  {
+    dst[0] = s[0]; dst[1] = s[3]; dst[2] = s[6];
+    dst[3] = s[1]; dst[4] = s[4]; dst[5] = s[7];
+    dst[6] = s[2]; dst[7] = s[5]; dst[8] = s[8];
+  }
+}
+
+void convertKLMatrices33ToICE(const float * src, MATH::CMatrix3f * dst, size_t count)
+{
+  if(!hasICEMatrix33LayoutRowMajor())
+  {
+    for(size_t i=0;i<count;i++,src+=9)
+    {
+      for(int r=0;r<3;r++)
+        for(int c=0;c<3;c++)
+          dst[i].SetValue(c, r, src[r * 3 + c]);
+    }
+    return;
+  }
+  // the transposition is its own inverse.
+  convertICEMatrices33ToKL((const MATH::CMatrix3f *)src, (float*)dst, count);
+}
+
+// plain loops over contiguous memory, vectorised by the compiler.
+void convertDoublesToFloats(const double * src, size_t count, float * dst)
+{
+  for(size_t i=0;i<count;i++)
+    dst[i] = (float)src[i];
+}
+
+void convertFloatsToDoubles(const float * src, size_t count, double * dst)
+{
+  for(size_t i=0;i<count;i++)
+    dst[i] = (double)src[i];
+}
+
+// 64 bit hash of a block of memory. four independent lanes are mixed per 32 byte
+// block, which keeps the multipliers busy in parallel, and are folded at the end.
+size_t convertSegmentsToCurves(const uint32_t * indices, size_t nbSegments, uint32_t * curveVertices, uint32_t * curveCounts, uint8_t * curveClosed)
+{
+  size_t nbCurves = 0;
+  size_t voffset = 0;
+  size_t i = 0;
+  while(i < nbSegments)
+  {
+    size_t firstSegment = i;
+    while(i + 1 < nbSegments && indices[(i+1)*2] == indices[i*2+1])
+      i++;
+
+    bool isClosed = indices[firstSegment*2] == indices[i*2+1];
+    curveVertices[voffset++] = indices[firstSegment*2];
+    size_t lastSegment = isClosed ? i : i + 1;
+    for(size_t j=firstSegment;j<lastSegment;j++)
+      curveVertices[voffset++] = indices[j*2+1];
+
+    curveCounts[nbCurves] = uint32_t(lastSegment - firstSegment + 1);
+    curveClosed[nbCurves] = isClosed ? 1 : 0;
+    nbCurves++;
+    i++;
+  }
+  return nbCurves;
+}
+
+size_t convertCurvesToNurbs(const double * points, const uint32_t * curveVertices, const uint32_t * curveCounts, const uint8_t * curveClosed, size_t nbCurves, double * controlPoints, double * knots)
+{
+  size_t koffset = 0;
+  for(size_t i=0;i<nbCurves;i++)
+  {
+    uint32_t count = curveCounts[i];
+    for(uint32_t j=0;j<count;j++)
+    {
+      const double * p = points + size_t(*curveVertices++) * 3;
+      controlPoints[0] = p[0];
+      controlPoints[1] = p[1];
+      controlPoints[2] = p[2];
+      controlPoints[3] = 1.0;
+      controlPoints += 4;
+      knots[koffset++] = double(j);
+    }
+    if(curveClosed[i])
+      knots[koffset++] = double(count);
+  }
+  return koffset;
+}
+
+static inline unsigned long long rotl64(unsigned long long x, int r)
+{
+  return (x << r) | (x >> (64 - r));
+}
+
+unsigned long long hashBytes(const void * data, size_t bytes, unsigned long long seed)
+{
+  const unsigned long long prime1 = 11400714785074694791ULL;
+  const unsigned long long prime2 = 14029467366897019727ULL;
+  const unsigned long long prime3 = 1609587929392839161ULL;
+
+  const unsigned char * p = (const unsigned char *)data;
+  const unsigned char * end = p + bytes;
+  unsigned long long lanes[4] = { seed + prime1 + prime2, seed + prime2, seed, seed - prime1 };
+
+  while(p + 32 <= end)
+  {
+    for(int i=0;i<4;i++)
+    {
+      unsigned long long v;
+      memcpy(&v, p + i * 8, 8);
+      lanes[i] = rotl64(lanes[i] + v * prime2, 31) * prime1;
+    }
+    p += 32;
+  }
+
+  unsigned long long h = rotl64(lanes[0], 1) + rotl64(lanes[1], 7) + rotl64(lanes[2], 12) + rotl64(lanes[3], 18);
+  h += (unsigned long long)bytes;
+  while(p + 8 <= end)
+  {
+    unsigned long long v;
+    memcpy(&v, p, 8);
+    h = rotl64(h ^ (rotl64(v * prime2, 31) * prime1), 27) * prime1 + prime3;
+    p += 8;
+  }
+  while(p < end)
+  {
+    h = rotl64(h ^ ((*p) * prime3), 11) * prime1;
+    p++;
+  }
+
+  h ^= h >> 33;
+  h *= prime2;
+  h ^= h >> 29;
+  h *= prime3;
+  h ^= h >> 32;
+  return h;
+}
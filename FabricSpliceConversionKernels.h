@@ -0,0 +1,48 @@
+#ifndef _FabricSpliceConversionKernels_H_
+#define _FabricSpliceConversionKernels_H_
+
+#include <xsi_quaternionf.h>
+#include <xsi_matrix3f.h>
+#include <xsi_matrix4f.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// conversion kernels working on contiguous memory. they only depend on the XSI math
+// types (not on Fabric nor on a running Softimage), so they are shared by the port
+// conversions, the ICE nodes and the standalone conversion benchmark (see Benchmarks).
+
+// KL Quat is (x, y, z, w). the Loop version goes through the accessors, it is the
+// reference the kernel is compared against.
+void convertICEQuaternionsToKL(const XSI::MATH::CQuaternionf * src, float * dst, size_t count);
+void convertICEQuaternionsToKLLoop(const XSI::MATH::CQuaternionf * src, float * dst, size_t count);
+void convertKLQuaternionsToICE(const float * src, XSI::MATH::CQuaternionf * dst, size_t count);
+
+// KL Mat44 rows are the columns of the XSI matrix.
+void convertICEMatricesToKL(const XSI::MATH::CMatrix4f * src, float * dst, size_t count);
+void convertICEMatricesToKLLoop(const XSI::MATH::CMatrix4f * src, float * dst, size_t count);
+void convertKLMatricesToICE(const float * src, XSI::MATH::CMatrix4f * dst, size_t count);
+
+// same for KL Mat33 and the XSI 3x3 matrix.
+void convertICEMatrices33ToKL(const XSI::MATH::CMatrix3f * src, float * dst, size_t count);
+void convertKLMatrices33ToICE(const float * src, XSI::MATH::CMatrix3f * dst, size_t count);
+
+// used by the Float32 point transfers (see 'transferPointsAsFloat32').
+void convertDoublesToFloats(const double * src, size_t count, float * dst);
+void convertFloatsToDoubles(const float * src, size_t count, double * dst);
+
+// splits the segments of a KL Lines (pairs of point indices) into polylines: a curve
+// continues as long as a segment starts where the previous one ended, and is closed if
+// its last segment ends on its first point (which isn't repeated then). the outputs are
+// sized for the worst case: nbSegments * 2 curveVertices, nbSegments curves.
+// returns the number of curves. used by the Lines and the Strands outputs.
+size_t convertSegmentsToCurves(const uint32_t * indices, size_t nbSegments, uint32_t * curveVertices, uint32_t * curveCounts, uint8_t * curveClosed);
+
+// fills the control points (x, y, z, w) and the knots of degree 1 NurbsCurveList curves
+// from the result of convertSegmentsToCurves, points are (x, y, z). closed curves get an
+// extra knot. returns the number of knots.
+size_t convertCurvesToNurbs(const double * points, const uint32_t * curveVertices, const uint32_t * curveCounts, const uint8_t * curveClosed, size_t nbCurves, double * controlPoints, double * knots);
+
+// 64 bit hash of a block of memory, used to detect unchanged ICE attributes.
+unsigned long long hashBytes(const void * data, size_t bytes, unsigned long long seed);
+
+#endif
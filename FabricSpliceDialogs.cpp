@@ -59,6 +59,7 @@ SICALLBACK SpliceEditor_Define( CRef& in_ctxt )
   prop.AddParameter(L"availablePorts", CValue::siString, 0, "", "", "", param);
   prop.AddParameter(L"klCode", CValue::siString, 0, "", "", "", param);
   prop.AddParameter(L"klErrors", CValue::siString, siReadOnly, "", "", "", param);
+  prop.AddParameter(L"compileStatus", CValue::siString, siReadOnly, "", "", "", param);
   return CStatus::OK;
 }
 
@@ -163,6 +164,8 @@ SICALLBACK SpliceEditor_DefineLayout( CRef& in_ctxt )
   item = layout.AddButton("compileOperator", "Compile KL");
   item.PutAttribute(siUICX, gButtonWidth);
   item.PutAttribute(siUICY, gButtonHeight);
+  item = layout.AddItem("compileStatus", "Status");
+  item.PutAttribute(siUINoLabel, true);
   layout.EndRow();
 
   item = layout.AddItem( "availablePorts", "Available Ports", siControlTextEditor);
@@ -347,7 +350,7 @@ void updateSpliceEditorGrids(CustomProperty & prop)
     {
       CString portName = graph.getDGPortName(i);
       FabricSplice::DGPort port = graph.getDGPort(portName.GetAsciiString());
-      CString portType = port.getDataType();
+      CString portType = getXSIDataTypeFromPort(port);
       if(port.isArray())
         portType += L"[]";
       FabricSplice::Port_Mode portMode = port.getMode();
@@ -469,6 +472,10 @@ SICALLBACK SpliceEditor_PPGEvent( CRef& in_ctxt )
             portName = "mesh0";
           else if(dataType == "Lines")
             portName = "lines";
+          else if(dataType == "Strands")
+            portName = "strands";
+          else if(dataType == "PointCloud")
+            portName = "points";
           else if(dataType == "Mat44")
             portName = "matrix";
           else if(dataType == "Mat44[]")
@@ -694,6 +701,8 @@ SICALLBACK SpliceEditor_PPGEvent( CRef& in_ctxt )
             filter = L"polymsh";
           else if(dataType.IsEqualNoCase(L"Lines") || dataType.IsEqualNoCase(L"Lines[]"))
             filter = L"crvlist";
+          else if(dataType.IsEqualNoCase(L"Strands") || dataType.IsEqualNoCase(L"PointCloud"))
+            filter = L"pointcloud";
           CRefArray items = PickObjectArray(L"Pick object", L"Pick next object", filter, isArray ? 0 : 1);
           if(items.GetCount() > 0)
           {
@@ -795,7 +804,7 @@ SICALLBACK SpliceEditor_PPGEvent( CRef& in_ctxt )
         CString portName = graph.getDGPortName(gridSelection[1]);
 
         FabricSplice::DGPort port = graph.getDGPort(gridSelection[1]);
-        CString dataType = port.getDataType();
+        CString dataType = getXSIDataTypeFromPort(port);
         bool isArray = port.isArray();
         bool isICEAttribute = port.getOption("ICEAttribute").isString();
         CString filter = L"global";
@@ -803,6 +812,8 @@ SICALLBACK SpliceEditor_PPGEvent( CRef& in_ctxt )
           filter = L"polymsh";
         if(dataType == L"Lines")
           filter = L"crvlist";
+        else if(dataType == L"Strands" || dataType == L"PointCloud")
+          filter = L"pointcloud";
         else if(isICEAttribute)
           filter = L"geometry";
 
@@ -900,6 +911,7 @@ SICALLBACK SpliceEditor_PPGEvent( CRef& in_ctxt )
             args[2] = L"{\"opName\":\""+opName+"\"}";
             args[3] = kl;
             Application().ExecuteCommand(L"fabricSplice", args, returnVal);
+            prop.PutParameterValue(L"compileStatus", interf->getCompileStatus());
           }          
         }
       }
@@ -1231,7 +1243,7 @@ void updateImportSpliceDialogGrids(CustomProperty & prop)
     {
       CString portName = graph.getDGPortName(i);
       FabricSplice::DGPort port = graph.getDGPort(portName.GetAsciiString());
-      CString portType = port.getDataType();
+      CString portType = getXSIDataTypeFromPort(port);
       if(port.isArray())
         portType += L"[]";
       FabricSplice::Port_Mode portMode = port.getMode();
@@ -1255,7 +1267,9 @@ void updateImportSpliceDialogGrids(CustomProperty & prop)
         portType == L"Mat44" || 
         portType == L"Mat44[]" || 
         portType == L"PolygonMesh" ||
-        portType == L"Lines") || 
+        portType == L"Lines" ||
+        portType == L"Strands" ||
+        portType == L"PointCloud") || 
         xsiPortType != SoftimagePortType_Port)
         continue;
 
@@ -1393,6 +1407,8 @@ SICALLBACK ImportSpliceDialog_PPGEvent( CRef& in_ctxt )
           filter = L"polymsh";
         else if(dataType.IsEqualNoCase(L"Lines"))
           filter = L"crvlist";
+        else if(dataType.IsEqualNoCase(L"Strands") || dataType.IsEqualNoCase(L"PointCloud"))
+          filter = L"pointcloud";
         if(isIceAttribute)
           filter = L"geometry";
         CRefArray items = PickObjectArray(
@@ -1404,7 +1420,7 @@ SICALLBACK ImportSpliceDialog_PPGEvent( CRef& in_ctxt )
           {
             CString errorMessage;
             CString iceAttribute = portTarget.Split(":").GetCount() > 1 ? portTarget.Split(":")[1] : portTarget.Split(":")[0];
-            if(dataType != getSpliceDataTypeFromICEAttribute(items, iceAttribute, errorMessage))
+            if(!isICEAttributePortDataType(dataType, getSpliceDataTypeFromICEAttribute(items, iceAttribute, errorMessage)))
             {
               xsiLogErrorFunc(errorMessage);
               xsiLogErrorFunc("Data type of picked item(s) does not match '"+dataType+"'.");
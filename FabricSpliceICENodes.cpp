@@ -43,6 +43,7 @@
 #include "FabricSplicePlugin.h"
 #include "FabricSpliceICENodes.h"
 #include "FabricSpliceBaseInterface.h"
+#include "FabricSpliceConversionKernels.h"
 
 using namespace XSI;
 
@@ -60,6 +61,19 @@ enum IDs
   spliceGetData_ID_UNDEF = ULONG_MAX
 };
 
+enum SetIDs
+{
+  spliceSetData_ID_IN_reference = 0,
+  spliceSetData_ID_IN_klType = 1,
+  spliceSetData_ID_IN_value = 2,
+  spliceSetData_ID_G_100 = 100,
+  spliceSetData_ID_OUT_execute = 200,
+  spliceSetData_ID_TYPE_CNS = 400,
+  spliceSetData_ID_STRUCT_CNS,
+  spliceSetData_ID_CTXT_CNS,
+  spliceSetData_ID_UNDEF = ULONG_MAX
+};
+
 using namespace XSI;
 
 CStatus Register_spliceGetData( PluginRegistrar& in_reg )
@@ -70,10 +84,15 @@ CStatus Register_spliceGetData( PluginRegistrar& in_reg )
   PluginItem nodeItem;
 
   int supportedDataTypes = 
+    siICENodeDataBool |
     siICENodeDataLong |
     siICENodeDataFloat |
+    siICENodeDataVector2 |
     siICENodeDataVector3 |
-    siICENodeDataColor4;
+    siICENodeDataColor4 |
+    siICENodeDataQuaternion |
+    siICENodeDataMatrix33 |
+    siICENodeDataMatrix44;
 
   int supportedTriggerTypes = supportedDataTypes |
     siICENodeDataQuaternion |
@@ -114,7 +133,7 @@ CStatus Register_spliceGetData( PluginRegistrar& in_reg )
   st = nodeDef.PutColor(39,168,223);
   st.AssertSucceeded( ) ;
 
-  st = nodeDef.PutThreadingModel(siICENodeSingleThreading);
+  st = nodeDef.PutThreadingModel(siICENodeMultiThreading);
   st.AssertSucceeded( ) ;
 
   // Add input ports and groups.
@@ -137,154 +156,347 @@ CStatus Register_spliceGetData( PluginRegistrar& in_reg )
   return CStatus::OK;
 }
 
-SICALLBACK spliceGetData_BeginEvaluate(ICENodeContext& in_ctxt)
+// splits a KL type name such as 'Vec3[][]' into its base type and array dimensions.
+static void decodeKLDataType(const std::string & klDataType, std::string & klBaseDataType, int & klArrayDimensions)
 {
-  XSI::siICENodeDataType dataType;
-  XSI::siICENodeStructureType dataStruct;
-  XSI::siICENodeContextType dataContext;
-  in_ctxt.GetPortInfo( spliceGetData_ID_OUT_Result, dataType, dataStruct, dataContext );
-
-  CDataArrayString referenceArray(in_ctxt, spliceGetData_ID_IN_reference);
-  CString reference = referenceArray[0];
-  CDataArrayString klTypeArray(in_ctxt, spliceGetData_ID_IN_klType);
-  CString klType = klTypeArray[0];
-
-  // invalidate the stored rtval
-  CValue udVal = in_ctxt.GetUserData();
-  iceNodeUD * ud = (iceNodeUD*)(CValue::siPtrType)udVal;
-  FabricSpliceBaseInterface * interf = FabricSpliceBaseInterface::getInstanceByObjectID(ud->objectID);
-  ud->interf = interf;
-  if(!interf)
-    return CStatus::OK;
-  interf->setICENodeRTVal(FabricCore::RTVal());
-
-  if(reference.Length() == 0)
+  klBaseDataType = klDataType;
+  klArrayDimensions = 0;
+  std::string klBrackets = klDataType;
+  int klBracketPos = klBrackets.find('[');
+  while(klBracketPos != std::string::npos)
   {
-    Application().LogMessage(CString("spliceGetData") + " uses an empty reference string.", siErrorMsg );
-    return CStatus::OK;
+    if(klBrackets[0] != ']')
+      klBaseDataType = klBrackets.substr(0, klBracketPos);
+    klBrackets = klBrackets.substr(klBracketPos+1, klBrackets.length());
+    klBracketPos = klBrackets.find('[');
+    klArrayDimensions++;
   }
+}
 
-  CStringArray referenceParts = reference.Split(".");
-  if(referenceParts.GetCount() <= 1)
+// validates that the ICE port type matches the KL member type.
+static bool validateICEPortType(const CString & nodeName, const CString & reference, const std::string & klDataType, const std::string & klBaseDataType, int klArrayDimensions, XSI::siICENodeDataType dataType, XSI::siICENodeStructureType dataStruct, XSI::siICENodeContextType dataContext)
+{
+  if(klArrayDimensions == 1)
   {
-    Application().LogMessage(CString("spliceGetData") + "'s reference contains less than two parts.", siErrorMsg );
-    return CStatus::OK;
+    if(dataStruct == siICENodeStructureSingle && dataContext == siICENodeContextSingleton)
+    {
+      Application().LogMessage(nodeName + "'s reference " + reference + " refers to a " + CString((LONG)klArrayDimensions) + " dimensional array, but the connected ICE ports are singleton of single value.", siErrorMsg );
+      return false;
+    }
+    else if(dataStruct == siICENodeStructureArray && dataContext != siICENodeContextSingleton)
+    {
+      Application().LogMessage(nodeName + "'s reference " + reference + " refers to a " + CString((LONG)klArrayDimensions) + " dimensional array, but the connected ICE ports are a multi of array value.", siErrorMsg );
+      return false;
+    }
   }
-
-  if(klType.Length() == 0)
+  else if(klArrayDimensions == 2)
   {
-    Application().LogMessage(CString("spliceGetData") + " uses an empty klType string.", siErrorMsg );
-    return CStatus::OK;
+    if(dataContext == siICENodeContextSingleton || dataStruct != siICENodeStructureArray)
+    {
+      Application().LogMessage(nodeName + "'s reference " + reference + " refers to a " + CString((LONG)klArrayDimensions) + " dimensional array, but the connected ICE ports are not a multi of array value.", siErrorMsg );
+      return false;
+    }
+  }
+  else if(klArrayDimensions > 2)
+  {
+    Application().LogMessage(nodeName + "'s reference " + reference + " refers to a " + CString((LONG)klArrayDimensions) + " dimensional array, but only a max of 2 dimensions are supported.", siErrorMsg );
+    return false;
   }
 
-  try
+  if(klBaseDataType == "Boolean")
   {
-    FabricCore::RTVal handleVal = FabricSplice::constructObjectRTVal("SingletonHandle");
-    FabricCore::RTVal keyVal = FabricSplice::constructStringRTVal(referenceParts[0].GetAsciiString());
-    FabricCore::RTVal singletonVal = handleVal.callMethod(klType.GetAsciiString(), "getObject", 1, &keyVal);
-    if(!singletonVal.isValid())
+    if(dataType != siICENodeDataBool)
     {
-      Application().LogMessage(CString("spliceGetData") + "'s reference refers to a singleton, which does not exist: " + referenceParts[0], siErrorMsg );
-      return CStatus::OK;
+      Application().LogMessage(nodeName + "'s reference " + reference + " refers to a " + CString(klDataType.c_str()) + " value, but the ICE port is not of siICENodeDataBool.", siErrorMsg );
+      return false;
     }
-
-    if(singletonVal.isNullObject())
+  }
+  else if(klBaseDataType == "Integer" || klBaseDataType == "SInt32" || klBaseDataType == "UInt32")
+  {
+    if(dataType != siICENodeDataLong)
     {
-      Application().LogMessage(CString("spliceGetData") + "'s reference refers to a singleton, which does not exist: " + referenceParts[0], siErrorMsg );
-      return CStatus::OK;
+      Application().LogMessage(nodeName + "'s reference " + reference + " refers to a " + CString(klDataType.c_str()) + " value, but the ICE port is not of siICENodeDataLong.", siErrorMsg );
+      return false;
     }
-
-    for(unsigned int i=1;i<referenceParts.GetCount();i++)
+  }
+  else if(klBaseDataType == "Scalar" || klBaseDataType == "Float32")
+  {
+    if(dataType != siICENodeDataFloat)
     {
-      FabricCore::RTVal memberVal = singletonVal.maybeGetMember(referenceParts[i].GetAsciiString());
-      if(!memberVal.isValid())
-      {
-        Application().LogMessage(CString("spliceGetData") + "'s reference " + reference + " to a member, which does not exist: " + referenceParts[i], siErrorMsg );
-        return CStatus::OK;
-      }
-      singletonVal = memberVal;
+      Application().LogMessage(nodeName + "'s reference " + reference + " refers to a " + CString(klDataType.c_str()) + " value, but the ICE port is not of siICENodeDataFloat.", siErrorMsg );
+      return false;
     }
-
-    std::string klDataType = singletonVal.getTypeName().getStringCString();
-    std::string klBaseDataType = klDataType;
-    std::string klBrackets = klDataType;
-    int klArrayDimensions = 0;
-    int klBracketPos = klBrackets.find('[');
-    while(klBracketPos != std::string::npos)
+  }
+  else if(klBaseDataType == "Vec2")
+  {
+    if(dataType != siICENodeDataVector2)
     {
-      if(klBrackets[0] != ']')
-        klBaseDataType = klBrackets.substr(0, klBracketPos);
-      klBrackets = klBrackets.substr(klBracketPos+1, klBrackets.length());
-      klBracketPos = klBrackets.find('[');
-      klArrayDimensions++;
+      Application().LogMessage(nodeName + "'s reference " + reference + " refers to a " + CString(klDataType.c_str()) + " value, but the ICE port is not of siICENodeDataVector2.", siErrorMsg );
+      return false;
     }
-
-    if(klArrayDimensions == 1)
+  }
+  else if(klBaseDataType == "Vec3")
+  {
+    if(dataType != siICENodeDataVector3)
     {
-      if(dataStruct == siICENodeStructureSingle && dataContext == siICENodeContextSingleton)
-      {
-        Application().LogMessage(CString("spliceGetData") + "'s reference " + reference + " refers to a " + CString((LONG)klArrayDimensions) + " dimensional array, but the connected ICE ports are singleton of single value.", siErrorMsg );
-        return CStatus::OK;
-      }
-      else if(dataStruct == siICENodeStructureArray && dataContext != siICENodeContextSingleton)
-      {
-        Application().LogMessage(CString("spliceGetData") + "'s reference " + reference + " refers to a " + CString((LONG)klArrayDimensions) + " dimensional array, but the connected ICE ports are a multi of array value.", siErrorMsg );
-        return CStatus::OK;
-      }
+      Application().LogMessage(nodeName + "'s reference " + reference + " refers to a " + CString(klDataType.c_str()) + " value, but the ICE port is not of siICENodeDataVector3.", siErrorMsg );
+      return false;
     }
-    else if(klArrayDimensions == 2)
+  }
+  else if(klBaseDataType == "Color")
+  {
+    if(dataType != siICENodeDataColor4)
     {
-      if(dataContext == siICENodeContextSingleton || dataStruct != siICENodeStructureArray)
-      {
-        Application().LogMessage(CString("spliceGetData") + "'s reference " + reference + " refers to a " + CString((LONG)klArrayDimensions) + " dimensional array, but the connected ICE ports are not a multi of array value.", siErrorMsg );
-        return CStatus::OK;
-      }
+      Application().LogMessage(nodeName + "'s reference " + reference + " refers to a " + CString(klDataType.c_str()) + " value, but the ICE port is not of siICENodeDataColor4.", siErrorMsg );
+      return false;
+    }
+  }
+  else if(klBaseDataType == "Quat")
+  {
+    if(dataType != siICENodeDataQuaternion)
+    {
+      Application().LogMessage(nodeName + "'s reference " + reference + " refers to a " + CString(klDataType.c_str()) + " value, but the ICE port is not of siICENodeDataQuaternion.", siErrorMsg );
+      return false;
     }
-    else if(klArrayDimensions > 2)
+  }
+  else if(klBaseDataType == "Mat33")
+  {
+    if(dataType != siICENodeDataMatrix33)
     {
-      Application().LogMessage(CString("spliceGetData") + "'s reference " + reference + " refers to a " + CString((LONG)klArrayDimensions) + " dimensional array, but only a max of 2 dimensions are supported.", siErrorMsg );
-      return CStatus::OK;
+      Application().LogMessage(nodeName + "'s reference " + reference + " refers to a " + CString(klDataType.c_str()) + " value, but the ICE port is not of siICENodeDataMatrix33.", siErrorMsg );
+      return false;
+    }
+  }
+  else if(klBaseDataType == "Mat44")
+  {
+    if(dataType != siICENodeDataMatrix44)
+    {
+      Application().LogMessage(nodeName + "'s reference " + reference + " refers to a " + CString(klDataType.c_str()) + " value, but the ICE port is not of siICENodeDataMatrix44.", siErrorMsg );
+      return false;
     }
+  }
+  else
+  {
+    Application().LogMessage(nodeName + "'s reference " + reference + " refers to a " + CString(klDataType.c_str()) + " value, which is not supported.", siErrorMsg );
+    return false;
+  }
+
+  return true;
+}
 
-    if(klBaseDataType == "Integer" || klBaseDataType == "SInt32")
+// resolves the cached 'singleton.member.member' path from the current singleton,
+// storing the resolved member as well as the object owning it (required to
+// write the member back). the singleton itself is looked up every time, so
+// replacing it in the SingletonHandle is picked up without a cache flush.
+// if it is still the same object and the member is owned by an object (a
+// reference, unlike structs), only the member is read again from its owner.
+static bool resolveSingletonMember(const CString & nodeName, const CString & reference, const CString & klType, iceNodeUD * ud)
+{
+  FabricCore::RTVal singletonVal = ud->handleVal.callMethod(klType.GetAsciiString(), "getObject", 1, &ud->keyVal);
+  if(!singletonVal.isValid() || singletonVal.isNullObject())
+  {
+    Application().LogMessage(nodeName + "'s reference refers to a singleton, which does not exist: " + CString(ud->memberPath[0].c_str()), siErrorMsg );
+    ud->pathVals.clear();
+    return false;
+  }
+
+  if(ud->pathVals.size() == ud->memberPath.size() && ud->parentVal.isObject() && ud->pathVals[0].isExEQTo(singletonVal))
+  {
+    FabricCore::RTVal memberVal = ud->parentVal.maybeGetMember(ud->memberName.c_str());
+    if(memberVal.isValid())
     {
-      if(dataType != siICENodeDataLong)
-      {
-        Application().LogMessage(CString("spliceGetData") + "'s reference " + reference + " refers to a " + CString(klDataType.c_str()) + " value, but the ICE port is not of siICENodeDataLong.", siErrorMsg );
-        return CStatus::OK;
-      }
+      ud->pathVals.back() = memberVal;
+      ud->memberVal = memberVal;
+      return true;
     }
-    else if(klBaseDataType == "Scalar" || klBaseDataType == "Float32")
+  }
+
+  ud->pathVals.resize(1);
+  ud->pathVals[0] = singletonVal;
+  for(size_t i=1;i<ud->memberPath.size();i++)
+  {
+    FabricCore::RTVal memberVal = singletonVal.maybeGetMember(ud->memberPath[i].c_str());
+    if(!memberVal.isValid())
     {
-      if(dataType != siICENodeDataFloat)
-      {
-        Application().LogMessage(CString("spliceGetData") + "'s reference " + reference + " refers to a " + CString(klDataType.c_str()) + " value, but the ICE port is not of siICENodeDataFloat.", siErrorMsg );
-        return CStatus::OK;
-      }
+      Application().LogMessage(nodeName + "'s reference " + reference + " to a member, which does not exist: " + CString(ud->memberPath[i].c_str()), siErrorMsg );
+      ud->pathVals.clear();
+      return false;
     }
-    else if(klBaseDataType == "Vec3")
+    ud->parentVal = singletonVal;
+    ud->memberName = ud->memberPath[i];
+    ud->pathVals.push_back(memberVal);
+    singletonVal = memberVal;
+  }
+
+  ud->memberVal = singletonVal;
+  return true;
+}
+
+// parses the reference and decodes the member's KL type, validating it against
+// the connected ICE port. the result is kept in the node's user data and only
+// rebuilt when the reference, the klType or the ICE port type change.
+// resolved is true if the member was resolved while rebuilding.
+static bool updateSingletonMemberCache(const CString & nodeName, iceNodeUD * ud, const CString & reference, const CString & klType, XSI::siICENodeDataType dataType, XSI::siICENodeStructureType dataStruct, XSI::siICENodeContextType dataContext, bool allowPacked, bool & resolved)
+{
+  resolved = false;
+  if(ud->cacheValid &&
+    ud->cachedReference == reference &&
+    ud->cachedKLType == klType &&
+    ud->cachedDataType == (int)dataType &&
+    ud->cachedDataStruct == (int)dataStruct &&
+    ud->cachedDataContext == (int)dataContext)
+    return true;
+
+  ud->cacheValid = false;
+
+  if(reference.Length() == 0)
+  {
+    Application().LogMessage(nodeName + " uses an empty reference string.", siErrorMsg );
+    return false;
+  }
+
+  CStringArray referenceParts = reference.Split(".");
+  if(referenceParts.GetCount() <= 1)
+  {
+    Application().LogMessage(nodeName + "'s reference contains less than two parts.", siErrorMsg );
+    return false;
+  }
+
+  if(klType.Length() == 0)
+  {
+    Application().LogMessage(nodeName + " uses an empty klType string.", siErrorMsg );
+    return false;
+  }
+
+  ud->memberPath.clear();
+  for(LONG i=0;i<referenceParts.GetCount();i++)
+    ud->memberPath.push_back(referenceParts[i].GetAsciiString());
+  ud->handleVal = FabricSplice::constructObjectRTVal("SingletonHandle");
+  ud->keyVal = FabricSplice::constructStringRTVal(ud->memberPath[0].c_str());
+  ud->pathVals.clear();
+
+  if(!resolveSingletonMember(nodeName, reference, klType, ud))
+    return false;
+  resolved = true;
+
+  ud->klDataType = ud->memberVal.getTypeName().getStringCString();
+  decodeKLDataType(ud->klDataType, ud->klBaseDataType, ud->klArrayDimensions);
+
+  // a flat array read into a multi of array value is a packed 2D array,
+  // if the owner provides the offsets of each element next to it.
+  ud->packed = false;
+  ud->offsetsName.clear();
+  if(allowPacked && ud->klArrayDimensions == 1 && dataContext != siICENodeContextSingleton && dataStruct == siICENodeStructureArray)
+  {
+    std::string offsetsName = ud->memberName + "Offsets";
+    FabricCore::RTVal offsetsVal = ud->parentVal.maybeGetMember(offsetsName.c_str());
+    if(offsetsVal.isValid())
     {
-      if(dataType != siICENodeDataVector3)
+      std::string offsetsType = offsetsVal.getTypeName().getStringCString();
+      if(offsetsType == "Integer[]" || offsetsType == "SInt32[]" || offsetsType == "UInt32[]")
       {
-        Application().LogMessage(CString("spliceGetData") + "'s reference " + reference + " refers to a " + CString(klDataType.c_str()) + " value, but the ICE port is not of siICENodeDataVector3.", siErrorMsg );
-        return CStatus::OK;
+        ud->packed = true;
+        ud->offsetsName = offsetsName;
       }
     }
-    else if(klBaseDataType == "Color")
+  }
+
+  if(!validateICEPortType(nodeName, reference, ud->klDataType, ud->klBaseDataType, ud->packed ? 2 : ud->klArrayDimensions, dataType, dataStruct, dataContext))
+    return false;
+
+  ud->cachedReference = reference;
+  ud->cachedKLType = klType;
+  ud->cachedDataType = (int)dataType;
+  ud->cachedDataStruct = (int)dataStruct;
+  ud->cachedDataContext = (int)dataContext;
+  ud->cacheValid = true;
+  return true;
+}
+
+static void resetICENodeUD(iceNodeUD * ud)
+{
+  ud->valid = false;
+  ud->data = NULL;
+  ud->arraySize = 0;
+  ud->subArrayData.clear();
+  ud->subArraySizes.clear();
+  ud->offsetsVal = FabricCore::RTVal();
+  ud->offsets = NULL;
+  ud->valueCount = 0;
+  ud->memberVal = FabricCore::RTVal();
+}
+
+SICALLBACK spliceGetData_BeginEvaluate(ICENodeContext& in_ctxt)
+{
+  XSI::siICENodeDataType dataType;
+  XSI::siICENodeStructureType dataStruct;
+  XSI::siICENodeContextType dataContext;
+  in_ctxt.GetPortInfo( spliceGetData_ID_OUT_Result, dataType, dataStruct, dataContext );
+
+  CDataArrayString referenceArray(in_ctxt, spliceGetData_ID_IN_reference);
+  CString reference = referenceArray[0];
+  CDataArrayString klTypeArray(in_ctxt, spliceGetData_ID_IN_klType);
+  CString klType = klTypeArray[0];
+
+  // invalidate the stored rtval
+  CValue udVal = in_ctxt.GetUserData();
+  iceNodeUD * ud = (iceNodeUD*)(CValue::siPtrType)udVal;
+  FabricSpliceBaseInterface * interf = FabricSpliceBaseInterface::getInstanceByObjectID(ud->objectID);
+  ud->interf = interf;
+  resetICENodeUD(ud);
+  if(!interf)
+    return CStatus::OK;
+  interf->setICENodeRTVal(FabricCore::RTVal());
+
+  try
+  {
+    bool resolved = false;
+    if(!updateSingletonMemberCache("spliceGetData", ud, reference, klType, dataType, dataStruct, dataContext, true, resolved))
+      return CStatus::OK;
+    if(!resolved && !resolveSingletonMember("spliceGetData", reference, klType, ud))
+      return CStatus::OK;
+
+    FabricCore::RTVal singletonVal = ud->memberVal;
+    int klArrayDimensions = ud->klArrayDimensions;
+    interf->setICENodeRTVal(singletonVal);
+
+    // resolve the data pointers once, so that the multi threaded
+    // evaluation only has to copy its range of elements.
+    if(ud->packed)
     {
-      if(dataType != siICENodeDataColor4)
+      ud->offsetsVal = ud->parentVal.maybeGetMember(ud->offsetsName.c_str());
+      if(!ud->offsetsVal.isValid())
       {
-        Application().LogMessage(CString("spliceGetData") + "'s reference " + reference + " refers to a " + CString(klDataType.c_str()) + " value, but the ICE port is not of siICENodeDataColor4.", siErrorMsg );
+        Application().LogMessage(CString("spliceGetData") + "'s reference " + reference + " to a member, which does not exist: " + CString(ud->offsetsName.c_str()), siErrorMsg );
         return CStatus::OK;
       }
+      unsigned int offsetsCount = ud->offsetsVal.getArraySize();
+      ud->arraySize = offsetsCount > 0 ? offsetsCount - 1 : 0;
+      ud->valueCount = singletonVal.getArraySize();
+      if(offsetsCount > 0)
+        ud->offsets = (const int32_t*)ud->offsetsVal.callMethod("Data", "data", 0, 0).getData();
+      if(ud->valueCount > 0)
+        ud->data = singletonVal.callMethod("Data", "data", 0, 0).getData();
+    }
+    else if(klArrayDimensions < 2)
+    {
+      ud->data = singletonVal.callMethod("Data", "data", 0, 0).getData();
+      if(klArrayDimensions == 1)
+        ud->arraySize = singletonVal.getArraySize();
     }
     else
     {
-      Application().LogMessage(CString("spliceGetData") + "'s reference " + reference + " refers to a " + CString(klDataType.c_str()) + " value, which is not supported.", siErrorMsg );
-      return CStatus::OK;
+      ud->arraySize = singletonVal.getArraySize();
+      ud->subArrayData.resize(ud->arraySize);
+      ud->subArraySizes.resize(ud->arraySize);
+      for(unsigned int i=0;i<ud->arraySize;i++)
+      {
+        FabricCore::RTVal subRtVal = singletonVal.getArrayElement(i);
+        ud->subArrayData[i] = subRtVal.callMethod("Data", "data", 0, 0).getData();
+        ud->subArraySizes[i] = subRtVal.getArraySize();
+      }
     }
-
-    interf->setICENodeRTVal(singletonVal);
+    ud->valid = true;
   }
   catch(FabricCore::Exception e)
   {
@@ -300,289 +512,284 @@ SICALLBACK spliceGetData_BeginEvaluate(ICENodeContext& in_ctxt)
   return CStatus::OK;
 }
 
-SICALLBACK spliceGetData_Evaluate(ICENodeContext& in_ctxt)
+static void copyBatchRun(char * iceData, char * klData, ULONG iceIndex, ULONG klIndex, ULONG count, size_t elementBytes, bool toKL)
 {
-  XSI::siICENodeDataType dataType;
-  XSI::siICENodeStructureType dataStruct;
-  XSI::siICENodeContextType dataContext;
-  in_ctxt.GetPortInfo( spliceGetData_ID_OUT_Result, dataType, dataStruct, dataContext );
+  if(count == 0)
+    return;
+  if(toKL)
+    memcpy(klData + klIndex * elementBytes, iceData + iceIndex * elementBytes, count * elementBytes);
+  else
+    memcpy(iceData + iceIndex * elementBytes, klData + klIndex * elementBytes, count * elementBytes);
+}
 
-  CDataArrayString referenceArray(in_ctxt, spliceGetData_ID_IN_reference);
-  CString reference = referenceArray[0];
+// copies the elements of the current ICE batch between an ICE data array and
+// a flat KL array, in either direction. the batch usually is a single
+// [begin, end) range of the KL array, so the copy is done per contiguous run
+// of indices rather than per element.
+static bool copyBatchRange(CIndexSet & indexSet, char * iceData, char * klData, ULONG klCount, size_t elementBytes, bool toKL)
+{
+  ULONG runIce = 0;
+  ULONG runKL = 0;
+  ULONG runLength = 0;
+  for(CIndexSet::Iterator it = indexSet.Begin(); it.HasNext(); it.Next())
+  {
+    ULONG iceIndex = it;
+    ULONG klIndex = it.GetAbsoluteIndex();
+    if(klIndex >= klCount)
+      return false;
+    if(runLength > 0 && iceIndex == runIce + runLength && klIndex == runKL + runLength)
+    {
+      runLength++;
+      continue;
+    }
+    copyBatchRun(iceData, klData, runIce, runKL, runLength, elementBytes, toKL);
+    runIce = iceIndex;
+    runKL = klIndex;
+    runLength = 1;
+  }
+  copyBatchRun(iceData, klData, runIce, runKL, runLength, elementBytes, toKL);
+  return true;
+}
 
-  CValue udVal = in_ctxt.GetUserData();
-  iceNodeUD * ud = (iceNodeUD*)(CValue::siPtrType)udVal;
-  FabricSpliceBaseInterface * interf = ud->interf;
-  if(!interf)
-    return CStatus::OK;
-  FabricCore::RTVal rtVal = interf->getICENodeRTVal();
-  if(!rtVal.isValid())
-    return CStatus::OK;
+// copies one run of count elements through the LAYOUT, in either direction.
+template<class LAYOUT, class ICEDATA>
+static void copyLayoutRun(ICEDATA & iceData, ULONG iceIndex, char * klData, ULONG count, size_t elementBytes, bool toKL)
+{
+  if(toKL)
+    LAYOUT::copyToKL(klData, iceData, iceIndex, count, elementBytes);
+  else
+    LAYOUT::copy(iceData, iceIndex, klData, count, elementBytes);
+}
 
-  std::string klDataType = rtVal.getTypeName().getStringCString();
-  std::string klBrackets = klDataType;
-  int klArrayDimensions = 0;
-  int klBracketPos = klBrackets.find('[');
-  while(klBracketPos != std::string::npos)
+// copies the elements of the current ICE batch between an ICE data array and
+// a flat KL array through the LAYOUT, per contiguous run of indices like
+// copyBatchRange.
+template<class LAYOUT, class ICEDATA>
+static bool copyBatchRuns(CIndexSet & indexSet, ICEDATA & iceData, char * klData, ULONG klCount, size_t elementBytes, bool toKL)
+{
+  ULONG runIce = 0;
+  ULONG runKL = 0;
+  ULONG runLength = 0;
+  for(CIndexSet::Iterator it = indexSet.Begin(); it.HasNext(); it.Next())
   {
-    klBrackets = klBrackets.substr(klBracketPos+1, klBrackets.length());
-    klBracketPos = klBrackets.find('[');
-    klArrayDimensions++;
+    ULONG iceIndex = it;
+    ULONG klIndex = it.GetAbsoluteIndex();
+    if(klIndex >= klCount)
+      return false;
+    if(runLength > 0 && iceIndex == runIce + runLength && klIndex == runKL + runLength)
+    {
+      runLength++;
+      continue;
+    }
+    if(runLength > 0)
+      copyLayoutRun<LAYOUT>(iceData, runIce, klData + runKL * elementBytes, runLength, elementBytes, toKL);
+    runIce = iceIndex;
+    runKL = klIndex;
+    runLength = 1;
   }
+  if(runLength > 0)
+    copyLayoutRun<LAYOUT>(iceData, runIce, klData + runKL * elementBytes, runLength, elementBytes, toKL);
+  return true;
+}
 
-  try
+// layouts used to copy values between KL arrays and ICE data arrays: copy()
+// reads KL values into ICE, copyToKL() writes ICE values into KL. types sharing
+// their memory layout between KL and ICE are copied as a block, the others go
+// through the conversion kernels (see FabricSpliceConversionKernels.h).
+struct klDirectLayout
+{
+  template<class OUT> static void copy(OUT & out, ULONG outIndex, const char * src, ULONG count, size_t elementBytes)
+  {
+    memcpy(&out[outIndex], src, count * elementBytes);
+  }
+  template<class IN> static void copyToKL(char * dst, IN & in, ULONG inIndex, ULONG count, size_t elementBytes)
+  {
+    memcpy(dst, &in[inIndex], count * elementBytes);
+  }
+  template<class ICEDATA> static bool copyBatch(CIndexSet & indexSet, ICEDATA & iceData, char * klData, ULONG klCount, size_t elementBytes, bool toKL)
+  {
+    return copyBatchRange(indexSet, (char*)&iceData[0], klData, klCount, elementBytes, toKL);
+  }
+};
+
+struct klQuatLayout
+{
+  template<class ICEDATA> static bool copyBatch(CIndexSet & indexSet, ICEDATA & iceData, char * klData, ULONG klCount, size_t elementBytes, bool toKL)
+  {
+    return copyBatchRuns<klQuatLayout>(indexSet, iceData, klData, klCount, elementBytes, toKL);
+  }
+  template<class OUT> static void copy(OUT & out, ULONG outIndex, const char * src, ULONG count, size_t elementBytes)
   {
-    void * data = NULL;
-    if(klArrayDimensions < 2)
+    convertKLQuaternionsToICE((const float*)src, &out[outIndex], count);
+  }
+  template<class IN> static void copyToKL(char * dst, IN & in, ULONG inIndex, ULONG count, size_t elementBytes)
+  {
+    convertICEQuaternionsToKL(&in[inIndex], (float*)dst, count);
+  }
+};
+
+struct klMat33Layout
+{
+  template<class ICEDATA> static bool copyBatch(CIndexSet & indexSet, ICEDATA & iceData, char * klData, ULONG klCount, size_t elementBytes, bool toKL)
+  {
+    return copyBatchRuns<klMat33Layout>(indexSet, iceData, klData, klCount, elementBytes, toKL);
+  }
+  template<class OUT> static void copy(OUT & out, ULONG outIndex, const char * src, ULONG count, size_t elementBytes)
+  {
+    convertKLMatrices33ToICE((const float*)src, &out[outIndex], count);
+  }
+  template<class IN> static void copyToKL(char * dst, IN & in, ULONG inIndex, ULONG count, size_t elementBytes)
+  {
+    convertICEMatrices33ToKL(&in[inIndex], (float*)dst, count);
+  }
+};
+
+struct klMat44Layout
+{
+  template<class ICEDATA> static bool copyBatch(CIndexSet & indexSet, ICEDATA & iceData, char * klData, ULONG klCount, size_t elementBytes, bool toKL)
+  {
+    return copyBatchRuns<klMat44Layout>(indexSet, iceData, klData, klCount, elementBytes, toKL);
+  }
+  template<class OUT> static void copy(OUT & out, ULONG outIndex, const char * src, ULONG count, size_t elementBytes)
+  {
+    convertKLMatricesToICE((const float*)src, &out[outIndex], count);
+  }
+  template<class IN> static void copyToKL(char * dst, IN & in, ULONG inIndex, ULONG count, size_t elementBytes)
+  {
+    convertICEMatricesToKL(&in[inIndex], (float*)dst, count);
+  }
+};
+
+// ICE stores booleans as bits.
+struct klBoolLayout
+{
+  template<class ICEDATA> static bool copyBatch(CIndexSet & indexSet, ICEDATA & iceData, char * klData, ULONG klCount, size_t elementBytes, bool toKL)
+  {
+    return copyBatchRuns<klBoolLayout>(indexSet, iceData, klData, klCount, elementBytes, toKL);
+  }
+  template<class OUT> static void copy(OUT & out, ULONG outIndex, const char * src, ULONG count, size_t elementBytes)
+  {
+    for(ULONG i=0;i<count;i++)
+      out.Set(outIndex+i, src[i] != 0);
+  }
+  template<class IN> static void copyToKL(char * dst, IN & in, ULONG inIndex, ULONG count, size_t elementBytes)
+  {
+    for(ULONG i=0;i<count;i++)
+      dst[i] = in[inIndex+i] ? 1 : 0;
+  }
+};
+
+template<class ARRAY, class ARRAY2D, class LAYOUT>
+static CStatus spliceGetData_EvaluateBatch(ICENodeContext& in_ctxt, iceNodeUD * ud, XSI::siICENodeStructureType dataStruct, XSI::siICENodeContextType dataContext, size_t elementBytes, const CString & reference)
+{
+  if(dataContext == siICENodeContextSingleton)
+  {
+    if(dataStruct == siICENodeStructureSingle)
     {
-      FabricCore::RTVal dataRtVal = rtVal.callMethod("Data", "data", 0, 0);
-      data = dataRtVal.getData();
+      ARRAY inData(in_ctxt, spliceGetData_ID_IN_element);
+      ARRAY outData(in_ctxt);
+      if(ud->data == NULL)
+        return CStatus::OK;
+      LAYOUT::copy(outData, 0, (const char*)ud->data, 1, elementBytes);
     }
-
-    if(dataType == siICENodeDataLong)
+    else if(dataStruct == siICENodeStructureArray)
     {
-      if(dataContext == siICENodeContextSingleton)
-      {
-        if(dataStruct == siICENodeStructureSingle)
-        {
-          CDataArrayLong inData(in_ctxt, spliceGetData_ID_IN_element);
-          CDataArrayLong outData(in_ctxt);
-          outData[0] = ((int32_t*)data)[0];
-        }
-        else if(dataStruct == siICENodeStructureArray)
-        {
-          CDataArray2DLong inData(in_ctxt, spliceGetData_ID_IN_element);
-          CDataArray2DLong outData2D(in_ctxt);
-          if(in_ctxt.GetNumberOfElementsToProcess() != rtVal.getArraySize())
-          {
-            Application().LogMessage(CString("spliceGetData") + "'s reference " + reference + " contains " + CString((LONG)rtVal.getArraySize()) + " values, ICE expects " + CString((LONG)in_ctxt.GetNumberOfElementsToProcess()) + " values.", siErrorMsg );
-            return CStatus::OK;
-          }
-          CDataArray2DLong::Accessor outData = outData2D.Resize(0, rtVal.getArraySize());
-          memcpy(&outData[0], data, sizeof(int32_t) * outData.GetCount());
-        }
-      }
-      else
-      {
-        if(dataStruct == siICENodeStructureSingle)
-        {
-          CDataArrayLong inData(in_ctxt, spliceGetData_ID_IN_element);
-          CDataArrayLong outData(in_ctxt);
-          if(in_ctxt.GetNumberOfElementsToProcess() != rtVal.getArraySize())
-          {
-            Application().LogMessage(CString("spliceGetData") + "'s reference " + reference + " contains " + CString((LONG)rtVal.getArraySize()) + " values, ICE expects " + CString((LONG)in_ctxt.GetNumberOfElementsToProcess()) + " values.", siErrorMsg );
-            return CStatus::OK;
-          }
-          memcpy(&outData[0], data, sizeof(int32_t) * in_ctxt.GetNumberOfElementsToProcess());
-        }
-        else if(dataStruct == siICENodeStructureArray)
-        {
-          CDataArray2DLong inData(in_ctxt, spliceGetData_ID_IN_element);
-          CDataArray2DLong outData2D(in_ctxt);
-          if(in_ctxt.GetNumberOfElementsToProcess() != rtVal.getArraySize())
-          {
-            Application().LogMessage(CString("spliceGetData") + "'s reference " + reference + " contains " + CString((LONG)rtVal.getArraySize()) + " values, ICE expects " + CString((LONG)in_ctxt.GetNumberOfElementsToProcess()) + " values.", siErrorMsg );
-            return CStatus::OK;
-          }
-          for(unsigned int i=0;i<outData2D.GetCount();i++)
-          {
-            FabricCore::RTVal subRtVal = rtVal.getArrayElement(i);
-            FabricCore::RTVal subDataRtVal = subRtVal.callMethod("Data", "data", 0, 0);
-            void * subData = subDataRtVal.getData();
-            CDataArray2DLong::Accessor outData = outData2D.Resize(i, subRtVal.getArraySize());
-            memcpy(&outData[0], subData, sizeof(int32_t) * outData.GetCount());
-          }
-        }
-      }
+      ARRAY2D inData(in_ctxt, spliceGetData_ID_IN_element);
+      ARRAY2D outData2D(in_ctxt);
+      typename ARRAY2D::Accessor outData = outData2D.Resize(0, ud->arraySize);
+      if(outData.GetCount() > 0)
+        LAYOUT::copy(outData, 0, (const char*)ud->data, outData.GetCount(), elementBytes);
     }
-    else if(dataType == siICENodeDataFloat)
+    return CStatus::OK;
+  }
+
+  CIndexSet indexSet(in_ctxt);
+  if(dataStruct == siICENodeStructureSingle)
+  {
+    ARRAY inData(in_ctxt, spliceGetData_ID_IN_element);
+    ARRAY outData(in_ctxt);
+    if(in_ctxt.GetNumberOfElementsToProcess() == 0)
+      return CStatus::OK;
+    if(!LAYOUT::copyBatch(indexSet, outData, (char*)ud->data, ud->arraySize, elementBytes, false))
     {
-      if(dataContext == siICENodeContextSingleton)
-      {
-        if(dataStruct == siICENodeStructureSingle)
-        {
-          CDataArrayFloat inData(in_ctxt, spliceGetData_ID_IN_element);
-          CDataArrayFloat outData(in_ctxt);
-          outData[0] = ((float*)data)[0];
-        }
-        else if(dataStruct == siICENodeStructureArray)
-        {
-          CDataArray2DFloat inData(in_ctxt, spliceGetData_ID_IN_element);
-          CDataArray2DFloat outData2D(in_ctxt);
-          if(in_ctxt.GetNumberOfElementsToProcess() != rtVal.getArraySize())
-          {
-            Application().LogMessage(CString("spliceGetData") + "'s reference " + reference + " contains " + CString((LONG)rtVal.getArraySize()) + " values, ICE expects " + CString((LONG)in_ctxt.GetNumberOfElementsToProcess()) + " values.", siErrorMsg );
-            return CStatus::OK;
-          }
-          CDataArray2DFloat::Accessor outData = outData2D.Resize(0, rtVal.getArraySize());
-          memcpy(&outData[0], data, sizeof(float) * in_ctxt.GetNumberOfElementsToProcess());
-        }
-      }
-      else
-      {
-        if(dataStruct == siICENodeStructureSingle)
-        {
-          CDataArrayFloat inData(in_ctxt, spliceGetData_ID_IN_element);
-          CDataArrayFloat outData(in_ctxt);
-          if(in_ctxt.GetNumberOfElementsToProcess() != rtVal.getArraySize())
-          {
-            Application().LogMessage(CString("spliceGetData") + "'s reference " + reference + " contains " + CString((LONG)rtVal.getArraySize()) + " values, ICE expects " + CString((LONG)in_ctxt.GetNumberOfElementsToProcess()) + " values.", siErrorMsg );
-            return CStatus::OK;
-          }
-          memcpy(&outData[0], data, sizeof(float) * in_ctxt.GetNumberOfElementsToProcess());
-        }
-        else if(dataStruct == siICENodeStructureArray)
-        {
-          CDataArray2DFloat inData(in_ctxt, spliceGetData_ID_IN_element);
-          CDataArray2DFloat outData2D(in_ctxt);
-          if(in_ctxt.GetNumberOfElementsToProcess() != rtVal.getArraySize())
-          {
-            Application().LogMessage(CString("spliceGetData") + "'s reference " + reference + " contains " + CString((LONG)rtVal.getArraySize()) + " values, ICE expects " + CString((LONG)in_ctxt.GetNumberOfElementsToProcess()) + " values.", siErrorMsg );
-            return CStatus::OK;
-          }
-          for(unsigned int i=0;i<outData2D.GetCount();i++)
-          {
-            FabricCore::RTVal subRtVal = rtVal.getArrayElement(i);
-            FabricCore::RTVal subDataRtVal = subRtVal.callMethod("Data", "data", 0, 0);
-            void * subData = subDataRtVal.getData();
-            CDataArray2DFloat::Accessor outData = outData2D.Resize(i, subRtVal.getArraySize());
-            memcpy(&outData[0], subData, sizeof(float) * outData.GetCount());
-            
-          }
-        }
-      }
+      Application().LogMessage(CString("spliceGetData") + "'s reference " + reference + " contains " + CString((LONG)ud->arraySize) + " values, ICE expects more values.", siErrorMsg );
+      return CStatus::OK;
     }
-    else if(dataType == siICENodeDataVector3)
+  }
+  else if(dataStruct == siICENodeStructureArray)
+  {
+    ARRAY2D inData(in_ctxt, spliceGetData_ID_IN_element);
+    ARRAY2D outData2D(in_ctxt);
+    for(CIndexSet::Iterator it = indexSet.Begin(); it.HasNext(); it.Next())
     {
-      if(dataContext == siICENodeContextSingleton)
+      ULONG absIndex = it.GetAbsoluteIndex();
+      if(absIndex >= ud->arraySize)
       {
-        if(dataStruct == siICENodeStructureSingle)
-        {
-          CDataArrayVector3f inData(in_ctxt, spliceGetData_ID_IN_element);
-          CDataArrayVector3f outData(in_ctxt);
-          outData[0].PutX(((float*)data)[0]);
-          outData[0].PutY(((float*)data)[1]);
-          outData[0].PutZ(((float*)data)[2]);
-        }
-        else if(dataStruct == siICENodeStructureArray)
-        {
-          CDataArray2DVector3f inData(in_ctxt, spliceGetData_ID_IN_element);
-          CDataArray2DVector3f outData2D(in_ctxt);
-          if(in_ctxt.GetNumberOfElementsToProcess() != rtVal.getArraySize())
-          {
-            Application().LogMessage(CString("spliceGetData") + "'s reference " + reference + " contains " + CString((LONG)rtVal.getArraySize()) + " values, ICE expects " + CString((LONG)in_ctxt.GetNumberOfElementsToProcess()) + " values.", siErrorMsg );
-            return CStatus::OK;
-          }
-          CDataArray2DVector3f::Accessor outData = outData2D.Resize(0, rtVal.getArraySize());
-          memcpy(&outData[0], data, sizeof(float) * 3 * outData.GetCount());
-        }
-      }
-      else
-      {
-        if(dataStruct == siICENodeStructureSingle)
-        {
-          CDataArrayVector3f inData(in_ctxt, spliceGetData_ID_IN_element);
-          CDataArrayVector3f outData(in_ctxt);
-
-          if(in_ctxt.GetNumberOfElementsToProcess() != rtVal.getArraySize())
-          {
-            Application().LogMessage(CString("spliceGetData") + "'s reference " + reference + " contains " + CString((LONG)rtVal.getArraySize()) + " values, ICE expects " + CString((LONG)in_ctxt.GetNumberOfElementsToProcess()) + " values.", siErrorMsg );
-            return CStatus::OK;
-          }
-          memcpy(&outData[0], data, sizeof(float) * 3 * in_ctxt.GetNumberOfElementsToProcess());
-        }
-        else if(dataStruct == siICENodeStructureArray)
-        {
-          CDataArray2DVector3f inData(in_ctxt, spliceGetData_ID_IN_element);
-          CDataArray2DVector3f outData2D(in_ctxt);
-          if(in_ctxt.GetNumberOfElementsToProcess() != rtVal.getArraySize())
-          {
-            Application().LogMessage(CString("spliceGetData") + "'s reference " + reference + " contains " + CString((LONG)rtVal.getArraySize()) + " values, ICE expects " + CString((LONG)in_ctxt.GetNumberOfElementsToProcess()) + " values.", siErrorMsg );
-            return CStatus::OK;
-          }
-          for(unsigned int i=0;i<outData2D.GetCount();i++)
-          {
-            FabricCore::RTVal subRtVal = rtVal.getArrayElement(i);
-            FabricCore::RTVal subDataRtVal = subRtVal.callMethod("Data", "data", 0, 0);
-            void * subData = subDataRtVal.getData();
-            CDataArray2DVector3f::Accessor outData = outData2D.Resize(i, subRtVal.getArraySize());
-            memcpy(&outData[0], subData, sizeof(float) * 3 * outData.GetCount());
-            
-          }
-        }
+        Application().LogMessage(CString("spliceGetData") + "'s reference " + reference + " contains " + CString((LONG)ud->arraySize) + " values, ICE expects more values.", siErrorMsg );
+        return CStatus::OK;
       }
-    }
-    else if(dataType == siICENodeDataColor4)
-    {
-      if(dataContext == siICENodeContextSingleton)
+      const char * src = NULL;
+      ULONG count = 0;
+      if(ud->offsets != NULL)
       {
-        if(dataStruct == siICENodeStructureSingle)
-        {
-          CDataArrayColor4f inData(in_ctxt, spliceGetData_ID_IN_element);
-          CDataArrayColor4f outData(in_ctxt);
-          outData[0].PutR(((float*)data)[0]);
-          outData[0].PutG(((float*)data)[1]);
-          outData[0].PutB(((float*)data)[2]);
-          outData[0].PutA(((float*)data)[2]);
-        }
-        else if(dataStruct == siICENodeStructureArray)
+        ULONG begin = (ULONG)ud->offsets[absIndex];
+        ULONG end = (ULONG)ud->offsets[absIndex+1];
+        if(end < begin || end > ud->valueCount)
         {
-          CDataArray2DColor4f inData(in_ctxt, spliceGetData_ID_IN_element);
-          CDataArray2DColor4f outData2D(in_ctxt);
-          if(in_ctxt.GetNumberOfElementsToProcess() != rtVal.getArraySize())
-          {
-            Application().LogMessage(CString("spliceGetData") + "'s reference " + reference + " contains " + CString((LONG)rtVal.getArraySize()) + " values, ICE expects " + CString((LONG)in_ctxt.GetNumberOfElementsToProcess()) + " values.", siErrorMsg );
-            return CStatus::OK;
-          }
-          CDataArray2DColor4f::Accessor outData = outData2D.Resize(0, rtVal.getArraySize());
-          memcpy(&outData[0], data, sizeof(float) * 4 * outData.GetCount());
+          Application().LogMessage(CString("spliceGetData") + "'s reference " + reference + " uses offsets outside of its " + CString((LONG)ud->valueCount) + " values.", siErrorMsg );
+          return CStatus::OK;
         }
+        src = (const char*)ud->data + begin * elementBytes;
+        count = end - begin;
       }
       else
       {
-        if(dataStruct == siICENodeStructureSingle)
-        {
-          CDataArrayColor4f inData(in_ctxt, spliceGetData_ID_IN_element);
-          CDataArrayColor4f outData(in_ctxt);
-          if(in_ctxt.GetNumberOfElementsToProcess() != rtVal.getArraySize())
-          {
-            Application().LogMessage(CString("spliceGetData") + "'s reference " + reference + " contains " + CString((LONG)rtVal.getArraySize()) + " values, ICE expects " + CString((LONG)in_ctxt.GetNumberOfElementsToProcess()) + " values.", siErrorMsg );
-            return CStatus::OK;
-          }
-          memcpy(&outData[0], data, sizeof(float) * 4 * in_ctxt.GetNumberOfElementsToProcess());
-        }
-        else if(dataStruct == siICENodeStructureArray)
-        {
-          CDataArray2DColor4f inData(in_ctxt, spliceGetData_ID_IN_element);
-          CDataArray2DColor4f outData2D(in_ctxt);
-          if(in_ctxt.GetNumberOfElementsToProcess() != rtVal.getArraySize())
-          {
-            Application().LogMessage(CString("spliceGetData") + "'s reference " + reference + " contains " + CString((LONG)rtVal.getArraySize()) + " values, ICE expects " + CString((LONG)in_ctxt.GetNumberOfElementsToProcess()) + " values.", siErrorMsg );
-            return CStatus::OK;
-          }
-          for(unsigned int i=0;i<outData2D.GetCount();i++)
-          {
-            FabricCore::RTVal subRtVal = rtVal.getArrayElement(i);
-            FabricCore::RTVal subDataRtVal = subRtVal.callMethod("Data", "data", 0, 0);
-            void * subData = subDataRtVal.getData();
-            CDataArray2DColor4f::Accessor outData = outData2D.Resize(i, subRtVal.getArraySize());
-            memcpy(&outData[0], subData, sizeof(float) * 4 * outData.GetCount());
-            
-          }
-        }
+        src = (const char*)ud->subArrayData[absIndex];
+        count = ud->subArraySizes[absIndex];
       }
+      typename ARRAY2D::Accessor outData = outData2D.Resize(it, count);
+      if(outData.GetCount() > 0)
+        LAYOUT::copy(outData, 0, src, outData.GetCount(), elementBytes);
     }
   }
-  catch(FabricCore::Exception e)
-  {
-    Application().LogMessage(CString("spliceGetData") + " hit exception: " + e.getDesc_cstr(), siErrorMsg );
-    return CStatus::OK;
-  }
-  catch(FabricSplice::Exception e)
-  {
-    Application().LogMessage(CString("spliceGetData") + " hit exception: " + e.what(), siErrorMsg );
+  return CStatus::OK;
+}
+
+SICALLBACK spliceGetData_Evaluate(ICENodeContext& in_ctxt)
+{
+  XSI::siICENodeDataType dataType;
+  XSI::siICENodeStructureType dataStruct;
+  XSI::siICENodeContextType dataContext;
+  in_ctxt.GetPortInfo( spliceGetData_ID_OUT_Result, dataType, dataStruct, dataContext );
+
+  CDataArrayString referenceArray(in_ctxt, spliceGetData_ID_IN_reference);
+  CString reference = referenceArray[0];
+
+  // this runs per batch on ICE's worker threads: only the pointers resolved
+  // in spliceGetData_BeginEvaluate are used here, no calls into the core.
+  CValue udVal = in_ctxt.GetUserData();
+  iceNodeUD * ud = (iceNodeUD*)(CValue::siPtrType)udVal;
+  if(!ud->interf || !ud->valid)
     return CStatus::OK;
-  }
+
+  if(dataType == siICENodeDataLong)
+    return spliceGetData_EvaluateBatch<CDataArrayLong, CDataArray2DLong, klDirectLayout>(in_ctxt, ud, dataStruct, dataContext, sizeof(int32_t), reference);
+  else if(dataType == siICENodeDataFloat)
+    return spliceGetData_EvaluateBatch<CDataArrayFloat, CDataArray2DFloat, klDirectLayout>(in_ctxt, ud, dataStruct, dataContext, sizeof(float), reference);
+  else if(dataType == siICENodeDataVector2)
+    return spliceGetData_EvaluateBatch<CDataArrayVector2f, CDataArray2DVector2f, klDirectLayout>(in_ctxt, ud, dataStruct, dataContext, sizeof(float) * 2, reference);
+  else if(dataType == siICENodeDataVector3)
+    return spliceGetData_EvaluateBatch<CDataArrayVector3f, CDataArray2DVector3f, klDirectLayout>(in_ctxt, ud, dataStruct, dataContext, sizeof(float) * 3, reference);
+  else if(dataType == siICENodeDataColor4)
+    return spliceGetData_EvaluateBatch<CDataArrayColor4f, CDataArray2DColor4f, klDirectLayout>(in_ctxt, ud, dataStruct, dataContext, sizeof(float) * 4, reference);
+  else if(dataType == siICENodeDataQuaternion)
+    return spliceGetData_EvaluateBatch<CDataArrayQuaternionf, CDataArray2DQuaternionf, klQuatLayout>(in_ctxt, ud, dataStruct, dataContext, sizeof(float) * 4, reference);
+  else if(dataType == siICENodeDataMatrix33)
+    return spliceGetData_EvaluateBatch<CDataArrayMatrix3f, CDataArray2DMatrix3f, klMat33Layout>(in_ctxt, ud, dataStruct, dataContext, sizeof(float) * 9, reference);
+  else if(dataType == siICENodeDataMatrix44)
+    return spliceGetData_EvaluateBatch<CDataArrayMatrix4f, CDataArray2DMatrix4f, klMat44Layout>(in_ctxt, ud, dataStruct, dataContext, sizeof(float) * 16, reference);
+  else if(dataType == siICENodeDataBool)
+    return spliceGetData_EvaluateBatch<CDataArrayBool, CDataArray2DBool, klBoolLayout>(in_ctxt, ud, dataStruct, dataContext, sizeof(bool), reference);
 
   return CStatus::OK;
 }
@@ -626,6 +833,299 @@ SICALLBACK spliceGetData_Term( CRef & in_ctxt )
   return CStatus::OK;
 }
 
+CStatus Register_spliceSetData( PluginRegistrar& in_reg )
+{
+  CStatus st;
+
+  ICENodeDef nodeDef;
+  PluginItem nodeItem;
+
+  int supportedDataTypes = 
+    siICENodeDataBool |
+    siICENodeDataLong |
+    siICENodeDataFloat |
+    siICENodeDataVector2 |
+    siICENodeDataVector3 |
+    siICENodeDataColor4 |
+    siICENodeDataQuaternion |
+    siICENodeDataMatrix33 |
+    siICENodeDataMatrix44;
+
+  nodeDef = Application().GetFactory().CreateICENodeDef(L"spliceSetData",L"spliceSetData");
+
+  st = nodeDef.PutColor(39,168,223);
+  st.AssertSucceeded( ) ;
+
+  st = nodeDef.PutThreadingModel(siICENodeMultiThreading);
+  st.AssertSucceeded( ) ;
+
+  // Add input ports and groups.
+  st = nodeDef.AddPortGroup(spliceSetData_ID_G_100);
+  st.AssertSucceeded( ) ;
+  st = nodeDef.AddInputPort(spliceSetData_ID_IN_reference, spliceSetData_ID_G_100, siICENodeDataString, siICENodeStructureSingle, siICENodeContextSingleton, L"reference", L"reference", L"", CString(), CString(), spliceSetData_ID_UNDEF, spliceSetData_ID_UNDEF, spliceSetData_ID_UNDEF);
+  st.AssertSucceeded( ) ;
+  st = nodeDef.AddInputPort(spliceSetData_ID_IN_klType, spliceSetData_ID_G_100, siICENodeDataString, siICENodeStructureSingle, siICENodeContextSingleton, L"klType", L"klType", L"", CString(), CString(), spliceSetData_ID_UNDEF, spliceSetData_ID_UNDEF, spliceSetData_ID_UNDEF);
+  st.AssertSucceeded( ) ;
+  st = nodeDef.AddInputPort(spliceSetData_ID_IN_value, spliceSetData_ID_G_100, supportedDataTypes, siICENodeStructureAny, siICENodeContextAny, L"value", L"value", L"", CValue(), CValue(), spliceSetData_ID_TYPE_CNS, spliceSetData_ID_STRUCT_CNS, spliceSetData_ID_CTXT_CNS);
+  st.AssertSucceeded( ) ;
+  st = nodeDef.AddOutputPort(spliceSetData_ID_OUT_execute, siICENodeDataExecute, siICENodeStructureSingle, siICENodeContextAny, L"execute", L"execute", spliceSetData_ID_UNDEF, spliceSetData_ID_UNDEF, spliceSetData_ID_CTXT_CNS);
+  st.AssertSucceeded( ) ;
+
+  nodeItem = in_reg.RegisterICENode(nodeDef);
+  nodeItem.PutCategories(L"Fabric Engine");
+
+  return CStatus::OK;
+}
+
+// copies a singleton value, it is read in spliceSetData_BeginEvaluate since
+// sizing the KL array calls into the core, which Evaluate can't do.
+template<class ARRAY, class ARRAY2D, class LAYOUT>
+static void spliceSetData_CopySingleton(ICENodeContext& in_ctxt, iceNodeUD * ud, XSI::siICENodeStructureType dataStruct, size_t elementBytes)
+{
+  if(dataStruct == siICENodeStructureSingle)
+  {
+    ARRAY inData(in_ctxt, spliceSetData_ID_IN_value);
+    if(ud->data != NULL)
+      LAYOUT::copyToKL((char*)ud->data, inData, 0, 1, elementBytes);
+  }
+  else if(dataStruct == siICENodeStructureArray)
+  {
+    ARRAY2D inData2D(in_ctxt, spliceSetData_ID_IN_value);
+    typename ARRAY2D::Accessor inData = inData2D[0];
+    ud->memberVal.setArraySize(inData.GetCount());
+    ud->arraySize = inData.GetCount();
+    if(inData.GetCount() > 0)
+    {
+      ud->data = ud->memberVal.callMethod("Data", "data", 0, 0).getData();
+      LAYOUT::copyToKL((char*)ud->data, inData, 0, inData.GetCount(), elementBytes);
+    }
+  }
+}
+
+SICALLBACK spliceSetData_BeginEvaluate(ICENodeContext& in_ctxt)
+{
+  XSI::siICENodeDataType dataType;
+  XSI::siICENodeStructureType dataStruct;
+  XSI::siICENodeContextType dataContext;
+  in_ctxt.GetPortInfo( spliceSetData_ID_IN_value, dataType, dataStruct, dataContext );
+
+  CDataArrayString referenceArray(in_ctxt, spliceSetData_ID_IN_reference);
+  CString reference = referenceArray[0];
+  CDataArrayString klTypeArray(in_ctxt, spliceSetData_ID_IN_klType);
+  CString klType = klTypeArray[0];
+
+  CValue udVal = in_ctxt.GetUserData();
+  iceNodeUD * ud = (iceNodeUD*)(CValue::siPtrType)udVal;
+  FabricSpliceBaseInterface * interf = FabricSpliceBaseInterface::getInstanceByObjectID(ud->objectID);
+  ud->interf = interf;
+  resetICENodeUD(ud);
+  if(!interf)
+    return CStatus::OK;
+
+  try
+  {
+    bool resolved = false;
+    if(!updateSingletonMemberCache("spliceSetData", ud, reference, klType, dataType, dataStruct, dataContext, false, resolved))
+      return CStatus::OK;
+    if(!resolved && !resolveSingletonMember("spliceSetData", reference, klType, ud))
+      return CStatus::OK;
+
+    FabricCore::RTVal memberVal = ud->memberVal;
+    int klArrayDimensions = ud->klArrayDimensions;
+
+    if(klArrayDimensions == 0 && (dataContext != siICENodeContextSingleton || dataStruct != siICENodeStructureSingle))
+    {
+      Application().LogMessage(CString("spliceSetData") + "'s reference " + reference + " refers to a single value, but the connected ICE port is not a singleton of single value.", siErrorMsg );
+      return CStatus::OK;
+    }
+    if(klArrayDimensions > 1)
+    {
+      Application().LogMessage(CString("spliceSetData") + "'s reference " + reference + " refers to a " + CString((LONG)klArrayDimensions) + " dimensional array, but only flat arrays can be written.", siErrorMsg );
+      return CStatus::OK;
+    }
+
+    if(klArrayDimensions == 0)
+    {
+      ud->data = memberVal.getData();
+    }
+    else if(dataContext != siICENodeContextSingleton)
+    {
+      // size the KL array to the whole element set before ICE splits the work
+      // into batches, each of them then only writes its own range.
+      ULONG count = in_ctxt.GetNumberOfElementsToProcess();
+      if(memberVal.getArraySize() != count)
+        memberVal.setArraySize(count);
+      ud->arraySize = count;
+      if(count > 0)
+        ud->data = memberVal.callMethod("Data", "data", 0, 0).getData();
+    }
+
+    ud->memberVal = memberVal;
+
+    if(dataContext == siICENodeContextSingleton)
+    {
+      if(dataType == siICENodeDataLong)
+        spliceSetData_CopySingleton<CDataArrayLong, CDataArray2DLong, klDirectLayout>(in_ctxt, ud, dataStruct, sizeof(int32_t));
+      else if(dataType == siICENodeDataFloat)
+        spliceSetData_CopySingleton<CDataArrayFloat, CDataArray2DFloat, klDirectLayout>(in_ctxt, ud, dataStruct, sizeof(float));
+      else if(dataType == siICENodeDataVector2)
+        spliceSetData_CopySingleton<CDataArrayVector2f, CDataArray2DVector2f, klDirectLayout>(in_ctxt, ud, dataStruct, sizeof(float) * 2);
+      else if(dataType == siICENodeDataVector3)
+        spliceSetData_CopySingleton<CDataArrayVector3f, CDataArray2DVector3f, klDirectLayout>(in_ctxt, ud, dataStruct, sizeof(float) * 3);
+      else if(dataType == siICENodeDataColor4)
+        spliceSetData_CopySingleton<CDataArrayColor4f, CDataArray2DColor4f, klDirectLayout>(in_ctxt, ud, dataStruct, sizeof(float) * 4);
+      else if(dataType == siICENodeDataQuaternion)
+        spliceSetData_CopySingleton<CDataArrayQuaternionf, CDataArray2DQuaternionf, klQuatLayout>(in_ctxt, ud, dataStruct, sizeof(float) * 4);
+      else if(dataType == siICENodeDataMatrix33)
+        spliceSetData_CopySingleton<CDataArrayMatrix3f, CDataArray2DMatrix3f, klMat33Layout>(in_ctxt, ud, dataStruct, sizeof(float) * 9);
+      else if(dataType == siICENodeDataMatrix44)
+        spliceSetData_CopySingleton<CDataArrayMatrix4f, CDataArray2DMatrix4f, klMat44Layout>(in_ctxt, ud, dataStruct, sizeof(float) * 16);
+      else if(dataType == siICENodeDataBool)
+        spliceSetData_CopySingleton<CDataArrayBool, CDataArray2DBool, klBoolLayout>(in_ctxt, ud, dataStruct, sizeof(bool));
+      else
+      {
+        Application().LogMessage(CString("spliceSetData") + "'s reference " + reference + " is connected to an ICE port of an unsupported data type.", siErrorMsg );
+        return CStatus::OK;
+      }
+    }
+
+    ud->valid = true;
+  }
+  catch(FabricCore::Exception e)
+  {
+    Application().LogMessage(CString("spliceSetData") + " hit exception: " + e.getDesc_cstr(), siErrorMsg );
+    return CStatus::OK;
+  }
+  catch(FabricSplice::Exception e)
+  {
+    Application().LogMessage(CString("spliceSetData") + " hit exception: " + e.what(), siErrorMsg );
+    return CStatus::OK;
+  }
+
+  return CStatus::OK;
+}
+
+template<class ARRAY, class LAYOUT>
+static CStatus spliceSetData_EvaluateBatch(ICENodeContext& in_ctxt, iceNodeUD * ud, XSI::siICENodeStructureType dataStruct, XSI::siICENodeContextType dataContext, size_t elementBytes, const CString & reference)
+{
+  // singletons are written in spliceSetData_BeginEvaluate.
+  if(dataContext == siICENodeContextSingleton)
+    return CStatus::OK;
+
+  if(dataStruct != siICENodeStructureSingle)
+  {
+    Application().LogMessage(CString("spliceSetData") + "'s reference " + reference + " is connected to a multi of array value, only a multi of single value can be written.", siErrorMsg );
+    return CStatus::OK;
+  }
+  if(ud->data == NULL)
+    return CStatus::OK;
+
+  ARRAY inData(in_ctxt, spliceSetData_ID_IN_value);
+  CIndexSet indexSet(in_ctxt);
+  if(inData.IsConstant())
+  {
+    for(CIndexSet::Iterator it = indexSet.Begin(); it.HasNext(); it.Next())
+    {
+      ULONG absIndex = it.GetAbsoluteIndex();
+      if(absIndex >= ud->arraySize)
+        break;
+      LAYOUT::copyToKL((char*)ud->data + absIndex * elementBytes, inData, 0, 1, elementBytes);
+    }
+  }
+  else if(!LAYOUT::copyBatch(indexSet, inData, (char*)ud->data, ud->arraySize, elementBytes, true))
+  {
+    Application().LogMessage(CString("spliceSetData") + "'s reference " + reference + " was sized to " + CString((LONG)ud->arraySize) + " values, ICE provides more values.", siErrorMsg );
+    return CStatus::OK;
+  }
+  return CStatus::OK;
+}
+
+SICALLBACK spliceSetData_Evaluate(ICENodeContext& in_ctxt)
+{
+  XSI::siICENodeDataType dataType;
+  XSI::siICENodeStructureType dataStruct;
+  XSI::siICENodeContextType dataContext;
+  in_ctxt.GetPortInfo( spliceSetData_ID_IN_value, dataType, dataStruct, dataContext );
+
+  CDataArrayString referenceArray(in_ctxt, spliceSetData_ID_IN_reference);
+  CString reference = referenceArray[0];
+
+  // this runs per batch on ICE's worker threads: the per element case only
+  // writes through the pointer resolved in spliceSetData_BeginEvaluate.
+  CValue udVal = in_ctxt.GetUserData();
+  iceNodeUD * ud = (iceNodeUD*)(CValue::siPtrType)udVal;
+  if(!ud->interf || !ud->valid)
+    return CStatus::OK;
+
+  try
+  {
+    if(dataType == siICENodeDataLong)
+      return spliceSetData_EvaluateBatch<CDataArrayLong, klDirectLayout>(in_ctxt, ud, dataStruct, dataContext, sizeof(int32_t), reference);
+    else if(dataType == siICENodeDataFloat)
+      return spliceSetData_EvaluateBatch<CDataArrayFloat, klDirectLayout>(in_ctxt, ud, dataStruct, dataContext, sizeof(float), reference);
+    else if(dataType == siICENodeDataVector2)
+      return spliceSetData_EvaluateBatch<CDataArrayVector2f, klDirectLayout>(in_ctxt, ud, dataStruct, dataContext, sizeof(float) * 2, reference);
+    else if(dataType == siICENodeDataVector3)
+      return spliceSetData_EvaluateBatch<CDataArrayVector3f, klDirectLayout>(in_ctxt, ud, dataStruct, dataContext, sizeof(float) * 3, reference);
+    else if(dataType == siICENodeDataColor4)
+      return spliceSetData_EvaluateBatch<CDataArrayColor4f, klDirectLayout>(in_ctxt, ud, dataStruct, dataContext, sizeof(float) * 4, reference);
+    else if(dataType == siICENodeDataQuaternion)
+      return spliceSetData_EvaluateBatch<CDataArrayQuaternionf, klQuatLayout>(in_ctxt, ud, dataStruct, dataContext, sizeof(float) * 4, reference);
+    else if(dataType == siICENodeDataMatrix33)
+      return spliceSetData_EvaluateBatch<CDataArrayMatrix3f, klMat33Layout>(in_ctxt, ud, dataStruct, dataContext, sizeof(float) * 9, reference);
+    else if(dataType == siICENodeDataMatrix44)
+      return spliceSetData_EvaluateBatch<CDataArrayMatrix4f, klMat44Layout>(in_ctxt, ud, dataStruct, dataContext, sizeof(float) * 16, reference);
+    else if(dataType == siICENodeDataBool)
+      return spliceSetData_EvaluateBatch<CDataArrayBool, klBoolLayout>(in_ctxt, ud, dataStruct, dataContext, sizeof(bool), reference);
+  }
+  catch(FabricCore::Exception e)
+  {
+    Application().LogMessage(CString("spliceSetData") + " hit exception: " + e.getDesc_cstr(), siErrorMsg );
+    return CStatus::OK;
+  }
+
+  return CStatus::OK;
+}
+
+SICALLBACK spliceSetData_EndEvaluate(ICENodeContext& in_ctxt)
+{
+  CValue udVal = in_ctxt.GetUserData();
+  iceNodeUD * ud = (iceNodeUD*)(CValue::siPtrType)udVal;
+  if(!ud->interf || !ud->valid)
+    return CStatus::OK;
+
+  // store the written member back along the reference path: the member of a
+  // struct is a copy, so every struct up to the first object owning it (or the
+  // singleton) is written back into its own owner as well.
+  try
+  {
+    ud->pathVals.back() = ud->memberVal;
+    for(size_t i=ud->pathVals.size()-1;i>0;i--)
+    {
+      FabricCore::RTVal & ownerVal = ud->pathVals[i-1];
+      ownerVal.setMember(ud->memberPath[i].c_str(), ud->pathVals[i]);
+      if(ownerVal.isObject())
+        break;
+    }
+  }
+  catch(FabricCore::Exception e)
+  {
+    Application().LogMessage(CString("spliceSetData") + " hit exception: " + e.getDesc_cstr(), siErrorMsg );
+  }
+
+  return CStatus::OK;
+}
+
+SICALLBACK spliceSetData_Init( CRef & in_ctxt )
+{
+  return spliceGetData_Init(in_ctxt);
+}
+
+SICALLBACK spliceSetData_Term( CRef & in_ctxt )
+{
+  return spliceGetData_Term(in_ctxt);
+}
+
 // SICALLBACK spliceGetDataPerPoint_BeginEvaluate(ICENodeContext& in_ctxt)
 // {
 //   return spliceGetDataSingle_BeginEvaluate(in_ctxt);
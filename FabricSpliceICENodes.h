@@ -3,11 +3,54 @@
 
 #include "FabricSpliceBaseInterface.h"
 
+#include <vector>
+#include <string>
+
 struct iceNodeUD {
   unsigned int objectID;
   FabricSpliceBaseInterface * interf;
+
+  // resolved in BeginEvaluate, read by the multi threaded Evaluate
+  bool valid;
+  void * data;
+  unsigned int arraySize;
+  std::vector<void*> subArrayData;
+  std::vector<unsigned int> subArraySizes;
+
+  // packed 2D layout: the member holds the values of all elements and its
+  // '<member>Offsets' sibling the start of each element (plus the end).
+  bool packed;
+  std::string offsetsName;
+  FabricCore::RTVal offsetsVal;
+  const int32_t * offsets;
+  unsigned int valueCount;
+
+  // the resolved member and its owner (written back by spliceSetData), as
+  // well as the values along the reference path, starting with the singleton.
+  // the path is kept across evaluations, it is walked again when the
+  // singleton object changes (see resolveSingletonMember)
+  FabricCore::RTVal parentVal;
+  FabricCore::RTVal memberVal;
+  std::string memberName;
+  std::vector<FabricCore::RTVal> pathVals;
+
+  // parsed reference and decoded member type, kept across evaluations
+  // until the reference, the klType or the ICE port type change
+  bool cacheValid;
+  XSI::CString cachedReference;
+  XSI::CString cachedKLType;
+  int cachedDataType;
+  int cachedDataStruct;
+  int cachedDataContext;
+  FabricCore::RTVal handleVal;
+  FabricCore::RTVal keyVal;
+  std::vector<std::string> memberPath;
+  std::string klDataType;
+  std::string klBaseDataType;
+  int klArrayDimensions;
 };
 
 extern XSI::CStatus Register_spliceGetData( XSI::PluginRegistrar &in_reg );
+extern XSI::CStatus Register_spliceSetData( XSI::PluginRegistrar &in_reg );
 
 #endif
@@ -17,11 +17,14 @@
 #include <xsi_utils.h>
 #include <xsi_customoperator.h>
 #include <xsi_operatorcontext.h>
+#include <xsi_time.h>
+#include <xsi_outputport.h>
 
 // project includes
 #include "FabricSplicePlugin.h"
 #include "FabricSpliceOperators.h"
 #include "FabricSpliceBaseInterface.h"
+#include "FabricProfiler.h"
 
 using namespace XSI;
 
@@ -60,6 +63,12 @@ XSIPLUGINCALLBACK CStatus SpliceOp_Define(CRef & in_ctxt)
   oCustomOperator.AddParameter(oPDef,oParam);
   oPDef = oFactory.CreateParamDef(L"alwaysConvertMeshes", CValue::siBool, siPersistable, L"alwaysConvertMeshes", L"alwaysConvertMeshes", false, CValue(), CValue(), CValue(), CValue());
   oCustomOperator.AddParameter(oPDef,oParam);
+  oPDef = oFactory.CreateParamDef(L"compileInBackground", CValue::siBool, siPersistable, L"compileInBackground", L"compileInBackground", false, CValue(), CValue(), CValue(), CValue());
+  oCustomOperator.AddParameter(oPDef,oParam);
+  oPDef = oFactory.CreateParamDef(L"transferPointsAsFloat32", CValue::siBool, siPersistable, L"transferPointsAsFloat32", L"transferPointsAsFloat32", false, CValue(), CValue(), CValue(), CValue());
+  oCustomOperator.AddParameter(oPDef,oParam);
+  oPDef = oFactory.CreateParamDef(L"releaseBuffersWhenIdle", CValue::siBool, siPersistable, L"releaseBuffersWhenIdle", L"releaseBuffersWhenIdle", false, CValue(), CValue(), CValue(), CValue());
+  oCustomOperator.AddParameter(oPDef,oParam);
 
   FabricSpliceBaseInterface::constructXSIParameters(oCustomOperator, oFactory);
 
@@ -93,12 +102,25 @@ XSIPLUGINCALLBACK CStatus SpliceOp_Update(CRef & in_ctxt)
     return CStatus::OK;
   }
 
+  double frame = FabricProfiler::isEnabled() ? ctxt.GetTime().GetTime(CTime::Frames) : 0.0;
+  FabricTraceScope traceScope("SpliceOp_Update", p->getObjectID(), frame);
+
   XSISPLICE_CATCH_BEGIN()
 
   FabricSpliceBaseInterface * interf = p->getInterf();
   CRef opRef = Application().GetObjectFromID(p->getObjectID());
   if(interf != NULL)
   {
+    // While the KL code is compiled in the background the graph is
+    // not touched, so the operator keeps its last outputs. The operator
+    // is evaluated again once the compilation is done.
+    if(interf->isCompiling())
+    {
+      if(interf->warnStaleOutputs())
+        Application().LogMessage(L"[Splice] "+CString(opRef.GetAsText())+L": outputs are not updated while the KL code is compiled in the background.", siWarningMsg);
+      return CStatus::OK;
+    }
+
     // When transfering the input values, we check for changes and only evaluate if
     // one of the inputs has actually changed. The Softimage application will evaluate
     // and operator multiple times if connected to multiple outputs(once for each connected outport).
@@ -106,8 +128,11 @@ XSIPLUGINCALLBACK CStatus SpliceOp_Update(CRef & in_ctxt)
     // driving many values in Softimage, the whole system slows to a crawl.
     if(interf->transferInputPorts(opRef, ctxt))
     {
+      FabricProfilerScope profilerScope(p->getObjectID(), frame, FabricProfiler::EventKind_Execute);
       interf->evaluate();
     }
+    else if(FabricProfiler::isEnabled())
+      FabricProfiler::recordSkipped(p->getObjectID(), frame);
     interf->transferOutputPort(ctxt);
   }
   else if(!xsiIsLoadingScene())
@@ -27,6 +27,9 @@
 
 #include <boost/filesystem.hpp>
 
+#include <QtCore/QThread>
+#include <QtCore/QMutex>
+
 #include <Licensing/Licensing.h>
 
 #include "FabricSplicePlugin.h"
@@ -44,8 +47,75 @@ using namespace XSI;
 // FabricDFG's helper function for the save scene events.
 CStatus helpFnct_siEventOpenSave(CRef &ctxt, int openSave);
 
+// messages logged from a background thread (for example while
+// compiling KL in the background) cannot be passed on to Softimage,
+// so they are queued and flushed by the FabricSpliceTimer event.
+struct deferredMessage
+{
+  enum Type { Type_Log, Type_Error, Type_KLReport, Type_Compiler };
+  Type type;
+  std::string message;
+  unsigned int row;
+  unsigned int col;
+  std::string file;
+  std::string level;
+};
+std::vector<deferredMessage> gDeferredMessages;
+QMutex gDeferredMessagesMutex;
+QThread * gMainThread = NULL;
+
+bool xsiIsMainThread()
+{
+  return gMainThread == NULL || QThread::currentThread() == gMainThread;
+}
+
+void xsiDeferMessage(deferredMessage::Type type, const char * message, unsigned int row = 0, unsigned int col = 0, const char * file = "", const char * level = "")
+{
+  deferredMessage msg;
+  msg.type = type;
+  msg.message = message ? message : "";
+  msg.row = row;
+  msg.col = col;
+  msg.file = file ? file : "";
+  msg.level = level ? level : "";
+
+  QMutexLocker lock(&gDeferredMessagesMutex);
+  gDeferredMessages.push_back(msg);
+}
+
+void xsiKLReportFunc(const char * message, unsigned int length);
+void xsiCompilerErrorFunc(unsigned int row, unsigned int col, const char * file, const char * level, const char * desc);
+
+void xsiFlushDeferredLogs()
+{
+  std::vector<deferredMessage> messages;
+  {
+    QMutexLocker lock(&gDeferredMessagesMutex);
+    if(gDeferredMessages.size() == 0)
+      return;
+    messages.swap(gDeferredMessages);
+  }
+
+  for(size_t i=0;i<messages.size();i++)
+  {
+    const deferredMessage & msg = messages[i];
+    switch(msg.type)
+    {
+      case deferredMessage::Type_Log:       xsiLogFunc(msg.message.c_str());  break;
+      case deferredMessage::Type_Error:     xsiLogErrorFunc(msg.message.c_str());  break;
+      case deferredMessage::Type_KLReport:  xsiKLReportFunc(msg.message.c_str(), msg.message.length());  break;
+      case deferredMessage::Type_Compiler:  xsiCompilerErrorFunc(msg.row, msg.col, msg.file.c_str(), msg.level.c_str(), msg.message.c_str());  break;
+    }
+  }
+}
+
 void xsiLogFunc(const char * message, unsigned int length)
 {
+  if(!xsiIsMainThread())
+  {
+    xsiDeferMessage(deferredMessage::Type_Log, message);
+    return;
+  }
   Application().LogMessage(CString("[Splice] ")+CString(message), siVerboseMsg);
 }
 
@@ -60,6 +130,12 @@ void xsiLogErrorFunc(const char * message, unsigned int length)
 {
   if(!gErrorEnabled)
     return;
+  if(!xsiIsMainThread())
+  {
+    FabricSpliceBaseInterface::reportCompileError();
+    xsiDeferMessage(deferredMessage::Type_Error, message);
+    return;
+  }
   Application().LogMessage(CString("[Splice] ")+CString(message), siErrorMsg);
   gErrorOccured = true;
 }
@@ -90,11 +166,24 @@ CStatus xsiErrorOccured()
 
 void xsiKLReportFunc(const char * message, unsigned int length)
 {
+  if(!xsiIsMainThread())
+  {
+    xsiDeferMessage(deferredMessage::Type_KLReport, message);
+    return;
+  }
   Application().LogMessage(CString("[KL]: ")+CString(message));
 }
 
 void xsiCompilerErrorFunc(unsigned int row, unsigned int col, const char * file, const char * level, const char * desc)
 {
+  if(!xsiIsMainThread())
+  {
+    if(CString(level) == CString("error"))
+      FabricSpliceBaseInterface::reportCompileError();
+    xsiDeferMessage(deferredMessage::Type_Compiler, desc, row, col, file, level);
+    return;
+  }
+
   CString line((LONG)row);
   if(CString(level) == CString("error"))
     Application().LogMessage("[KL Compiler "+CString(level)+"]: line "+line+", op '"+CString(file)+"': "+CString(desc), siErrorMsg);
@@ -180,6 +269,7 @@ void xsiInitializeSplice()
     return;
 
   gSpliceInitialized = true;
+  gMainThread = QThread::currentThread();
   FabricSplice::Initialize();
   FabricSplice::Logging::setLogFunc(xsiLogFunc);
   FabricSplice::Logging::setLogErrorFunc(xsiLogErrorFunc);
@@ -227,6 +317,20 @@ XSIPLUGINCALLBACK CStatus FabricSpliceTerminate_OnEvent(CRef & ctxt)
   return true;
 }
 
+XSIPLUGINCALLBACK CStatus FabricSpliceTimer_OnEvent(CRef & ctxt)
+{
+  // swap in the KL code of finished background compilations
+  // and pass on the messages logged by background threads.
+  FabricSpliceBaseInterface::processFinishedCompilations();
+  xsiFlushDeferredLogs();
+
+  // free the mesh staging buffers of operators not evaluated for a while.
+  FabricSpliceBaseInterface::releaseIdleStagingBuffers(10.0);
+
+  // the return value is ignored for timer events.
+  return CStatus::OK;
+}
+
 bool gIsOpeningScene = false;
 bool xsiIsLoadingScene()
 {
@@ -623,6 +727,7 @@ CString xsiGetKLKeyWords()
   result += " GeometryAttributes";
   result += " GeometryAttribute";
   result += " ScalarAttribute";
+  result += " IntegerAttribute";
   result += " Vec2Attribute";
   result += " Vec3Attribute";
   result += " Vec4Attribute";
@@ -19,5 +19,7 @@ void xsiInitializeSplice();
 XSI::CString xsiGetKLKeyWords();
 bool xsiIsLoadingScene();
 XSI::CString xsiGetLastLoadedScene();
+bool xsiIsMainThread();
+void xsiFlushDeferredLogs();
 
 #endif
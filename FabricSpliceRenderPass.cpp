@@ -28,6 +28,7 @@
 #include "FabricSpliceRenderPass.h"
 #include "FabricSpliceTools.h"
 #include "FabricSpliceBaseInterface.h"
+#include "FabricProfiler.h"
 
 #include "FabricDFGBaseInterface.h"
 
@@ -239,12 +240,18 @@ XSIPLUGINCALLBACK void SpliceRenderPass_Execute(CRef & in_ctxt, void ** in_pUser
   }
 
   FabricSplice::Logging::AutoTimer("SpliceRenderPass_Execute");
-  
+  FabricTraceScope traceScope("SpliceRenderPass_Execute");
+
   // check if we should render this or not
   GraphicSequencerContext ctxt(in_ctxt);
   CGraphicSequencer sequencer = ctxt.GetGraphicSequencer();
   Camera camera(sequencer.GetCamera());
 
+  // the gizmos live in the graphs, which can't be touched while
+  // KL code is compiled in the background.
+  if(FabricSpliceBaseInterface::isAnyCompiling())
+    return;
+
   // draw all gizmos
   try
   {
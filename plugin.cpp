@@ -10,6 +10,7 @@
 #include "FabricDFGPlugin.h"
 #include "FabricDFGOperators.h"
 #include "FabricDFGTools.h"
+#include "FabricDFGICENodes.h"
 
 #include "FabricSplicePlugin.h"
 #include "FabricSpliceICENodes.h"
@@ -105,9 +106,11 @@ SICALLBACK XSILoadPlugin(PluginRegistrar& in_reg)
     in_reg.RegisterEvent(L"FabricSpliceBeginExport",    siOnBeginFileExport);
     in_reg.RegisterEvent(L"FabricSpliceEndExport",      siOnEndFileExport);
     in_reg.RegisterEvent(L"FabricSpliceValueChange",    siOnValueChange);
+    in_reg.RegisterTimerEvent(L"FabricSpliceTimer",     250, 0);
 
     // ice nodes.
     Register_spliceGetData(in_reg);
+    Register_spliceSetData(in_reg);
   }
 
   // array of custom command names.
@@ -129,6 +132,9 @@ SICALLBACK XSILoadPlugin(PluginRegistrar& in_reg)
     cmdName = L"FabricCanvasSelectConnected";   in_reg.RegisterCommand(cmdName, cmdName);   ccnames.Add(cmdName);
     cmdName = L"FabricCanvasLogStatus";         in_reg.RegisterCommand(cmdName, cmdName);   ccnames.Add(cmdName);
 
+    // ice nodes.
+    Register_FabricCanvasGetPerNodeData(in_reg);
+
     // commands for DFGUICmdHandler.
     REGISTER_DFGUICMD( in_reg, AddBackDrop );
     REGISTER_DFGUICMD( in_reg, AddFunc );